@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashArrayBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures Splash_array against Splash_list. Appends, reads by position
+   and clears are timed for growing sizes, reads by position walk the
+   list so they grow with the square of the size there.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void run(int32_t count) {
+	Uint64 start;
+	intptr_t sum = 0;
+	int32_t i;
+
+	Splash_list *list = splash_list_create();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_list_add(list, (void *)(intptr_t)i);
+	}
+	double list_add_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum += (intptr_t)splash_list_get(list, i);
+	}
+	double list_get_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	splash_list_remove_all(list);
+	double list_clear_time = benchmark_nanoseconds(start, count);
+	splash_list_destroy(list);
+
+	Splash_array *array = splash_array_create();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_array_push(array, (void *)(intptr_t)i);
+	}
+	double array_add_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum -= (intptr_t)splash_array_get(array, i);
+	}
+	double array_get_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	splash_array_remove_all(array);
+	double array_clear_time = benchmark_nanoseconds(start, count);
+	splash_array_destroy(array);
+
+	printf("%8d items  list   add %7.1f  get %10.1f  clear %6.1f ns%s\n", count,
+		list_add_time, list_get_time, list_clear_time, sum ? "  MISMATCH" : "");
+	printf("%8s        array  add %7.1f  get %10.1f  clear %6.1f ns\n", "",
+		array_add_time, array_get_time, array_clear_time);
+}
+
+
+int main(int argc, char *argv[]) {
+	benchmark_sweep(100, benchmark_most(argc, argv, 100000), run);
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashContainerBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures updating structs kept by value in a SPLASH_ARRAY against the
+   same structs allocated one by one and kept as pointers in a
+   Splash_array, and looking them up in a SPLASH_MAP against a
+   Splash_hashmap of pointers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct Particle {
+	float x;
+	float y;
+	float dx;
+	float dy;
+} Particle;
+
+SPLASH_ARRAY(Particles, Particle)
+SPLASH_MAP(Particle_map, uint64_t, Particle, splash_container_hash_int, splash_container_equal_int)
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void run(int32_t count) {
+	Particle particle = {0, 0, 1, 2};
+	Particles particles;
+	Particle_map map;
+	Uint64 start;
+	double sum = 0;
+	int32_t pass;
+	int32_t i;
+
+	Particles_init(&particles);
+	Particle_map_init(&map);
+	Splash_array *pointers = splash_array_create();
+	Splash_hashmap *hashmap = splash_hashmap_create_int();
+	for (i = 0; i < count; i++) {
+		Particle *allocated = malloc(sizeof(Particle));
+		*allocated = particle;
+		splash_array_push(pointers, allocated);
+		splash_hashmap_add(hashmap, SPLASH_HASHMAP_INT(i), allocated);
+		/* interleaved allocations spread the single particles out like a running game */
+		free(malloc(48));
+		Particles_push(&particles, particle);
+		Particle_map_put(&map, (uint64_t)i, particle);
+	}
+
+	start = SDL_GetPerformanceCounter();
+	for (pass = 0; pass < 10; pass++) {
+		for (i = 0; i < count; i++) {
+			Particle *current = pointers->data[i];
+			current->x += current->dx;
+			current->y += current->dy;
+		}
+	}
+	double pointer_time = benchmark_nanoseconds(start, count * 10);
+
+	start = SDL_GetPerformanceCounter();
+	for (pass = 0; pass < 10; pass++) {
+		for (i = 0; i < count; i++) {
+			Particle *current = &particles.data[i];
+			current->x += current->dx;
+			current->y += current->dy;
+		}
+	}
+	double inline_time = benchmark_nanoseconds(start, count * 10);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum += ((Particle *)splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(i)))->dx;
+	}
+	double hashmap_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum -= Particle_map_get(&map, (uint64_t)i)->dx;
+	}
+	double map_time = benchmark_nanoseconds(start, count);
+
+	for (i = 0; i < count; i++) {
+		free(pointers->data[i]);
+	}
+	splash_array_destroy(pointers);
+	splash_hashmap_destory(hashmap);
+	Particles_free(&particles);
+	Particle_map_free(&map);
+
+	printf("%9d structs  update pointers %6.2f  inline %6.2f ns  lookup hashmap %6.1f  map %6.1f ns%s\n", count,
+		pointer_time, inline_time, hashmap_time, map_time, sum != 0 ? "  MISMATCH" : "");
+}
+
+
+int main(int argc, char *argv[]) {
+	benchmark_sweep(1000, benchmark_most(argc, argv, 1000000), run);
+  return 0;
+}
@@ -0,0 +1,310 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashHashmapBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures the open addressed Splash_hashmap against the chained hashmap
+   it replaced, kept here as the baseline. Inserts, hits, misses and
+   removes are timed from 1k to 10M keys. The slowest single insert is
+   then compared with and without incremental rehashing.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEY_LENGTH 16
+
+typedef struct chained_element {
+  void *key;
+  void *value;
+  struct chained_element *next;
+} chained_element;
+
+typedef struct chained_hashmap {
+  int32_t size;
+  int32_t count;
+  chained_element **buckets;
+} chained_hashmap;
+
+static char *keys;        /**< shuffled keys, KEY_LENGTH apart */
+static char *misses;      /**< shuffled keys never added */
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static int chained_hash(void *key, int size) {
+	char *p = key;
+	int len = strlen(p);
+	int hash = 0;
+	int g;
+	int i;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash << 4) + p[i];
+		g = hash & 0xf0000000L;
+		if (g != 0) {
+			hash ^= g >> 24;
+		}
+		hash &= ~g;
+	}
+	return hash % size;
+}
+
+
+static chained_hashmap *chained_create() {
+	chained_hashmap *hashmap = malloc(sizeof(chained_hashmap));
+	hashmap->buckets = calloc(256, sizeof(chained_element *));
+	hashmap->size = 256;
+	hashmap->count = 0;
+	return hashmap;
+}
+
+
+static void chained_rehash(chained_hashmap *hashmap) {
+	int32_t size = hashmap->size << 1;
+	chained_element **buckets = calloc(size, sizeof(chained_element *));
+	chained_element *item;
+	chained_element *next;
+	int i;
+
+	for (i = 0; i < hashmap->size; i++) {
+		for (item = hashmap->buckets[i]; item != NULL; item = next) {
+			int index = chained_hash(item->key, size);
+			next = item->next;
+			item->next = buckets[index];
+			buckets[index] = item;
+		}
+	}
+
+	free(hashmap->buckets);
+	hashmap->buckets = buckets;
+	hashmap->size = size;
+}
+
+
+static void chained_add(chained_hashmap *hashmap, void *key, void *value) {
+	chained_element **p = &hashmap->buckets[chained_hash(key, hashmap->size)];
+	chained_element *item;
+
+	for (item = *p; item != NULL; item = item->next) {
+		if (strcmp(item->key, key) == 0) {
+			item->value = value;
+			return;
+		}
+	}
+
+	item = malloc(sizeof(chained_element));
+	item->key = key;
+	item->value = value;
+	item->next = *p;
+	*p = item;
+
+	if (++hashmap->count >= hashmap->size * 3 / 4) {
+		chained_rehash(hashmap);
+	}
+}
+
+
+static void *chained_get(chained_hashmap *hashmap, void *key) {
+	chained_element *item;
+
+	for (item = hashmap->buckets[chained_hash(key, hashmap->size)]; item != NULL; item = item->next) {
+		if (strcmp(item->key, key) == 0) {
+			return item->value;
+		}
+	}
+	return (void *)-1;
+}
+
+
+static void chained_remove(chained_hashmap *hashmap, void *key) {
+	chained_element **p = &hashmap->buckets[chained_hash(key, hashmap->size)];
+
+	for (; *p != NULL; p = &(*p)->next) {
+		if (strcmp((*p)->key, key) == 0) {
+			chained_element *item = *p;
+			*p = item->next;
+			free(item);
+			hashmap->count--;
+			return;
+		}
+	}
+}
+
+
+static void chained_destroy(chained_hashmap *hashmap) {
+	chained_element *item;
+	chained_element *next;
+	int i;
+
+	for (i = 0; i < hashmap->size; i++) {
+		for (item = hashmap->buckets[i]; item != NULL; item = next) {
+			next = item->next;
+			free(item);
+		}
+	}
+	free(hashmap->buckets);
+	free(hashmap);
+}
+
+
+static void run(int32_t count) {
+	Uint64 start;
+	int32_t i;
+	int32_t found = 0;
+
+	chained_hashmap *chained = chained_create();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		chained_add(chained, keys + i * KEY_LENGTH, keys);
+	}
+	double chained_add_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		found += chained_get(chained, keys + i * KEY_LENGTH) == keys;
+	}
+	double chained_hit_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		found += chained_get(chained, misses + i * KEY_LENGTH) == keys;
+	}
+	double chained_miss_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		chained_remove(chained, keys + i * KEY_LENGTH);
+	}
+	double chained_remove_time = benchmark_nanoseconds(start, count);
+	chained_destroy(chained);
+
+	Splash_hashmap *hashmap = splash_hashmap_create();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_hashmap_add(hashmap, keys + i * KEY_LENGTH, keys);
+	}
+	double add_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		found -= splash_hashmap_get(hashmap, keys + i * KEY_LENGTH) == keys;
+	}
+	double hit_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		found -= splash_hashmap_get(hashmap, misses + i * KEY_LENGTH) == keys;
+	}
+	double miss_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_hashmap_remove(hashmap, keys + i * KEY_LENGTH);
+	}
+	double remove_time = benchmark_nanoseconds(start, count);
+	splash_hashmap_destory(hashmap);
+
+	printf("%9d keys  chained  add %7.1f  hit %7.1f  miss %7.1f  remove %7.1f ns%s\n", count,
+		chained_add_time, chained_hit_time, chained_miss_time, chained_remove_time, found ? "  MISMATCH" : "");
+	printf("%9s       open     add %7.1f  hit %7.1f  miss %7.1f  remove %7.1f ns\n", "",
+		add_time, hit_time, miss_time, remove_time);
+}
+
+
+static void run_growth(int32_t count, int32_t step) {
+	Splash_hashmap *hashmap = splash_hashmap_create();
+	double worst = 0;
+	double total = 0;
+	int32_t i;
+
+	splash_hashmap_set_incremental(hashmap, step);
+	for (i = 0; i < count; i++) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		splash_hashmap_add(hashmap, keys + i * KEY_LENGTH, keys);
+		double time = benchmark_nanoseconds(start, 1);
+		total += time;
+		if (time > worst) {
+			worst = time;
+		}
+	}
+	splash_hashmap_destory(hashmap);
+
+	printf("%9d keys  step %2d  mean add %7.1f ns  worst add %10.1f ns\n", count, step, total / count, worst);
+}
+
+
+static void run_typed(int32_t count) {
+	Splash_hashmap *parsed = splash_hashmap_create();
+	Splash_hashmap *typed = splash_hashmap_create();
+	int64_t sum = 0;
+	Uint64 start;
+	int32_t i;
+
+	for (i = 0; i < count; i++) {
+		splash_hashmap_add(parsed, keys + i * KEY_LENGTH, "12345");
+		splash_hashmap_set_int(typed, keys + i * KEY_LENGTH, 12345);
+	}
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum += splash_hashmap_get_int(parsed, keys + i * KEY_LENGTH);
+	}
+	double parsed_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum -= splash_hashmap_get_int64(typed, keys + i * KEY_LENGTH);
+	}
+	double typed_time = benchmark_nanoseconds(start, count);
+
+	splash_hashmap_destory(parsed);
+	splash_hashmap_destory(typed);
+
+	printf("%9d keys  int read  parsed %7.1f  typed %7.1f ns%s\n", count, parsed_time, typed_time, sum ? "  MISMATCH" : "");
+}
+
+
+int main(int argc, char *argv[]) {
+	int32_t most = benchmark_most(argc, argv, 10000000);
+	int32_t i;
+
+	keys = malloc((size_t)most * KEY_LENGTH);
+	misses = malloc((size_t)most * KEY_LENGTH);
+
+	if (keys == NULL || misses == NULL) {
+		printf("Could not allocate %d keys\n", most);
+		return 1;
+	}
+
+	/* keys in a random order so neither hash gains from sequential names */
+	uint64_t seed = 1;
+	for (i = 0; i < most; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		int32_t j = (seed >> 33) % (i + 1);
+		memcpy(keys + i * KEY_LENGTH, keys + j * KEY_LENGTH, KEY_LENGTH);
+		memcpy(misses + i * KEY_LENGTH, misses + j * KEY_LENGTH, KEY_LENGTH);
+		snprintf(keys + j * KEY_LENGTH, KEY_LENGTH, "key%d", i);
+		snprintf(misses + j * KEY_LENGTH, KEY_LENGTH, "miss%d", i);
+	}
+
+	benchmark_sweep(1000, most, run);
+	run_growth(most, 0);
+	run_growth(most, 8);
+	run_typed(most < 1000000 ? most : 1000000);
+
+	free(keys);
+	free(misses);
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaBackendBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures a script heavy state update on the lua backend Splash was
+   built with. Build once as is and once with SPLASH_LUAJIT to compare the
+   bundled Lua 5.2 against LuaJIT, the LuaJIT build also runs the same
+   state through the generated ffi bindings. Run from bin so require finds
+   splash_ffi.lua.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "../src/wrapper/lua_wrapper/l_splash_object.h"
+#include "../src/wrapper/lua_wrapper/game/l_splash_state.h"
+#include <stdio.h>
+
+#define CALLS 10000
+#define OPERATIONS 100
+
+#ifdef SPLASH_LUAJIT
+#define BACKEND "LuaJIT"
+#else
+#define BACKEND LUA_VERSION
+#endif
+
+static const char *script =
+	"local backend, count = ...\n"
+	"local api = splash_camera\n"
+	"if backend == 'ffi' then api = require('splash_ffi').camera end\n"
+	"local camera = splash_camera.orthoCreate()\n"
+	"local function init(state, data) end\n"
+	"local function update(delta)\n"
+	"  for i = 1, count do\n"
+	"    api.translate(camera, delta, 0, 0)\n"
+	"    api.rotate(camera, 0, 0, delta)\n"
+	"    local x, y, z = api.getPosition(camera)\n"
+	"    api.setZoom(camera, api.getZoom(camera) + x * 0)\n"
+	"  end\n"
+	"end\n"
+	"local function events(e) end\n"
+	"local function render() end\n"
+	"local function cleanup(state) end\n"
+	"local state = splash_state.create('Bench ' .. backend, init, update, events, render, cleanup)\n"
+	"splash_state.add(state)\n"
+	"return state\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static int run(const char *backend) {
+	int i;
+
+	if (luaL_loadstring(splash_lua_state, script)) {
+		printf("Could not load script: %s\n", lua_tostring(splash_lua_state, -1));
+		return -1;
+	}
+	lua_pushstring(splash_lua_state, backend);
+	lua_pushinteger(splash_lua_state, OPERATIONS);
+	if (lua_pcall(splash_lua_state, 2, 1, 0)) {
+		printf("Could not run script: %s\n", lua_tostring(splash_lua_state, -1));
+		lua_pop(splash_lua_state, 1);
+		return -1;
+	}
+	Splash_state *state = l_splash_object_check(splash_lua_state, -1, L_SPLASH_STATE_TYPE, "state");
+	lua_pop(splash_lua_state, 1);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CALLS; i++) {
+		l_splash_state_call_update(state, 1);
+	}
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+	printf("%-10s %-6s %8.1f ns/operation\n", BACKEND, backend, seconds * 1e9 / CALLS / OPERATIONS);
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_state_init();
+	splash_lua_state = luaL_newstate();
+	luaL_openlibs(splash_lua_state);
+	splash_lua_register_all(splash_lua_state);
+
+	int failed = run("c");
+#ifdef SPLASH_LUAJIT
+	failed |= run("ffi");
+#endif
+
+	splash_state_quit();
+	lua_close(splash_lua_state);
+  return failed ? 1 : 0;
+}
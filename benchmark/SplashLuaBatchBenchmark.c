@@ -0,0 +1,74 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaBatchBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures moving a particle style set of objects from lua, one C call
+   per object against plain lua loops and a single batch call over flat
+   arrays and over buffers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <stdio.h>
+
+#define OBJECTS 10000
+#define FRAMES 200
+
+static const char *script =
+	"local n, frames = ...\n"
+	"local clock = os.clock\n"
+	"local function run(name, f)\n"
+	"  local start = clock()\n"
+	"  for frame = 1, frames do f() end\n"
+	"  print(string.format('%-28s %8.1f ns/object', name, (clock() - start) * 1e9 / (n * frames)))\n"
+	"end\n"
+	"local cameras = {}\n"
+	"local positions, velocities = {}, {}\n"
+	"for i = 1, n do\n"
+	"  cameras[i] = splash_camera.orthoCreate()\n"
+	"  positions[i * 2 - 1], positions[i * 2] = i, -i\n"
+	"  velocities[i * 2 - 1], velocities[i * 2] = i % 7, i % 5\n"
+	"end\n"
+	"local translate = splash_camera.translate\n"
+	"run('C call per object', function()\n"
+	"  for i = 1, n do translate(cameras[i], velocities[i * 2 - 1] * 0.016, velocities[i * 2] * 0.016, 0) end\n"
+	"end)\n"
+	"run('lua loop', function()\n"
+	"  for i = 1, n * 2 do positions[i] = positions[i] + velocities[i] * 0.016 end\n"
+	"end)\n"
+	"local integrate = splash_batch.integrate\n"
+	"run('batch, flat arrays', function() integrate(positions, velocities, 0.016) end)\n"
+	"local position_buffer = splash_batch.buffer(positions)\n"
+	"local velocity_buffer = splash_batch.buffer(velocities)\n"
+	"run('batch, buffers', function() integrate(position_buffer, velocity_buffer, 0.016) end)\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[]) {
+	lua_State *l = luaL_newstate();
+	luaL_openlibs(l);
+	splash_lua_register_worker(l);
+
+	if (luaL_loadstring(l, script)) {
+		printf("Could not load script: %s\n", lua_tostring(l, -1));
+		return 1;
+	}
+	lua_pushinteger(l, OBJECTS);
+	lua_pushinteger(l, FRAMES);
+	if (lua_pcall(l, 2, 0, 0)) {
+		printf("Could not run script: %s\n", lua_tostring(l, -1));
+		return 1;
+	}
+
+	lua_close(l);
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaCacheBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures loading the test scripts from source against loading them
+   through the script cache. The first cached pass compiles and stores
+   the chunks unless lua_cache already holds them from an earlier run.
+   Run from bin so the scripts are found.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <stdio.h>
+
+#define PASSES 1000
+
+static const char *scripts[] = {
+	"../scripts/test/camera_test.lua",
+	"../scripts/test/renderer_test.lua",
+	"../scripts/test/state_test.lua",
+	"../scripts/test/task_test.lua",
+	"../scripts/test/window_test.lua",
+};
+
+#define SCRIPTS (sizeof(scripts) / sizeof(scripts[0]))
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static int load_all() {
+	unsigned int i;
+
+	for (i = 0; i < SCRIPTS; i++) {
+		if (splash_lua_load(splash_lua_state, scripts[i]) != 0) {
+			printf("Could not load script: %s\n", lua_tostring(splash_lua_state, -1));
+			lua_pop(splash_lua_state, 1);
+			return -1;
+		}
+		lua_pop(splash_lua_state, 1);
+	}
+  return 0;
+}
+
+static int run(const char *name, int passes) {
+	int i;
+	int failed = 0;
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (i = 0; i < passes && !failed; i++) {
+		failed = load_all();
+	}
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+	printf("%-12s %10.1f us/startup\n", name, seconds * 1e6 / passes);
+  return failed;
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_lua_state = luaL_newstate();
+	luaL_openlibs(splash_lua_state);
+
+	int failed = run("source", PASSES);
+
+	failed |= splash_lua_set_cache("lua_cache", 0);
+	failed |= run("first pass", 1);
+	failed |= run("cached", PASSES);
+
+	splash_lua_set_cache(NULL, 0);
+	lua_close(splash_lua_state);
+  return failed ? 1 : 0;
+}
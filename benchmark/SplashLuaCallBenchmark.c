@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaCallBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures the cost of calling a lua state callback from C, the registry
+   lookup the state machine used to do against the pinned dispatch.
+	
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "../src/wrapper/lua_wrapper/l_splash_object.h"
+#include "../src/wrapper/lua_wrapper/game/l_splash_state.h"
+#include <stdio.h>
+
+#define CALLS 1000000
+
+static const char *script =
+	"local n = 0\n"
+	"local function init(state, data) end\n"
+	"local function update(delta) n = n + 1 end\n"
+	"local function events(e) end\n"
+	"local function render() end\n"
+	"local function cleanup(state) end\n"
+	"local state = splash_state.create('Bench', init, update, events, render, cleanup)\n"
+	"splash_state.add(state)\n"
+	"return state\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void report(const char *name, Uint64 start) {
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+	printf("%-28s %8.1f ns/call\n", name, seconds * 1e9 / CALLS);
+}
+
+
+int main(int argc, char *argv[]) {
+	int i;
+	Uint64 start;
+
+	splash_state_init();
+	splash_lua_state = luaL_newstate();
+	luaL_openlibs(splash_lua_state);
+	splash_lua_register_all(splash_lua_state);
+
+	if (luaL_dostring(splash_lua_state, script)) {
+		printf("Could not load script: %s\n", lua_tostring(splash_lua_state, -1));
+		return 1;
+	}
+	Splash_state *state = l_splash_object_check(splash_lua_state, -1, L_SPLASH_STATE_TYPE, "state");
+	lua_pop(splash_lua_state, 1);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CALLS; i++) {
+		lua_rawgeti(splash_lua_state, LUA_REGISTRYINDEX, state->l_update);
+		lua_pushnumber(splash_lua_state, 1);
+		lua_pcall(splash_lua_state, 1, 0, 0);
+	}
+	report("registry, no handler", start);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CALLS; i++) {
+		lua_rawgeti(splash_lua_state, LUA_REGISTRYINDEX, state->l_update);
+		lua_pushnumber(splash_lua_state, 1);
+		splash_lua_call(splash_lua_state, 1, 0);
+	}
+	report("registry, traceback", start);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CALLS; i++) {
+		l_splash_state_call_update(state, 1);
+	}
+	report("pinned update", start);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CALLS; i++) {
+		l_splash_state_call_render(state);
+	}
+	report("pinned render", start);
+
+	splash_state_quit();
+	lua_close(splash_lua_state);
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaGcBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures how steady a garbage heavy lua update is on the default
+   allocator, the pooled allocator and the pooled allocator with the
+   collection moved into the time left after each frame. Only the update
+   is timed, the budgeted collection runs in time the frame would have
+   spent waiting for the next tick.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <math.h>
+#include <stdio.h>
+
+#define FRAMES 5000
+#define FRAME_TIME (1000.0 / 60)
+#define BUDGET 2.0
+
+static const char *script =
+	"local live = {}\n"
+	"return function()\n"
+	"  for i = 1, 500 do\n"
+	"    live[i % 100 + 1] = {x = i, y = i * 2, name = 'entity' .. i}\n"
+	"  end\n"
+	"end\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static double milliseconds(Uint64 start) {
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static int run(const char *name, lua_State *l, double budget) {
+	double total = 0;
+	double squares = 0;
+	double worst = 0;
+	int i;
+
+	luaL_openlibs(l);
+	if (luaL_dostring(l, script)) {
+		printf("Could not load script: %s\n", lua_tostring(l, -1));
+		splash_lua_close(l);
+		return -1;
+	}
+	int update = luaL_ref(l, LUA_REGISTRYINDEX);
+	if (budget > 0) {
+		splash_lua_set_gc_budget(l, budget);
+	}
+
+	for (i = 0; i < FRAMES; i++) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		lua_rawgeti(l, LUA_REGISTRYINDEX, update);
+		lua_call(l, 0, 0);
+		double frame = milliseconds(start);
+
+		splash_lua_end_frame(l, FRAME_TIME - frame);
+
+		total += frame;
+		squares += frame * frame;
+		if (frame > worst) {
+			worst = frame;
+		}
+	}
+
+	double mean = total / FRAMES;
+	printf("%-14s mean %7.3f ms  max %7.3f ms  stddev %7.3f ms\n", name, mean, worst, sqrt(squares / FRAMES - mean * mean));
+	splash_lua_close(l);
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+	int failed = run("default", luaL_newstate(), 0);
+	failed |= run("pool", splash_lua_newstate(), 0);
+	failed |= run("pool, budget", splash_lua_newstate(), BUDGET);
+  return failed ? 1 : 0;
+}
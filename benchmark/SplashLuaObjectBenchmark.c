@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaObjectBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures the cost of calling a Splash object from lua, the flat module
+   functions against method calls through the object metatable, with an
+   unchecked light userdata call as the baseline.
+	
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "../src/wrapper/lua_wrapper/l_splash_object.h"
+#include "../src/wrapper/lua_wrapper/graphics/l_splash_camera.h"
+#include <stdio.h>
+
+#define CALLS 1000000
+
+static const char *script =
+	"local n = ...\n"
+	"local camera = splash_camera.orthoCreate()\n"
+	"local light = bench_light(camera)\n"
+	"local get_zoom = splash_camera.getZoom\n"
+	"local raw_zoom = bench_raw_zoom\n"
+	"local clock = os.clock\n"
+	"local function run(name, f)\n"
+	"  local start = clock()\n"
+	"  f()\n"
+	"  print(string.format('%-28s %8.1f ns/call', name, (clock() - start) * 1e9 / n))\n"
+	"end\n"
+	"run('light userdata, unchecked', function() for i = 1, n do raw_zoom(light) end end)\n"
+	"run('flat splash_camera.getZoom', function() for i = 1, n do splash_camera.getZoom(camera) end end)\n"
+	"run('flat, local function', function() for i = 1, n do get_zoom(camera) end end)\n"
+	"run('method camera:getZoom', function() for i = 1, n do camera:getZoom() end end)\n"
+	"run('create and collect', function() for i = 1, n do splash_camera.orthoCreate() end end)\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static int bench_light(lua_State *l) {
+	lua_pushlightuserdata(l, l_splash_object_check(l, 1, L_SPLASH_CAMERA_TYPE, "camera"));
+ return 1;
+}
+
+
+static int bench_raw_zoom(lua_State *l) {
+	Splash_camera *camera = lua_touserdata(l, 1);
+	lua_pushnumber(l, splash_camera_get_zoom(camera));
+ return 1;
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_lua_state = luaL_newstate();
+	luaL_openlibs(splash_lua_state);
+	splash_lua_register_all(splash_lua_state);
+	lua_register(splash_lua_state, "bench_light", bench_light);
+	lua_register(splash_lua_state, "bench_raw_zoom", bench_raw_zoom);
+
+	if (luaL_loadstring(splash_lua_state, script)) {
+		printf("Could not load script: %s\n", lua_tostring(splash_lua_state, -1));
+		return 1;
+	}
+	lua_pushinteger(splash_lua_state, CALLS);
+	if (lua_pcall(splash_lua_state, 1, 0, 0)) {
+		printf("Could not run script: %s\n", lua_tostring(splash_lua_state, -1));
+		return 1;
+	}
+
+	lua_close(splash_lua_state);
+  return 0;
+}
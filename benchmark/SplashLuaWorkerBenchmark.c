@@ -0,0 +1,99 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaWorkerBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures a batch of independent script jobs run on the main lua state
+   against the same jobs spread over lua workers. Run from bin so the job
+   script is found.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <stdio.h>
+
+#define JOBS 64
+#define WORK 1000000
+#define MAX_WORKERS 8
+
+static char *job_path = "../scripts/test/worker_job.lua";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void report(const char *name, int workers, Uint64 start) {
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+	printf("%-8s %2d %10.1f ms\n", name, workers, seconds * 1000);
+}
+
+static int run_main(lua_State *l) {
+	int i;
+
+	if (splash_lua_load(l, job_path) != 0 || splash_lua_call(l, 0, 1) != 0) {
+		return -1;
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (i = 0; i < JOBS; i++) {
+		lua_pushvalue(l, -1);
+		lua_pushstring(l, "sum");
+		lua_pushinteger(l, WORK);
+		lua_call(l, 2, 1);
+		lua_pop(l, 1);
+	}
+	report("main", 0, start);
+
+	lua_pop(l, 1);
+  return 0;
+}
+
+static int run_workers(lua_State *l, int count) {
+	Splash_lua_worker *workers[MAX_WORKERS];
+	int i;
+
+	for (i = 0; i < count; i++) {
+		workers[i] = splash_lua_worker_create(job_path);
+		if (workers[i] == NULL) {
+			return -1;
+		}
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (i = 0; i < JOBS; i++) {
+		lua_pushstring(l, "sum");
+		lua_pushinteger(l, WORK);
+		splash_lua_worker_post(workers[i % count], l, 2);
+	}
+	for (i = 0; i < JOBS; i++) {
+		lua_pop(l, splash_lua_worker_result(workers[i % count], l, 1));
+	}
+	report("workers", count, start);
+
+	for (i = 0; i < count; i++) {
+		splash_lua_worker_destroy(workers[i]);
+	}
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+	int count;
+
+	splash_lua_state = splash_lua_newstate();
+	luaL_openlibs(splash_lua_state);
+
+	int failed = run_main(splash_lua_state);
+	for (count = 1; count <= MAX_WORKERS && !failed; count *= 2) {
+		failed = run_workers(splash_lua_state, count);
+	}
+
+	splash_lua_close(splash_lua_state);
+  return failed ? 1 : 0;
+}
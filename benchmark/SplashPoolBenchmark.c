@@ -0,0 +1,143 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashPoolBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures Splash_pool against malloc under churn. A live set of blocks
+   is kept while random blocks are freed and taken again, for a private
+   pool and a shared pool with and without thread caches. A linked list
+   built after the churn is then walked to compare node locality.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BLOCK_SIZE 16
+#define CHURN 10000000
+
+typedef struct node {
+	struct node *next;
+	intptr_t value;
+} node;
+
+static uint64_t seed = 1;
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static int32_t next_random(int32_t range) {
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (int32_t)((seed >> 33) % range);
+}
+
+
+static void *take(Splash_pool *pool) {
+	return pool ? splash_pool_alloc(pool) : malloc(BLOCK_SIZE);
+}
+
+
+static void give(Splash_pool *pool, void *block) {
+	if (pool) {
+		splash_pool_free(pool, block);
+	} else {
+		free(block);
+	}
+}
+
+
+static double walk(node *head, int32_t count) {
+	intptr_t sum = 0;
+	int32_t pass;
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	for (pass = 0; pass < 10; pass++) {
+		node *current;
+		for (current = head; current != NULL; current = current->next) {
+			sum += current->value;
+		}
+	}
+	double time = benchmark_nanoseconds(start, count * 10);
+	if (sum == 42) {
+		printf("unlikely\n");
+	}
+ return time;
+}
+
+
+static void run_pool(const char *name, Splash_pool *pool, int32_t live) {
+	void **blocks = malloc((size_t)live * sizeof(void *));
+	node *head = NULL;
+	Uint64 start;
+	int32_t i;
+
+	seed = 1;
+	for (i = 0; i < live; i++) {
+		blocks[i] = take(pool);
+	}
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < CHURN; i++) {
+		int32_t index = next_random(live);
+		give(pool, blocks[index]);
+		blocks[index] = take(pool);
+	}
+	double churn_time = benchmark_nanoseconds(start, CHURN);
+
+	/* half the live set is swapped for list nodes, taking the freed holes */
+	for (i = 0; i < live; i += 2) {
+		give(pool, blocks[i]);
+	}
+	for (i = 0; i < live; i += 2) {
+		node *current = take(pool);
+		current->value = i;
+		current->next = head;
+		head = current;
+	}
+	double walk_time = walk(head, live / 2);
+
+	while (head != NULL) {
+		node *current = head;
+		head = head->next;
+		give(pool, current);
+	}
+	for (i = 1; i < live; i += 2) {
+		give(pool, blocks[i]);
+	}
+	free(blocks);
+
+	printf("%9d live  %-16s churn %6.1f ns  walk %6.2f ns\n", live, name, churn_time, walk_time);
+}
+
+
+static void run(int32_t live) {
+	Splash_pool *pool = splash_pool_create(BLOCK_SIZE, 0);
+	Splash_pool *shared = splash_pool_create_shared(BLOCK_SIZE, 0);
+	Splash_pool *cached = splash_pool_create_shared(BLOCK_SIZE, 0);
+	splash_pool_set_thread_cache(cached, 1);
+
+	run_pool("malloc", NULL, live);
+	run_pool("pool", pool, live);
+	run_pool("shared pool", shared, live);
+	run_pool("cached pool", cached, live);
+
+	splash_pool_flush_thread_cache();
+	splash_pool_destroy(pool);
+	splash_pool_destroy(shared);
+	splash_pool_destroy(cached);
+}
+
+
+int main(int argc, char *argv[]) {
+	benchmark_sweep(1000, benchmark_most(argc, argv, 1000000), run);
+  return 0;
+}
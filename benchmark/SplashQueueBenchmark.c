@@ -0,0 +1,211 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashQueueBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures the throughput of Splash_ring and Splash_queue against a
+   Splash_list guarded by a SDL_mutex. Items are passed from producers
+   to consumers one at a time and in batches, for growing thread counts.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+#define CAPACITY 1024
+#define BATCH 32
+
+typedef struct bench_thread {
+	Splash_ring *ring;
+	Splash_queue *queue;
+	Splash_list *list;
+	SDL_mutex *lock;
+	int32_t count;
+	int32_t batch;
+	int64_t sum;
+} bench_thread;
+
+
+static int ring_producer(void *data) {
+	bench_thread *thread = data;
+	void *items[BATCH];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		int32_t count = thread->count - i < thread->batch ? thread->count - i : thread->batch;
+		for (j = 0; j < count; j++) {
+			items[j] = (void *)(intptr_t)(i + j + 1);
+		}
+		int32_t pushed = splash_ring_push_batch(thread->ring, items, count);
+		if (pushed == 0) {
+			pushed = splash_ring_push_wait(thread->ring, items[0], SPLASH_QUEUE_WAIT_FOREVER) == 0;
+		}
+		i += pushed;
+	}
+	return 0;
+}
+
+
+static int ring_consumer(void *data) {
+	bench_thread *thread = data;
+	void *items[BATCH];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		int32_t count = splash_ring_pop_batch(thread->ring, items, thread->batch);
+		if (count == 0) {
+			count = splash_ring_pop_wait(thread->ring, items, SPLASH_QUEUE_WAIT_FOREVER) == 0;
+		}
+		for (j = 0; j < count; j++) {
+			thread->sum += (intptr_t)items[j];
+		}
+		i += count;
+	}
+	return 0;
+}
+
+
+static int queue_producer(void *data) {
+	bench_thread *thread = data;
+	void *items[BATCH];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		int32_t count = thread->count - i < thread->batch ? thread->count - i : thread->batch;
+		for (j = 0; j < count; j++) {
+			items[j] = (void *)(intptr_t)(i + j + 1);
+		}
+		int32_t pushed = splash_queue_push_batch(thread->queue, items, count);
+		if (pushed == 0) {
+			pushed = splash_queue_push_wait(thread->queue, items[0], SPLASH_QUEUE_WAIT_FOREVER) == 0;
+		}
+		i += pushed;
+	}
+	return 0;
+}
+
+
+static int queue_consumer(void *data) {
+	bench_thread *thread = data;
+	void *items[BATCH];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		int32_t count = splash_queue_pop_batch(thread->queue, items, thread->count - i < thread->batch ? thread->count - i : thread->batch);
+		if (count == 0) {
+			count = splash_queue_pop_wait(thread->queue, items, SPLASH_QUEUE_WAIT_FOREVER) == 0;
+		}
+		for (j = 0; j < count; j++) {
+			thread->sum += (intptr_t)items[j];
+		}
+		i += count;
+	}
+	return 0;
+}
+
+
+static int list_producer(void *data) {
+	bench_thread *thread = data;
+	int32_t i;
+
+	for (i = 0; i < thread->count; i++) {
+		SDL_LockMutex(thread->lock);
+		splash_list_add(thread->list, (void *)(intptr_t)(i + 1));
+		SDL_UnlockMutex(thread->lock);
+	}
+	return 0;
+}
+
+
+static int list_consumer(void *data) {
+	bench_thread *thread = data;
+	int32_t i = 0;
+
+	while (i < thread->count) {
+		SDL_LockMutex(thread->lock);
+		if (splash_list_get_size(thread->list) > 0) {
+			thread->sum += (intptr_t)splash_list_get(thread->list, 0);
+			splash_list_remove_position(thread->list, 0);
+			i++;
+		}
+		SDL_UnlockMutex(thread->lock);
+	}
+	return 0;
+}
+
+
+static double run(SDL_ThreadFunction producer, SDL_ThreadFunction consumer, bench_thread *setup, int32_t pairs, int32_t count) {
+	bench_thread *threads = malloc(pairs * 2 * sizeof(bench_thread));
+	SDL_Thread **handles = malloc(pairs * 2 * sizeof(SDL_Thread *));
+	int64_t expected = (int64_t)count * (count + 1) / 2 * pairs;
+	int64_t sum = 0;
+	int32_t i;
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (i = 0; i < pairs * 2; i++) {
+		threads[i] = *setup;
+		threads[i].count = count;
+		handles[i] = SDL_CreateThread(i < pairs ? producer : consumer, "bench", &threads[i]);
+	}
+	for (i = 0; i < pairs * 2; i++) {
+		SDL_WaitThread(handles[i], NULL);
+		sum += i < pairs ? 0 : threads[i].sum;
+	}
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+	if (sum != expected) {
+		printf("  MISMATCH");
+	}
+	free(threads);
+	free(handles);
+ return (double)count * pairs / seconds / 1e6;
+}
+
+
+int main(int argc, char *argv[]) {
+	int32_t count = argc > 1 ? atoi(argv[1]) : 1000000;
+	int32_t most = argc > 2 ? atoi(argv[2]) : SDL_GetCPUCount();
+	bench_thread setup = {NULL};
+	int32_t pairs;
+
+	setup.ring = splash_ring_create(CAPACITY);
+	setup.batch = 1;
+	printf("ring   1 to 1  single %7.2f M/s\n", run(ring_producer, ring_consumer, &setup, 1, count));
+	setup.batch = BATCH;
+	printf("ring   1 to 1  batch  %7.2f M/s\n", run(ring_producer, ring_consumer, &setup, 1, count));
+	splash_ring_destroy(setup.ring);
+	setup.ring = NULL;
+
+	for (pairs = 1; pairs <= (most > 1 ? most / 2 : 1); pairs *= 2) {
+		setup.queue = splash_queue_create(CAPACITY);
+		setup.batch = 1;
+		printf("queue  %d to %d  single %7.2f M/s\n", pairs, pairs, run(queue_producer, queue_consumer, &setup, pairs, count / pairs));
+		setup.batch = BATCH;
+		printf("queue  %d to %d  batch  %7.2f M/s\n", pairs, pairs, run(queue_producer, queue_consumer, &setup, pairs, count / pairs));
+		splash_queue_destroy(setup.queue);
+		setup.queue = NULL;
+
+		setup.list = splash_list_create();
+		setup.lock = SDL_CreateMutex();
+		printf("list   %d to %d  mutex  %7.2f M/s\n", pairs, pairs, run(list_producer, list_consumer, &setup, pairs, count / pairs));
+		SDL_DestroyMutex(setup.lock);
+		splash_list_destroy(setup.list);
+		setup.list = NULL;
+	}
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashSetBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures membership checks of Splash_list, Splash_sparse_set and
+   Splash_bitset for growing numbers of ids, half of the checked ids are
+   members. The list scans so its checks grow with the size. Also times
+   and, or, andnot, count and a walk over the set bits of the bitset.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+#define LIST_MOST 10000   /**< largest size the list is measured at */
+
+static void run(int32_t count) {
+	int32_t checks = count * 2;
+	int32_t found = 0;
+	Uint64 start;
+	int32_t i;
+
+	double list_time = 0;
+	if (count <= LIST_MOST) {
+		Splash_list *list = splash_list_create();
+		for (i = 0; i < count; i++) {
+			splash_list_add(list, (void *)(intptr_t)(i * 2));
+		}
+		start = SDL_GetPerformanceCounter();
+		for (i = 0; i < checks; i++) {
+			found += splash_list_contains(list, (void *)(intptr_t)i);
+		}
+		list_time = benchmark_nanoseconds(start, checks);
+		splash_list_remove_all(list);
+		splash_list_destroy(list);
+	}
+
+	Splash_sparse_set *set = splash_sparse_set_create();
+	for (i = 0; i < count; i++) {
+		splash_sparse_set_insert(set, i * 2);
+	}
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < checks; i++) {
+		found -= splash_sparse_set_contains(set, i);
+	}
+	double set_time = benchmark_nanoseconds(start, checks);
+	splash_sparse_set_destroy(set);
+
+	Splash_bitset *bitset = splash_bitset_create(checks);
+	Splash_bitset *other = splash_bitset_create(checks);
+	for (i = 0; i < count; i++) {
+		splash_bitset_set(bitset, i * 2);
+		splash_bitset_set(other, i * 3 % checks);
+	}
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < checks; i++) {
+		found += splash_bitset_test(bitset, i);
+	}
+	double bitset_time = benchmark_nanoseconds(start, checks);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < 100; i++) {
+		splash_bitset_or(bitset, other);
+		splash_bitset_and(bitset, other);
+		splash_bitset_andnot(bitset, other);
+	}
+	double operation_time = benchmark_nanoseconds(start, 300);
+
+	start = SDL_GetPerformanceCounter();
+	int32_t bits = splash_bitset_count(other);
+	double count_time = benchmark_nanoseconds(start, 1);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = splash_bitset_next(other, 0); i != -1; i = splash_bitset_next(other, i + 1)) {
+		bits--;
+	}
+	double walk_time = benchmark_nanoseconds(start, 1);
+	splash_bitset_destroy(bitset);
+	splash_bitset_destroy(other);
+
+	if (count > LIST_MOST) {
+		found += count;
+	}
+	printf("%8d ids  contains  list %9.1f  sparse set %5.1f  bitset %5.1f ns%s\n", count,
+		list_time, set_time, bitset_time, found != count || bits ? "  MISMATCH" : "");
+	printf("%8s       bitset    and/or/andnot %9.0f  count %7.0f  walk %8.0f ns\n", "",
+		operation_time, count_time, walk_time);
+}
+
+
+int main(int argc, char *argv[]) {
+	benchmark_sweep(100, benchmark_most(argc, argv, 1000000), run);
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashSlotmapBenchmark.c
+   @author  P. Batty
+   @brief   Benchmark
+
+   Measures Splash_slotmap against a pointer keyed Splash_hashmap.
+   Inserts, lookups by handle, a walk over every element and removes are
+   timed for growing sizes, the walk reads the packed elements in order.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include "splash_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void run(int32_t count) {
+	Splash_handle *handles = malloc(count * sizeof(Splash_handle));
+	int32_t *values = malloc(count * sizeof(int32_t));
+	Uint64 start;
+	int64_t sum = 0;
+	int32_t i;
+
+	Splash_hashmap *hashmap = splash_hashmap_create_pointer();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		values[i] = i;
+		splash_hashmap_add(hashmap, &values[i], &values[i]);
+	}
+	double hashmap_insert_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum += *(int32_t *)splash_hashmap_get(hashmap, &values[i]);
+	}
+	double hashmap_get_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_hashmap_remove(hashmap, &values[i]);
+	}
+	double hashmap_remove_time = benchmark_nanoseconds(start, count);
+	splash_hashmap_destory(hashmap);
+
+	Splash_slotmap *slotmap = splash_slotmap_create(sizeof(int32_t));
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		handles[i] = splash_slotmap_insert(slotmap, &i);
+	}
+	double slotmap_insert_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		sum -= *(int32_t *)splash_slotmap_get(slotmap, handles[i]);
+	}
+	double slotmap_get_time = benchmark_nanoseconds(start, count);
+
+	int32_t *data = splash_slotmap_get_data(slotmap);
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < splash_slotmap_get_size(slotmap); i++) {
+		sum += data[i];
+	}
+	double slotmap_walk_time = benchmark_nanoseconds(start, count);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count; i++) {
+		splash_slotmap_remove(slotmap, handles[i]);
+	}
+	double slotmap_remove_time = benchmark_nanoseconds(start, count);
+	splash_slotmap_destroy(slotmap);
+
+	sum -= (int64_t)count * (count - 1) / 2;
+	printf("%8d items  hashmap  insert %6.1f  get %6.1f  remove %6.1f ns%s\n", count,
+		hashmap_insert_time, hashmap_get_time, hashmap_remove_time, sum ? "  MISMATCH" : "");
+	printf("%8s        slotmap  insert %6.1f  get %6.1f  remove %6.1f  walk %4.1f ns\n", "",
+		slotmap_insert_time, slotmap_get_time, slotmap_remove_time, slotmap_walk_time);
+	free(handles);
+	free(values);
+}
+
+
+int main(int argc, char *argv[]) {
+	benchmark_sweep(100, benchmark_most(argc, argv, 1000000), run);
+  return 0;
+}
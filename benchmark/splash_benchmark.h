@@ -0,0 +1,71 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_benchmark.h
+   @author  P. Batty
+   @brief   Benchmark helpers
+
+   The timer and the size sweep shared by the container benchmarks, each
+   benchmark supplies the run for one size.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_BENCHMARK_H_
+#define SPLASH_BENCHMARK_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the time per operation
+  @param    start   Performance counter when the operations began
+  @param    count   Number of operations timed
+  @return   Nanoseconds per operation
+
+\-----------------------------------------------------------------------------*/
+static double benchmark_nanoseconds(Uint64 start, int32_t count) {
+	return (double)(SDL_GetPerformanceCounter() - start) * 1e9 / SDL_GetPerformanceFrequency() / count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the largest size to measure
+  @param    argc    Argument count of main
+  @param    argv    Arguments of main
+  @param    most    Size used when none is given
+  @return   The first argument else most
+
+\-----------------------------------------------------------------------------*/
+static int32_t benchmark_most(int argc, char *argv[], int32_t most) {
+	return argc > 1 ? atoi(argv[1]) : most;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs a benchmark over growing sizes
+  @param    first   Smallest size
+  @param    most    Largest size
+  @param    run     Runs the benchmark for one size
+  @return   Void
+
+  Runs each power of ten from first up to most.
+
+\-----------------------------------------------------------------------------*/
+static void benchmark_sweep(int32_t first, int32_t most, void (*run)(int32_t count)) {
+	int32_t count;
+
+	for (count = first; count <= most; count *= 10) {
+		run(count);
+	}
+}
+
+#endif
@@ -21,16 +21,31 @@
 #include "SDL2/SDL_mixer.h"
 #include "SDL2/SDL_ttf.h"
 #include "Splash_window.h"
+#include "Splash_pool.h"
 #include "Splash_list.h"
+#include "Splash_array.h"
+#include "Splash_container.h"
+#include "Splash_slotmap.h"
+#include "Splash_handle.h"
+#include "Splash_queue.h"
+#include "Splash_sparse_set.h"
+#include "Splash_bitset.h"
 #include "Splash_hashmap.h"
 #include "Splash_state.h"
+#include "Splash_replay.h"
+#include "Splash_timer.h"
 #include "Splash_renderer.h"
 #include "Splash_vector.h"
+#include "Splash_batch.h"
 #include "Splash_camera.h"
 #include "Splash_texture.h"
 
                                 
 #include "Splash_lua_wrapper.h"
+#include "Splash_lua_memory.h"
+#include "Splash_lua_profiler.h"
+#include "Splash_lua_worker.h"
+#include "Splash_lua_reload.h"
 
 #include "splash_begin_code.h"
 /* Set up for C definitions */
@@ -0,0 +1,194 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_array.h
+   @author  P. Batty
+   @brief   The array structs
+
+   This module implements the creation and manipulations of the
+   array structs in the framework. The elements are kept in one block
+   that grows as needed.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_ARRAY_H_
+#define SPLASH_ARRAY_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_array
+
+  The Splash_array struct, a growable array of pointers.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_array {
+  void **data;          /**< The elements */
+  int32_t size;         /**< Number of elements */
+  int32_t capacity;     /**< Elements that fit before growing */
+} Splash_array;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new Splash_array
+  @return   New Splash_array otherwise NULL.
+
+  Creates a new Splash_array object destroy with splash_array_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_array SPLASHCALL *splash_array_create();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a item to the end of the array
+  @param    array     The array to add to
+  @param    data      The data to add
+  @return   0 on success else -1
+
+  Doubles the capacity when full, so adding is O(1) amortized.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_array_push(Splash_array *array, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds many items to the end of the array
+  @param    array     The array to add to
+  @param    data      The items to add
+  @param    count     Number of items
+  @return   0 on success else -1
+
+  Grows at most once and copies the items in one go.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_array_append(Splash_array *array, void **data, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the last item
+  @param    array     The array
+  @return   The removed item, -1 if the array is empty
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_array_pop(Splash_array *array);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the element at the given position
+  @param    array     The array
+  @param    pos       The position to get
+  @return   Data at the position, -1 if not found
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_array_get(Splash_array *array, int32_t pos);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the element at the given position
+  @param    array     The array
+  @param    pos       The position to set
+  @param    data      The data
+  @return   Void
+
+  Positions outside the array are ignored.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_array_set(Splash_array *array, int32_t pos, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the position of the data in the array
+  @param    array     The array
+  @param    data      The data to search for
+  @return   Position of the data, -1 if not found
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_array_get_position(Splash_array *array, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the data at a position
+  @param    array     The array
+  @param    pos       The position to remove
+  @return   Void
+
+  Shuffles the elements after it up by one, keeping their order.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_array_remove_position(Splash_array *array, int32_t pos);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the data at a position without keeping the order
+  @param    array     The array
+  @param    pos       The position to remove
+  @return   Void
+
+  Moves the last element into the gap, O(1).
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_array_swap_remove(Splash_array *array, int32_t pos);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes room for a number of elements
+  @param    array     The array
+  @param    count     Elements to hold without growing
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_array_reserve(Splash_array *array, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes everything in the array
+  @param    array     The array to empty
+  @return   Void
+
+  The capacity is kept.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_array_remove_all(Splash_array *array);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the size of the array
+  @param    array     The array
+  @return   Number of elements
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_array_get_size(Splash_array *array);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the array
+  @param    array     The array to destroy
+  @return   Void
+
+  The elements are not freed.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_array_destroy(Splash_array *array);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,129 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_batch.h
+   @author  P. Batty
+   @brief   Batch updates
+
+   This module implements float buffers and the loops that update whole
+   buffers of positions at once, so scripts can move thousands of objects
+   with a single call.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_BATCH_H_
+#define SPLASH_BATCH_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_buffer
+
+  The Splash buffer structure. Positions are stored as x, y pairs.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_buffer {
+  float *data;                          /**< The values */
+  int32_t length;                       /**< Number of values */
+} Splash_buffer;
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a Splash_buffer
+  @param    length  Number of values
+  @return   New Splash_buffer otherwise NULL.
+
+  Creates a buffer with every value 0, destroy with splash_buffer_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_buffer SPLASHCALL *splash_buffer_create(int32_t length);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a Splash_buffer
+  @param    buffer  The buffer
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_buffer_destroy(Splash_buffer *buffer);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves values by their velocities
+  @param    positions   The values to move
+  @param    velocities  The velocity of each value
+  @param    count       Number of values
+  @param    delta       The delta time
+  @return   Void
+
+  positions[i] += velocities[i] * delta, the buffers must not overlap.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_batch_integrate(float *positions, const float *velocities, int32_t count, float delta);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Translates positions
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    x           Amount to move along x
+  @param    y           Amount to move along y
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_batch_translate(float *positions, int32_t count, float x, float y);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clamps positions to a rectangle
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    min_x       Left of the rectangle
+  @param    min_y       Top of the rectangle
+  @param    max_x       Right of the rectangle
+  @param    max_y       Bottom of the rectangle
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_batch_clamp(float *positions, int32_t count, float min_x, float min_y, float max_x, float max_y);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the positions in a rectangle
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    min_x       Left of the rectangle
+  @param    min_y       Top of the rectangle
+  @param    max_x       Right of the rectangle
+  @param    max_y       Bottom of the rectangle
+  @param    visible     Receives the index of each position inside, may be NULL
+  @return   Number of positions inside
+
+  visible must hold count indices, they are written in order.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_batch_cull(const float *positions, int32_t count, float min_x, float min_y, float max_x, float max_y, int32_t *visible);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
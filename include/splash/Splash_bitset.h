@@ -0,0 +1,185 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_bitset.h
+   @author  P. Batty
+   @brief   The bitset structs
+
+   This module implements growable sets of bits stored in 64 bit words.
+   Whole set operations work a word, or with SSE2 two words, at a time.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_BITSET_H_
+#define SPLASH_BITSET_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_bitset
+
+  The bitset, bits past the size are always clear.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_bitset {
+  uint64_t *words;                      /**< the bits, bit i in words[i / 64] */
+  int32_t size;                         /**< number of bits */
+  int32_t word_count;                   /**< words allocated */
+} Splash_bitset;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new bitset
+  @param    size    Number of bits, all clear
+  @return   New Splash_bitset otherwise NULL.
+
+  Creates a new Splash_bitset object destroy with splash_bitset_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_bitset SPLASHCALL *splash_bitset_create(int32_t size);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Resizes the bitset
+  @param    bitset  The bitset
+  @param    size    Number of bits
+  @return   0 on success else -1
+
+  New bits are clear, bits cut off are lost.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_bitset_resize(Splash_bitset *bitset, int32_t size);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets a bit
+  @param    bitset  The bitset
+  @param    bit     The bit, the bitset grows to hold it
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_bitset_set(Splash_bitset *bitset, int32_t bit);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears a bit
+  @param    bitset  The bitset
+  @param    bit     The bit
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_bitset_clear(Splash_bitset *bitset, int32_t bit);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Tests a bit
+  @param    bitset  The bitset
+  @param    bit     The bit
+  @return   1 if set else 0, bits outside the bitset are clear
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_bitset_test(Splash_bitset *bitset, int32_t bit);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears every bit
+  @param    bitset  The bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_bitset_clear_all(Splash_bitset *bitset);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Counts the set bits
+  @param    bitset  The bitset
+  @return   Number of set bits
+
+  Uses the popcount instruction where the compiler has one.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_bitset_count(Splash_bitset *bitset);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Keeps the bits also set in another bitset
+  @param    bitset  The bitset to change
+  @param    other   The other bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_bitset_and(Splash_bitset *bitset, Splash_bitset *other);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds the bits set in another bitset
+  @param    bitset  The bitset to change, grows to the size of the other
+  @param    other   The other bitset
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_bitset_or(Splash_bitset *bitset, Splash_bitset *other);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the bits set in another bitset
+  @param    bitset  The bitset to change
+  @param    other   The other bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_bitset_andnot(Splash_bitset *bitset, Splash_bitset *other);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the next set bit
+  @param    bitset  The bitset
+  @param    bit     The bit to start at
+  @return   The first set bit at or after it else -1
+
+  Skips clear words whole, walk every set bit with
+  for (i = splash_bitset_next(b, 0); i != -1; i = splash_bitset_next(b, i + 1))
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_bitset_next(Splash_bitset *bitset, int32_t bit);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of bits
+  @param    bitset  The bitset
+  @return   Number of bits
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_bitset_get_size(Splash_bitset *bitset);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the bitset
+  @param    bitset  The bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_bitset_destroy(Splash_bitset *bitset);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
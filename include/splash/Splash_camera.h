@@ -19,6 +19,7 @@
 
 #include "SDL2/SDL.h"
 #include "Splash_vector.h"
+#include "Splash_handle.h"
 #include <stdint.h>
 
 #include "splash_begin_code.h"
@@ -42,6 +43,7 @@ typedef struct Splash_camera {
   Splash_vector3 position;       /**< The position of the camera */
   Splash_vector3 rotation;       /**< The rotation of the camera */
   Splash_vector3 size;           /**< The size of the camera */
+  Splash_handle id;              /**< The handle of the camera, see splash_handle_get */
 } Splash_camera;
 
 
@@ -0,0 +1,439 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_container.h
+   @author  P. Batty
+   @brief   The typed containers
+
+   This module implements containers generated for one element type by
+   macros. The elements are stored by value in one block, so structs sit
+   next to each other and nothing is allocated per element.
+
+   SPLASH_ARRAY(Particles, Particle) declares the type Particles and the
+   functions Particles_init, Particles_push and so on, see each macro for
+   the functions it makes. Containers are plain structs, init one before
+   use and free it with its _free function.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_CONTAINER_H_
+#define SPLASH_CONTAINER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#if defined(_MSC_VER)
+#define SPLASH_CONTAINER_FUNCTION static __inline
+#else
+#define SPLASH_CONTAINER_FUNCTION static inline
+#endif
+
+#define SPLASH_CONTAINER_INITIAL 16   /**< elements of the first block */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes an integer key
+  @param    key   The key
+  @return   The hash
+
+  For maps keyed by integers or pointers.
+
+\-----------------------------------------------------------------------------*/
+SPLASH_CONTAINER_FUNCTION uint64_t splash_container_hash_int(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+ return key;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Compares two integer keys
+  @param    a   The first key
+  @param    b   The second key
+  @return   1 if equal else 0
+
+\-----------------------------------------------------------------------------*/
+SPLASH_CONTAINER_FUNCTION int8_t splash_container_equal_int(uint64_t a, uint64_t b) {
+ return a == b;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    SPLASH_ARRAY
+
+  Declares a growable array of values.
+
+  name_init(a)                  Makes an empty array
+  name_free(a)                  Frees the elements
+  name_reserve(a, count)        Makes room for count elements, 0 else -1
+  name_push(a, value)           Adds to the end, 0 else -1
+  name_push_slot(a)             Adds an element to fill in, NULL on failure
+  name_pop(a, out)              Removes the last into out when not NULL, 0 else -1
+  name_at(a, pos)               Pointer to an element, NULL outside the array
+  name_swap_remove(a, pos)      Moves the last element into pos
+  name_clear(a)                 Removes every element, keeping the block
+
+  The elements are in a->data, a->size of them.
+\----------------------------------------------------------------------------*/
+#define SPLASH_ARRAY(name, type) \
+typedef struct name { \
+  type *data; \
+  int32_t size; \
+  int32_t capacity; \
+} name; \
+\
+SPLASH_CONTAINER_FUNCTION void name##_init(name *a) { \
+  a->data = NULL; \
+  a->size = 0; \
+  a->capacity = 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_free(name *a) { \
+  free(a->data); \
+  name##_init(a); \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_reserve(name *a, int32_t count) { \
+  int32_t capacity = a->capacity ? a->capacity : SPLASH_CONTAINER_INITIAL; \
+  type *data; \
+  if (count <= a->capacity) { \
+    return 0; \
+  } \
+  while (capacity < count) { \
+    capacity = capacity > INT32_MAX / 2 ? count : capacity << 1; \
+  } \
+  data = (type *)realloc(a->data, (size_t)capacity * sizeof(type)); \
+  if (data == NULL) { \
+    return -1; \
+  } \
+  a->data = data; \
+  a->capacity = capacity; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION type *name##_push_slot(name *a) { \
+  if (a->size == a->capacity && name##_reserve(a, a->size + 1) == -1) { \
+    return NULL; \
+  } \
+ return &a->data[a->size++]; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_push(name *a, type value) { \
+  type *slot = name##_push_slot(a); \
+  if (slot == NULL) { \
+    return -1; \
+  } \
+  *slot = value; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_pop(name *a, type *out) { \
+  if (a->size == 0) { \
+    return -1; \
+  } \
+  a->size--; \
+  if (out != NULL) { \
+    *out = a->data[a->size]; \
+  } \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION type *name##_at(name *a, int32_t pos) { \
+ return (pos < 0 || pos >= a->size) ? NULL : &a->data[pos]; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_swap_remove(name *a, int32_t pos) { \
+  if (pos < 0 || pos >= a->size) { \
+    return; \
+  } \
+  a->data[pos] = a->data[--a->size]; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_clear(name *a) { \
+  a->size = 0; \
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    SPLASH_DEQUE
+
+  Declares a ring buffer of values that grows, O(1) at both ends.
+
+  name_init(d)                  Makes an empty deque
+  name_free(d)                  Frees the elements
+  name_reserve(d, count)        Makes room for count elements, 0 else -1
+  name_push_back(d, value)      Adds to the back, 0 else -1
+  name_push_front(d, value)     Adds to the front, 0 else -1
+  name_pop_back(d, out)         Removes the back into out when not NULL, 0 else -1
+  name_pop_front(d, out)        Removes the front into out when not NULL, 0 else -1
+  name_at(d, pos)               Pointer to an element from the front, NULL outside
+  name_clear(d)                 Removes every element, keeping the block
+
+  The capacity is a power of two so positions wrap with a mask.
+\----------------------------------------------------------------------------*/
+#define SPLASH_DEQUE(name, type) \
+typedef struct name { \
+  type *data; \
+  int32_t head; \
+  int32_t size; \
+  int32_t capacity; \
+} name; \
+\
+SPLASH_CONTAINER_FUNCTION void name##_init(name *d) { \
+  d->data = NULL; \
+  d->head = 0; \
+  d->size = 0; \
+  d->capacity = 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_free(name *d) { \
+  free(d->data); \
+  name##_init(d); \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_reserve(name *d, int32_t count) { \
+  int32_t capacity = d->capacity ? d->capacity : SPLASH_CONTAINER_INITIAL; \
+  type *data; \
+  int32_t i; \
+  if (count <= d->capacity) { \
+    return 0; \
+  } \
+  while (capacity < count) { \
+    if (capacity > INT32_MAX / 2) { \
+      return -1; \
+    } \
+    capacity <<= 1; \
+  } \
+  data = (type *)malloc((size_t)capacity * sizeof(type)); \
+  if (data == NULL) { \
+    return -1; \
+  } \
+  for (i = 0; i < d->size; i++) { \
+    data[i] = d->data[(d->head + i) & (d->capacity - 1)]; \
+  } \
+  free(d->data); \
+  d->data = data; \
+  d->head = 0; \
+  d->capacity = capacity; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_push_back(name *d, type value) { \
+  if (d->size == d->capacity && name##_reserve(d, d->size + 1) == -1) { \
+    return -1; \
+  } \
+  d->data[(d->head + d->size) & (d->capacity - 1)] = value; \
+  d->size++; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_push_front(name *d, type value) { \
+  if (d->size == d->capacity && name##_reserve(d, d->size + 1) == -1) { \
+    return -1; \
+  } \
+  d->head = (d->head - 1) & (d->capacity - 1); \
+  d->data[d->head] = value; \
+  d->size++; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_pop_back(name *d, type *out) { \
+  if (d->size == 0) { \
+    return -1; \
+  } \
+  d->size--; \
+  if (out != NULL) { \
+    *out = d->data[(d->head + d->size) & (d->capacity - 1)]; \
+  } \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_pop_front(name *d, type *out) { \
+  if (d->size == 0) { \
+    return -1; \
+  } \
+  if (out != NULL) { \
+    *out = d->data[d->head]; \
+  } \
+  d->head = (d->head + 1) & (d->capacity - 1); \
+  d->size--; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION type *name##_at(name *d, int32_t pos) { \
+ return (pos < 0 || pos >= d->size) ? NULL : &d->data[(d->head + pos) & (d->capacity - 1)]; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_clear(name *d) { \
+  d->head = 0; \
+  d->size = 0; \
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    SPLASH_MAP
+
+  Declares an open addressed map from keys to values, both stored inline.
+  hash is called as uint64_t hash(key_type) and equal as
+  int equal(key_type, key_type), see splash_container_hash_int();
+
+  name_init(m)                  Makes an empty map
+  name_free(m)                  Frees the slots
+  name_reserve(m, count)        Makes room for count entries, 0 else -1
+  name_put(m, key, value)       Adds or replaces, 0 else -1
+  name_get(m, key)              Pointer to the value, NULL if missing
+  name_remove(m, key)           Removes the key, 1 if it was there else 0
+  name_clear(m)                 Removes every entry, keeping the slots
+
+  Linear probing, the slots are at most three quarters full and removing
+  shifts the following entries back so no tombstones are left. Entries
+  are walked with m->used[i] over m->capacity slots.
+\----------------------------------------------------------------------------*/
+#define SPLASH_MAP(name, key_type, value_type, hash, equal) \
+typedef struct name { \
+  uint8_t *used; \
+  key_type *keys; \
+  value_type *values; \
+  int32_t size; \
+  int32_t capacity; \
+} name; \
+\
+SPLASH_CONTAINER_FUNCTION void name##_init(name *m) { \
+  m->used = NULL; \
+  m->keys = NULL; \
+  m->values = NULL; \
+  m->size = 0; \
+  m->capacity = 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_free(name *m) { \
+  free(m->used); \
+  free(m->keys); \
+  free(m->values); \
+  name##_init(m); \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int32_t name##_find(name *m, key_type key, int8_t *found) { \
+  int32_t mask = m->capacity - 1; \
+  int32_t index = (int32_t)(hash(key) & (uint64_t)mask); \
+  while (m->used[index]) { \
+    if (equal(m->keys[index], key)) { \
+      *found = 1; \
+      return index; \
+    } \
+    index = (index + 1) & mask; \
+  } \
+  *found = 0; \
+ return index; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_reserve(name *m, int32_t count) { \
+  name grown; \
+  int32_t capacity = m->capacity ? m->capacity : SPLASH_CONTAINER_INITIAL; \
+  int32_t i; \
+  int8_t found; \
+  while ((int64_t)count * 4 > (int64_t)capacity * 3) { \
+    if (capacity > INT32_MAX / 2) { \
+      return -1; \
+    } \
+    capacity <<= 1; \
+  } \
+  if (capacity == m->capacity) { \
+    return 0; \
+  } \
+  grown.used = (uint8_t *)calloc((size_t)capacity, 1); \
+  grown.keys = (key_type *)malloc((size_t)capacity * sizeof(key_type)); \
+  grown.values = (value_type *)malloc((size_t)capacity * sizeof(value_type)); \
+  grown.size = m->size; \
+  grown.capacity = capacity; \
+  if (grown.used == NULL || grown.keys == NULL || grown.values == NULL) { \
+    name##_free(&grown); \
+    return -1; \
+  } \
+  for (i = 0; i < m->capacity; i++) { \
+    if (m->used[i]) { \
+      int32_t index = name##_find(&grown, m->keys[i], &found); \
+      grown.used[index] = 1; \
+      grown.keys[index] = m->keys[i]; \
+      grown.values[index] = m->values[i]; \
+    } \
+  } \
+  name##_free(m); \
+  *m = grown; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_put(name *m, key_type key, value_type value) { \
+  int32_t index; \
+  int8_t found; \
+  if (name##_reserve(m, m->size + 1) == -1) { \
+    return -1; \
+  } \
+  index = name##_find(m, key, &found); \
+  if (!found) { \
+    m->used[index] = 1; \
+    m->keys[index] = key; \
+    m->size++; \
+  } \
+  m->values[index] = value; \
+ return 0; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION value_type *name##_get(name *m, key_type key) { \
+  int32_t index; \
+  int8_t found; \
+  if (m->size == 0) { \
+    return NULL; \
+  } \
+  index = name##_find(m, key, &found); \
+ return found ? &m->values[index] : NULL; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION int8_t name##_remove(name *m, key_type key) { \
+  int32_t mask = m->capacity - 1; \
+  int32_t hole; \
+  int32_t index; \
+  int8_t found; \
+  if (m->size == 0) { \
+    return 0; \
+  } \
+  hole = name##_find(m, key, &found); \
+  if (!found) { \
+    return 0; \
+  } \
+  index = (hole + 1) & mask; \
+  while (m->used[index]) { \
+    int32_t home = (int32_t)(hash(m->keys[index]) & (uint64_t)mask); \
+    if (((index - home) & mask) >= ((index - hole) & mask)) { \
+      m->keys[hole] = m->keys[index]; \
+      m->values[hole] = m->values[index]; \
+      hole = index; \
+    } \
+    index = (index + 1) & mask; \
+  } \
+  m->used[hole] = 0; \
+  m->size--; \
+ return 1; \
+} \
+\
+SPLASH_CONTAINER_FUNCTION void name##_clear(name *m) { \
+  if (m->used != NULL) { \
+    memset(m->used, 0, (size_t)m->capacity); \
+  } \
+  m->size = 0; \
+}
+
+
+#endif
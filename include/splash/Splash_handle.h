@@ -0,0 +1,110 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_handle.h
+   @author  P. Batty
+   @brief   The object handles
+
+   This module implements the handles of the Splash objects. Textures,
+   cameras and states are given a handle when made and drop it when
+   destroyed, so code holding a handle can check the object still exists
+   instead of following a stale pointer.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_HANDLE_H_
+#define SPLASH_HANDLE_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash_slotmap.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives an object a handle
+  @param    object    The object
+  @return   The handle else SPLASH_HANDLE_NULL
+
+  Drop the handle with splash_handle_destroy(); before the object is
+  freed. The handles can be used from any thread.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_handle SPLASHCALL splash_handle_create(void *object);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the object of a handle
+  @param    handle    The handle
+  @return   The object else NULL if it was destroyed
+
+  Gets the object with one locked lookup, a destroyed object or a stale
+  handle gives NULL rather than a dangling pointer.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_handle_get(Splash_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the handle of an object
+  @param    object    The object
+  @return   The handle else SPLASH_HANDLE_NULL if it has none
+
+  Gets the handle given to an object by splash_handle_create();, used
+  when only the object pointer is at hand.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_handle SPLASHCALL splash_handle_find(void *object);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Drops a handle
+  @param    handle    The handle, stale handles are ignored
+  @return   Void
+
+  Removes the object from the handles, splash_handle_get(); gives NULL
+  for the handle after.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_handle_destroy(Splash_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of live handles
+  @return   Number of objects with a handle
+
+  Gets the number of objects with a handle, objects not destroyed show
+  up here as leaks.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_handle_get_count();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees the handles
+  @return   Void
+
+  Frees the maps behind the handles, every handle is stale after. Called
+  by splash_quit(); once lua has destroyed its objects, the maps are made
+  again on the next splash_handle_create();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_handle_quit();
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -30,28 +30,88 @@ extern "C" {
  ---------------------------------------------------------------------------*/
 
 
+#define SPLASH_HASHMAP_GROUP 16         /**< control bytes probed at once */
+
+#define SPLASH_HASHMAP_INT(i) ((void *)(intptr_t)(i))  /**< makes an integer key */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_hashmap_hash
+
+  Hashes a key, every bit of the result should depend on the key.
+\----------------------------------------------------------------------------*/
+typedef uint64_t (*Splash_hashmap_hash)(const void *key);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_hashmap_equal
+
+  Compares two keys, returns 1 if they are equal else 0. Only called for
+  keys with the same hash at different addresses.
+\----------------------------------------------------------------------------*/
+typedef int8_t (*Splash_hashmap_equal)(const void *a, const void *b);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_hashmap_type
+
+  The type of a stored value.
+\----------------------------------------------------------------------------*/
+typedef enum Splash_hashmap_type {
+  SPLASH_HASHMAP_NONE = -1,               /**< no value stored under the key */
+  SPLASH_HASHMAP_POINTER,                 /**< a pointer, stored by splash_hashmap_add */
+  SPLASH_HASHMAP_STRING,                  /**< a C string, not copied */
+  SPLASH_HASHMAP_INT64,                   /**< an integer */
+  SPLASH_HASHMAP_DOUBLE                   /**< a double */
+} Splash_hashmap_type;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_hashmap_value
+
+  A stored value, the slot type says which member is set.
+\----------------------------------------------------------------------------*/
+typedef union Splash_hashmap_value {
+  void *pointer;                          /**< pointer and string values */
+  int64_t integer;                        /**< integer values */
+  double number;                          /**< double values */
+} Splash_hashmap_value;
+
+
 /*!--------------------------------------------------------------------------
-  @brief    Splash_hashmap_element
+  @brief    Splash_hashmap_slot
 
-  hashmap element 
+  hashmap slot, the key and value are stored inline in the slot array
 \----------------------------------------------------------------------------*/
-struct _Splash_hashmap_element_ {
+typedef struct Splash_hashmap_slot {
   void *key;                              /**< the key */
-  void *value;                            /**<* The value */
-  struct _Splash_hashmap_element_ *next;  /**< The collision list */
-} _Splash_hashmap_element_ ;
+  Splash_hashmap_value value;             /**< The value */
+  uint64_t hash;                          /**< hash of the key */
+  int32_t type;                           /**< the Splash_hashmap_type of the value */
+} Splash_hashmap_slot;
 
 
 /*!--------------------------------------------------------------------------
   @brief    Splash_hashmap
 
-  Basic hashmap implementation
+  Open addressed hashmap. Each slot has a control byte holding 7 bits of
+  the key hash or empty, lookups compare a group of control bytes at once
+  and only check the keys whose byte matches. While growing incrementally
+  the old table is kept and checked after the new one.
 
 \----------------------------------------------------------------------------*/
 typedef struct Splash_hashmap {
-  int32_t size;                               /**< size of the hashmap */
+  int32_t size;                               /**< number of slots, a power of two */
   int32_t count;                              /**< number of elements*/
-  struct _Splash_hashmap_element_ **buckets;  /**< the buckets */
+  uint8_t *control;                           /**< control bytes, the first group is repeated at the end */
+  Splash_hashmap_slot *slots;                 /**< the slots */
+  Splash_hashmap_hash hash;                   /**< hashes the keys */
+  Splash_hashmap_equal equal;                 /**< compares the keys, NULL compares the pointers */
+  uint8_t *old_control;                       /**< control bytes of the table being migrated else NULL */
+  Splash_hashmap_slot *old_slots;             /**< slots of the table being migrated */
+  int32_t old_size;                           /**< number of slots being migrated */
+  int32_t migrated;                           /**< old slots below this index have been moved */
+  int32_t step;                               /**< old slots moved per operation, 0 moves them all at once */
 } Splash_hashmap;
 
 
@@ -64,12 +124,73 @@ typedef struct Splash_hashmap {
   @return   New hashmap object else NULL
 
   Creates a new Splash_hashmap object destroy with splash_hashmap_destroy();
-  On success will return a new Splash_object else NULL.
+  On success will return a new Splash_object else NULL. The keys are C
+  strings compared by their contents.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT Splash_hashmap SPLASHCALL *splash_hashmap_create();
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with integer keys
+  @return   New hashmap object else NULL
+
+  The keys are integers made with SPLASH_HASHMAP_INT(i);
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_hashmap SPLASHCALL *splash_hashmap_create_int();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with pointer keys
+  @return   New hashmap object else NULL
+
+  The keys are compared by address, the memory they point to is not read.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_hashmap SPLASHCALL *splash_hashmap_create_pointer();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with custom keys
+  @param    hash    Hashes the keys
+  @param    equal   Compares the keys, NULL to compare the pointers
+  @return   New hashmap object else NULL
+
+  Each key is hashed once when added, the hash is stored with it.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_hashmap SPLASHCALL *splash_hashmap_create_with(Splash_hashmap_hash hash, Splash_hashmap_equal equal);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes a string key
+  @param    key   The C string
+  @return   Hash
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint64_t SPLASHCALL splash_hashmap_hash_string(const void *key);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Compares two string keys
+  @param    a     The first C string
+  @param    b     The second C string
+  @return   1 if equal else 0
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_hashmap_equal_string(const void *a, const void *b);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes an integer or pointer key
+  @param    key   The key
+  @return   Hash
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint64_t SPLASHCALL splash_hashmap_hash_int(const void *key);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a element to the Splash_hashmap
   @param    hashmap     The hashmap to add the data to
@@ -90,6 +211,7 @@ extern DLL_EXPORT void SPLASHCALL splash_hashmap_add(Splash_hashmap *hashmap, vo
   @return    the value stored at that location else -1
 
   Returns the value at the given location. NOTE: DOES NOTE CAST TO A TYPE.
+  Integer and double values are not pointers, -1 is returned for them.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT void SPLASHCALL *splash_hashmap_get(Splash_hashmap *hashmap, void *key);
@@ -113,7 +235,8 @@ extern DLL_EXPORT char SPLASHCALL *splash_hashmap_get_string(Splash_hashmap *has
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a int.
+  Returns the value at the given location as a int. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT int SPLASHCALL splash_hashmap_get_int(Splash_hashmap *hashmap, void *key);
@@ -125,7 +248,8 @@ extern DLL_EXPORT int SPLASHCALL splash_hashmap_get_int(Splash_hashmap *hashmap,
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a float.
+  Returns the value at the given location as a float. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT float SPLASHCALL splash_hashmap_get_float(Splash_hashmap *hashmap, void *key);
@@ -137,12 +261,72 @@ extern DLL_EXPORT float SPLASHCALL splash_hashmap_get_float(Splash_hashmap *hash
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a double.
+  Returns the value at the given location as a double. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT double SPLASHCALL splash_hashmap_get_double(Splash_hashmap *hashmap, void *key);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Stores a string
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The string, it is not copied
+  @return    void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_hashmap_set_string(Splash_hashmap *hashmap, void *key, char *value);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores an integer
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The integer
+  @return    void
+
+  The integer is stored in the slot, reading it back does no parsing.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_hashmap_set_int(Splash_hashmap *hashmap, void *key, int64_t value);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores a double
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The double
+  @return    void
+
+  The double is stored in the slot, reading it back does no parsing.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_hashmap_set_double(Splash_hashmap *hashmap, void *key, double value);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a 64 bit integer element
+  @param    hashmap     The hashmap to get the data from
+  @param    key         The key to search for
+  @return    the value stored at that location else -1
+
+  Returns the value as an integer, converted like splash_hashmap_get_int();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int64_t SPLASHCALL splash_hashmap_get_int64(Splash_hashmap *hashmap, void *key);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the type of an element
+  @param    hashmap     The hashmap to get the data from
+  @param    key         The key to search for
+  @return    The type of the value else SPLASH_HASHMAP_NONE
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_hashmap_type SPLASHCALL splash_hashmap_get_type(Splash_hashmap *hashmap, void *key);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Removes a element in the hashmap
   @param    hashmap     The hashmap to remove the data from
@@ -155,6 +339,41 @@ extern DLL_EXPORT double SPLASHCALL splash_hashmap_get_double(Splash_hashmap *ha
 extern DLL_EXPORT void SPLASHCALL splash_hashmap_remove(Splash_hashmap *hashmap, void *key);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Sets the incremental rehash mode
+  @param    hashmap   The hashmap
+  @param    step      Old slots moved per operation while growing, 0 moves
+                      them all when the hashmap grows
+  @return   Void
+
+  With a step the old slots are kept when the hashmap grows and each add,
+  get and remove moves a few, spreading the cost of growing over frames.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_hashmap_set_incremental(Splash_hashmap *hashmap, int32_t step);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reserves room for elements
+  @param    hashmap   The hashmap
+  @param    count     Number of elements
+  @return   0 on success else -1
+
+  Grows the hashmap at once so count elements fit without growing again.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_hashmap_reserve(Splash_hashmap *hashmap, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity of the hashmap
+  @param    hashmap   The hashmap
+  @return   Number of elements that fit before the hashmap grows
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_hashmap_get_capacity(Splash_hashmap *hashmap);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Gets the size of the hashmap
   @param  list      The list to count
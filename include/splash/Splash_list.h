@@ -17,6 +17,7 @@
                                 Includes
  ---------------------------------------------------------------------------*/
 
+#include "Splash_pool.h"
 #include <stdint.h>
 
 #include "splash_begin_code.h"
@@ -48,6 +49,8 @@ struct _splash_list_node_ {
 typedef struct Splash_list {
   int32_t size; /**< The size of the list */
   struct _splash_list_node_ *next; /**< pointer to the first element */
+  struct _splash_list_node_ *tail; /**< pointer to the last element */
+  Splash_pool *pool; /**< the pool the nodes come from */
 } Splash_list;
 
 
@@ -60,19 +63,44 @@ typedef struct Splash_list {
   @return   New Splash_List otherwise NULL.
 
   Creates a new Splash_list object destroy with splash_list_destroy();
-  return a new object else null if unsuccessful
+  return a new object else null if unsuccessful. The nodes come from the
+  shared node pool.
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT Splash_list SPLASHCALL *splash_list_create();
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new Splash_list using a pool
+  @param  pool      Pool of blocks of sizeof(struct _splash_list_node_)
+  @return   New Splash_List otherwise NULL.
+
+  Like splash_list_create(); but the nodes come from the given pool, so a
+  list can keep its nodes together and drop them with the pool. The pool
+  must outlive the list.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_list SPLASHCALL *splash_list_create_pool(Splash_pool *pool);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the pool shared by the lists
+  @return   The shared node pool else NULL
+
+  Lists made by splash_list_create(); take their nodes from this pool, it
+  is shared between threads with thread caches on.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_pool SPLASHCALL *splash_list_get_shared_pool();
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a item to the list
   @param  list      The list to add to
   @param  data       The data to add
   @return  Void
 
-  Adds a item to the end of the list
+  Adds a item to the end of the list, O(1) as the tail is kept
 
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT void SPLASHCALL splash_list_add(Splash_list *list, void *data);
@@ -198,7 +226,7 @@ extern DLL_EXPORT void SPLASHCALL splash_list_remove(Splash_list *list, void *da
   @param  list      The list to empty
   @return  Void
 
-  Empties the list.
+  Empties the list in one pass.
   
 \-----------------------------------------------------------------------------*/
 extern DLL_EXPORT void SPLASHCALL splash_list_remove_all(Splash_list *list);
@@ -0,0 +1,127 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_lua_memory.h
+   @author  P. Batty
+   @brief   Lua memory management
+
+   This module implements the pooled allocator the lua states run on and
+   the frame budgeted garbage collection driven by the state machine.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_LUA_MEMORY_H_
+#define SPLASH_LUA_MEMORY_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Lua memory statistics
+
+  The frame counters cover the last frame finished with
+  splash_lua_end_frame();
+
+\-----------------------------------------------------------------------------*/
+typedef struct Splash_lua_memory {
+  uint32_t allocations;                 /**< blocks allocated last frame */
+  uint32_t frees;                       /**< blocks freed last frame */
+  size_t allocated;                     /**< bytes allocated last frame */
+  uint32_t gc_steps;                    /**< collector steps run last frame */
+  double gc_time;                       /**< milliseconds spent collecting last frame */
+  size_t in_use;                        /**< bytes held by lua */
+  size_t peak;                          /**< most bytes ever held by lua */
+  size_t pooled;                        /**< bytes in pool pages, used or free */
+} Splash_lua_memory;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a lua state on the pooled allocator
+  @return   The new state else NULL
+
+  Small blocks come from per size class free lists carved out of pages,
+  larger ones from realloc. Close with splash_lua_close(); to free the
+  pool as well.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT lua_State SPLASHCALL *splash_lua_newstate();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Closes a lua state
+  @param    l   The lua state
+  @return   Void
+
+  Closes the state and frees its pool if it was made with
+  splash_lua_newstate();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_close(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the memory statistics
+  @param    l       The lua state
+  @param    memory  Filled with the statistics
+  @return   0 on success else -1
+
+  Fails for states not made with splash_lua_newstate();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_get_memory(lua_State *l, Splash_lua_memory *memory);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the garbage collection budget
+  @param    l             The lua state
+  @param    milliseconds  Most time to collect each frame, 0 for the automatic collector
+  @return   0 on success else -1
+
+  With a budget the collection is done by splash_lua_end_frame(); in the
+  time left before the next tick. The automatic collector stays on as a
+  fallback with a raised pause, so the heap stays bounded when frames
+  overrun or a long load runs between frames.
+  Fails for states not made with splash_lua_newstate();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_set_gc_budget(lua_State *l, double milliseconds);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Ends a frame
+  @param    l         The lua state
+  @param    leftover  Milliseconds left before the next tick is due
+  @return   Void
+
+  Steps the collector within the leftover time, up to the budget, and
+  starts new frame statistics. One step is always taken so the collector
+  keeps up when frames run long. Called by the state machine after every
+  frame.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_end_frame(lua_State *l, double leftover);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
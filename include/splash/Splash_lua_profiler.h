@@ -0,0 +1,141 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_lua_profiler.h
+   @author  P. Batty
+   @brief   The lua profiler
+
+   This module implements a sampling profiler for the lua scripts, the
+   samples are folded into flamegraph stacks under the state callback
+   they were taken in.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_LUA_PROFILER_H_
+#define SPLASH_LUA_PROFILER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define SPLASH_PROFILER_INTERVAL 1000   /**< default instructions between samples */
+
+/*!--------------------------------------------------------------------------
+  @brief    The part of the frame a sample was taken in
+
+  Each phase is the root frame of its samples in the folded output.
+
+\-----------------------------------------------------------------------------*/
+typedef enum Splash_profiler_phase {
+  SPLASH_PROFILER_OTHER,                /**< outside the state callbacks */
+  SPLASH_PROFILER_INIT,                 /**< in a state init */
+  SPLASH_PROFILER_UPDATE,               /**< in a state update, timers and tasks */
+  SPLASH_PROFILER_EVENT,                /**< in a state event */
+  SPLASH_PROFILER_RENDER,               /**< in a state render */
+  SPLASH_PROFILER_CLEANUP               /**< in a state cleanup */
+} Splash_profiler_phase;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Starts profiling
+  @param    l         The lua state
+  @param    interval  Lua instructions between samples, 0 or less for the default
+  @return   0 on success else -1
+
+  Samples are kept until splash_lua_profiler_clear(); so profiling can be
+  started and stopped around the frames of interest.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_profiler_start(lua_State *l, int32_t interval);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops profiling
+  @return   Void
+
+  Stops taking samples, coroutines drop their hook the next time it fires.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_profiler_stop();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if the profiler is running
+  @return   1 if running else 0
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_profiler_running();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Samples a thread
+  @param    l   The thread
+  @return   Void
+
+  Threads made before the profiler started have no hook, the state
+  machine attaches the threads it resumes.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_profiler_attach(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the phase
+  @param    phase   The phase samples are counted under
+  @return   The previous phase
+
+  Called by the state machine around the state callbacks.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_profiler_phase SPLASHCALL splash_lua_profiler_phase(Splash_profiler_phase phase);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of samples
+  @return   Samples taken since the last clear
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint32_t SPLASHCALL splash_lua_profiler_get_samples();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes the samples
+  @param    path    Path to the output file
+  @return   0 on success else -1
+
+  Writes one "phase;outer;...;inner count" line per stack, the folded
+  format read by flamegraph.pl and speedscope.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_profiler_write(const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears the samples
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_profiler_clear();
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
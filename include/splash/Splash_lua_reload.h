@@ -0,0 +1,118 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_lua_reload.h
+   @author  P. Batty
+   @brief   Lua hot reload
+
+   This module implements reloading changed lua scripts while the game
+   runs. Reloaded states keep their handle and current state, only their
+   callbacks are swapped.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_LUA_RELOAD_H_
+#define SPLASH_LUA_RELOAD_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define SPLASH_RELOAD_INTERVAL 250      /**< milliseconds between checking the scripts */
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Turns hot reload on or off
+  @param    enabled   Watch the scripts run by splash_lua_dofile();
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_set_hot_reload(int8_t enabled);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if hot reload is on
+  @return   1 if on else 0
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_get_hot_reload();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs and watches a script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Runs the script like splash_lua_dofile(); and reruns it when the file
+  changes. When the script returns a table, the first table is kept and
+  later runs copy their functions into it, its other fields are left as
+  they are.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_watch(lua_State *l, const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reloads a watched script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  While the script runs states added under a used name rebind the callbacks
+  of the existing state, and starting the state machine is ignored. A
+  script that fails to compile leaves the old code running.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_reload(lua_State *l, const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reloads the changed scripts
+  @param    l     The lua state
+  @return   Number of scripts reloaded
+
+  Checks the watched files at most every SPLASH_RELOAD_INTERVAL, called
+  by the state machine between frames.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_lua_reload_changed(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a script is being reloaded
+  @return   1 while reloading else 0
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_reloading();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops watching every script
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_unwatch_all();
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,107 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_lua_worker.h
+   @author  P. Batty
+   @brief   The lua workers
+
+   This module implements lua states running on their own threads. Jobs
+   and results are copied between the states as serialized messages so
+   the states share nothing.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_LUA_WORKER_H_
+#define SPLASH_LUA_WORKER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+typedef struct Splash_lua_worker Splash_lua_worker;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a worker
+  @param    path    Path to the worker script
+  @return   New Splash_lua_worker otherwise NULL.
+
+  Starts a thread with its own lua state, the script is run there and
+  must return the function jobs are called with. The state has the
+  standard libraries and the bindings that keep no global state, see
+  splash_lua_register_worker(); Destroy with splash_lua_worker_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_lua_worker SPLASHCALL *splash_lua_worker_create(const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Posts a job
+  @param    worker  The worker
+  @param    l       The lua state holding the arguments
+  @param    nargs   Number of arguments on top of the stack
+  @return   0 on success else -1
+
+  Copies and pops the arguments. nil, booleans, numbers, strings and
+  tables of those can be passed, anything else fails with an error
+  message left on the stack.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_worker_post(Splash_lua_worker *worker, lua_State *l, int nargs);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a result
+  @param    worker  The worker
+  @param    l       The lua state to push the result to
+  @param    wait    Block until a result is ready
+  @return   Number of values pushed, -1 if no result is ready
+
+  Results come back in the order the jobs were posted. Pushes true and
+  the values the job returned, or false and the error message.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int SPLASHCALL splash_lua_worker_result(Splash_lua_worker *worker, lua_State *l, int8_t wait);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of pending jobs
+  @param    worker  The worker
+  @return   Jobs posted whose results have not been taken
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_lua_worker_pending(Splash_lua_worker *worker);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a worker
+  @param    worker  The worker
+  @return   Void
+
+  Finishes the running job, drops the rest and joins the thread.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_worker_destroy(Splash_lua_worker *worker);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
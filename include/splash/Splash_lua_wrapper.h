@@ -21,6 +21,17 @@
 #include "lua/lualib.h"
 #include <stdint.h>
 
+/* LuaJIT has the 5.1 api with most of the 5.2 auxiliary library */
+#if LUA_VERSION_NUM < 502
+#ifndef LUA_OK
+#define LUA_OK 0
+#endif
+#define luaL_newlib(l, r) (lua_createtable(l, 0, sizeof(r) / sizeof((r)[0]) - 1), luaL_setfuncs(l, r, 0))
+#define lua_setuservalue(l, index) lua_setfenv(l, index)
+#define lua_resume(l, from, nargs) lua_resume(l, nargs)
+#define lua_rawlen(l, index) lua_objlen(l, index)
+#endif
+
 #include "splash_begin_code.h"
 /* Set up for C definitions */
 #ifdef __cplusplus
@@ -44,7 +55,88 @@ extern DLL_EXPORT lua_State *splash_lua_state; /**< Global lua state */
   Registrars all functions and structs with lua.
 
 \-----------------------------------------------------------------------------*/
-extern void splash_lua_register_all();
+extern void splash_lua_register_all(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Registrars the worker safe functions with lua
+  @param    l   The state to register to
+  @return   Void
+
+  Registrars the bindings that keep no global state, used for the states
+  of the lua workers. The state machine, timers, tasks, events and the
+  graphics all belong to the main thread and its state.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_lua_register_worker(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a traceback to an error
+  @param    l   The lua state
+  @return   1, the error message with a traceback
+
+  Message handler for lua_pcall that appends a stack traceback to the error
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int SPLASHCALL splash_lua_traceback(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Calls a lua function
+  @param    l         The lua state
+  @param    nargs     Number of arguments pushed after the function
+  @param    nresults  Number of results to keep
+  @return   0 on success else -1
+
+  Calls the function with splash_lua_traceback as the message handler,
+  errors are printed with their traceback and popped.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_call(lua_State *l, int nargs, int nresults);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the script cache
+  @param    directory   Directory to keep compiled chunks in, NULL to disable
+  @param    strip       Strip debug info from the cached chunks
+  @return   0 on success else -1
+
+  Scripts loaded with splash_lua_load are compiled once and kept in
+  directory as bytecode keyed by a hash of their source, so an edited
+  script gets a new entry. The directory is created if missing. Only
+  point it at a directory you trust, cached chunks are loaded as is.
+  Stripping needs LuaJIT, Lua 5.2 always dumps the debug info.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_set_cache(const char *directory, int8_t strip);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Loads a lua script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Pushes the script as a function like luaL_loadfile, or the error
+  message on failure. Goes through the script cache when one is set.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_load(lua_State *l, const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs a lua script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Loads the script with splash_lua_load and calls it with
+  splash_lua_call, errors are printed and popped. With hot reload on the
+  script is watched, see splash_lua_watch.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_lua_dofile(lua_State *l, const char *path);
 
 
 /* end C definitions */
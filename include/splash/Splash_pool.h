@@ -0,0 +1,187 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_pool.h
+   @author  P. Batty
+   @brief   The pool structs
+
+   This module implements fixed size block pools. Blocks are carved from
+   pages and reused through a free list, all of them are freed at once
+   when the pool is destroyed.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_POOL_H_
+#define SPLASH_POOL_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "SDL2/SDL.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define SPLASH_POOL_PAGE_BLOCKS 256     /**< blocks in a page when none are given */
+#define SPLASH_POOL_CACHE 64            /**< most blocks a thread cache holds */
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_pool_block
+
+  A free block, the link is stored in the block itself.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_pool_block {
+  struct Splash_pool_block *next;       /**< next free block */
+} Splash_pool_block;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_pool
+
+  A pool of blocks of one size.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_pool {
+  int32_t block_size;                   /**< bytes in a block */
+  int32_t page_blocks;                  /**< blocks carved per page */
+  Splash_pool_block *free;              /**< the free blocks */
+  struct Splash_pool_page *pages;       /**< every page, freed with the pool */
+  int32_t used;                         /**< blocks handed out */
+  int32_t capacity;                     /**< blocks in the pages */
+  int8_t shared;                        /**< used from more than one thread */
+  int8_t thread_cache;                  /**< threads keep their own free blocks */
+  SDL_SpinLock lock;                    /**< guards a shared pool */
+  SDL_atomic_t generation;              /**< changes on free all, stale thread caches are dropped */
+  struct Splash_pool *next_cached;      /**< next pool that has had thread caches */
+} Splash_pool;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new pool
+  @param    block_size    Bytes in a block
+  @param    page_blocks   Blocks carved per page, 0 for SPLASH_POOL_PAGE_BLOCKS
+  @return   New Splash_pool otherwise NULL.
+
+  Creates a pool for one thread, destroy with splash_pool_destroy();
+  Blocks are rounded up to a multiple of 8 bytes.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_pool SPLASHCALL *splash_pool_create(int32_t block_size, int32_t page_blocks);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new shared pool
+  @param    block_size    Bytes in a block
+  @param    page_blocks   Blocks carved per page, 0 for SPLASH_POOL_PAGE_BLOCKS
+  @return   New Splash_pool otherwise NULL.
+
+  Like splash_pool_create(); but the pool can be used from any thread, it
+  is guarded by a spin lock.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_pool SPLASHCALL *splash_pool_create_shared(int32_t block_size, int32_t page_blocks);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Turns the thread caches of a shared pool on or off
+  @param    pool      The shared pool
+  @param    enabled   Let threads keep free blocks
+  @return   Void
+
+  Each thread keeps up to SPLASH_POOL_CACHE free blocks of the last shared
+  pool it used, and takes and returns them in batches, so most calls skip
+  the lock. Blocks in a cache count as used. Threads must call
+  splash_pool_flush_thread_cache(); before they exit. When the pool is
+  emptied or destroyed by another thread the caches of the others are
+  dropped the next time they are used.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_pool_set_thread_cache(Splash_pool *pool, int8_t enabled);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives the cached blocks of this thread back
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_pool_flush_thread_cache();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a block from the pool
+  @param    pool    The pool
+  @return   The block else NULL
+
+  Adds a page when no block is free. The block is not cleared.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_pool_alloc(Splash_pool *pool);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives a block back to the pool
+  @param    pool    The pool the block came from
+  @param    block   The block, NULL is ignored
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_pool_free(Splash_pool *pool, void *block);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives every block back to the pool
+  @param    pool    The pool
+  @return   Void
+
+  Frees all blocks at once without finding them first, the pages are
+  kept for reuse. Nothing taken from the pool may be used after.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_pool_free_all(Splash_pool *pool);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of blocks in use
+  @param    pool    The pool
+  @return   Blocks handed out
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_pool_get_used(Splash_pool *pool);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of blocks in the pages
+  @param    pool    The pool
+  @return   Blocks carved so far
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_pool_get_capacity(Splash_pool *pool);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the pool
+  @param    pool    The pool
+  @return   Void
+
+  Frees every page, blocks still in use are freed with them.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_pool_destroy(Splash_pool *pool);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,329 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_queue.h
+   @author  P. Batty
+   @brief   The queue structs
+
+   This module implements bounded lock free queues for passing pointers
+   between threads. Splash_ring has one producer and one consumer,
+   Splash_queue any number of both.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_QUEUE_H_
+#define SPLASH_QUEUE_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "SDL2/SDL.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define SPLASH_QUEUE_CACHE_LINE 64      /**< bytes kept between indices written by different threads */
+#define SPLASH_QUEUE_WAIT_FOREVER -1    /**< timeout of a wait that never gives up */
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_queue_wait
+
+  Lets threads sleep on a full or empty queue, only touched once a
+  thread has to wait.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_queue_wait {
+  SDL_mutex *lock;                      /**< guards the sleep */
+  SDL_cond *changed;                    /**< signaled after a push or pop */
+  SDL_atomic_t waiters;                 /**< threads waiting */
+} Splash_queue_wait;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_ring
+
+  The single producer single consumer ring. Each side keeps its own index
+  and a copy of the other one on its own cache line.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_ring {
+  void **data;                          /**< the slots */
+  uint32_t mask;                        /**< capacity - 1 */
+  int32_t capacity;                     /**< slots, a power of two */
+  Splash_queue_wait wait;               /**< sleeping producer or consumer */
+  char pad_data[SPLASH_QUEUE_CACHE_LINE];
+
+  SDL_atomic_t tail;                    /**< next slot to push, written by the producer */
+  uint32_t head_cache;                  /**< last head seen by the producer */
+  char pad_tail[SPLASH_QUEUE_CACHE_LINE - sizeof(SDL_atomic_t) - sizeof(uint32_t)];
+
+  SDL_atomic_t head;                    /**< next slot to pop, written by the consumer */
+  uint32_t tail_cache;                  /**< last tail seen by the consumer */
+  char pad_head[SPLASH_QUEUE_CACHE_LINE - sizeof(SDL_atomic_t) - sizeof(uint32_t)];
+} Splash_ring;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_queue_cell
+
+  A slot of the queue, the sequence says which lap it is ready for.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_queue_cell {
+  SDL_atomic_t sequence;                /**< position it can be pushed at, + 1 once full */
+  void *data;                           /**< the item */
+} Splash_queue_cell;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_queue
+
+  The multi producer multi consumer queue. Producers and consumers claim
+  positions with a compare and swap on their own cache line.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_queue {
+  Splash_queue_cell *cells;             /**< the slots */
+  uint32_t mask;                        /**< capacity - 1 */
+  int32_t capacity;                     /**< slots, a power of two */
+  Splash_queue_wait wait;               /**< sleeping producers or consumers */
+  char pad_cells[SPLASH_QUEUE_CACHE_LINE];
+
+  SDL_atomic_t tail;                    /**< next position to push */
+  char pad_tail[SPLASH_QUEUE_CACHE_LINE - sizeof(SDL_atomic_t)];
+
+  SDL_atomic_t head;                    /**< next position to pop */
+  char pad_head[SPLASH_QUEUE_CACHE_LINE - sizeof(SDL_atomic_t)];
+} Splash_queue;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new ring
+  @param    capacity    Most items held, rounded up to a power of two
+  @return   New Splash_ring otherwise NULL.
+
+  Creates a new Splash_ring object destroy with splash_ring_destroy();
+  Only one thread may push and only one thread may pop.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_ring SPLASHCALL *splash_ring_create(int32_t capacity);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item
+  @param    ring      The ring
+  @param    data      The item
+  @return   0 on success else -1 if the ring is full
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_ring_push(Splash_ring *ring, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item
+  @param    ring      The ring
+  @param    data      Set to the item
+  @return   0 on success else -1 if the ring is empty
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_ring_pop(Splash_ring *ring, void **data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items
+  @param    ring      The ring
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+  Pushes as many as fit and publishes them together.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_ring_push_batch(Splash_ring *ring, void **data, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items
+  @param    ring      The ring
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_ring_pop_batch(Splash_ring *ring, void **data, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item, waiting while the ring is full
+  @param    ring      The ring
+  @param    data      The item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_ring_push_wait(Splash_ring *ring, void *data, int32_t timeout);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item, waiting while the ring is empty
+  @param    ring      The ring
+  @param    data      Set to the item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_ring_pop_wait(Splash_ring *ring, void **data, int32_t timeout);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of items
+  @param    ring      The ring
+  @return   Number of items, only a hint while other threads use the ring
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_ring_get_size(Splash_ring *ring);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity
+  @param    ring      The ring
+  @return   Most items held
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_ring_get_capacity(Splash_ring *ring);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the ring
+  @param    ring      The ring
+  @return   Void
+
+  The items are not freed, no thread may be using the ring.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_ring_destroy(Splash_ring *ring);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new queue
+  @param    capacity    Most items held, rounded up to a power of two
+  @return   New Splash_queue otherwise NULL.
+
+  Creates a new Splash_queue object destroy with splash_queue_destroy();
+  Any number of threads may push and pop.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_queue SPLASHCALL *splash_queue_create(int32_t capacity);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item
+  @param    queue     The queue
+  @param    data      The item
+  @return   0 on success else -1 if the queue is full
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_queue_push(Splash_queue *queue, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item
+  @param    queue     The queue
+  @param    data      Set to the item
+  @return   0 on success else -1 if the queue is empty
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_queue_pop(Splash_queue *queue, void **data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items
+  @param    queue     The queue
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+  Claims the free slots in one compare and swap, the items stay together
+  in the queue.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_queue_push_batch(Splash_queue *queue, void **data, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items
+  @param    queue     The queue
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+  Claims the ready slots in one compare and swap.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_queue_pop_batch(Splash_queue *queue, void **data, int32_t count);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item, waiting while the queue is full
+  @param    queue     The queue
+  @param    data      The item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_queue_push_wait(Splash_queue *queue, void *data, int32_t timeout);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item, waiting while the queue is empty
+  @param    queue     The queue
+  @param    data      Set to the item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_queue_pop_wait(Splash_queue *queue, void **data, int32_t timeout);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of items
+  @param    queue     The queue
+  @return   Number of items, only a hint while other threads use the queue
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_queue_get_size(Splash_queue *queue);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity
+  @param    queue     The queue
+  @return   Most items held
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_queue_get_capacity(Splash_queue *queue);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the queue
+  @param    queue     The queue
+  @return   Void
+
+  The items are not freed, no thread may be using the queue.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_queue_destroy(Splash_queue *queue);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,166 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_replay.h
+   @author  P. Batty
+   @brief   The replay log
+
+   This module implements the reading and writing of the binary input
+   logs used to record and replay the state machine.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_REPLAY_H_
+#define SPLASH_REPLAY_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "SDL2/SDL.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define SPLASH_REPLAY_END     0  /**< No more records in the log */
+#define SPLASH_REPLAY_UPDATE  1  /**< An update with its delta */
+#define SPLASH_REPLAY_EVENT   2  /**< An SDL event */
+#define SPLASH_REPLAY_FRAME   3  /**< A rendered frame and its length */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_replay
+
+  An open replay log. Logs store events as raw SDL_Event bytes so they
+  are only portable between machines of the same byte order. Pointers
+  are never stored, drop paths are written out and window manager
+  events are skipped.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_replay {
+  FILE *file;           /**< The log file */
+  int8_t recording;     /**< 1 when writing, 0 when reading */
+  int32_t ticks;        /**< ticks per second the log was recorded at */
+  uint32_t frames;      /**< number of frames written or read */
+  uint32_t skipped;     /**< number of events not written */
+} Splash_replay;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_replay_record
+
+  A single record read back from a log.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_replay_record {
+  uint8_t type;         /**< The record type, SPLASH_REPLAY_* */
+  float delta;          /**< The update delta */
+  uint32_t elapsed;     /**< The frame length in milliseconds */
+  SDL_Event event;      /**< The event */
+} Splash_replay_record;
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new log to record to
+  @param    path    Path to the log file
+  @param    ticks   The ticks per second of the state machine
+  @return   New Splash_replay otherwise NULL.
+
+  Creates a new Splash_replay for writing close with splash_replay_close();
+  return a new object else null if unsuccessful
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_replay SPLASHCALL *splash_replay_record(const char *path, int32_t ticks);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Opens a log to replay
+  @param    path    Path to the log file
+  @return   New Splash_replay otherwise NULL.
+
+  Opens a Splash_replay for reading close with splash_replay_close();
+  return a new object else null if the file is missing or not a log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_replay SPLASHCALL *splash_replay_open(const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an update
+  @param    replay  The log to write to
+  @param    delta   The update delta
+  @return   Void
+
+  Writes an update record to the log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_replay_write_update(Splash_replay *replay, float delta);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an event
+  @param    replay  The log to write to
+  @param    event   The event
+  @return   Void
+
+  Writes an event record to the log, only the part of the event union
+  used by the event type is stored. Drop paths are written out, user
+  event data pointers are cleared and window manager events are skipped
+  and counted in skipped.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_replay_write_event(Splash_replay *replay, SDL_Event *event);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes a frame
+  @param    replay  The log to write to
+  @param    elapsed The frame length in milliseconds
+  @return   Void
+
+  Writes a frame record to the log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_replay_write_frame(Splash_replay *replay, uint32_t elapsed);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reads the next record
+  @param    replay  The log to read from
+  @param    record  The record to fill
+  @return   The record type, SPLASH_REPLAY_END at the end of the log
+
+  Reads the next record from the log, a drop event path is allocated
+  with SDL_malloc as SDL does for live events, free it with SDL_free.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint8_t SPLASHCALL splash_replay_read(Splash_replay *replay, Splash_replay_record *record);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Closes the log
+  @param    replay  The log to close
+  @return   Void
+
+  Flushes and closes the log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_replay_close(Splash_replay *replay);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
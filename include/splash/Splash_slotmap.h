@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_slotmap.h
+   @author  P. Batty
+   @brief   The slot map structs
+
+   This module implements slot maps. Elements are stored packed together
+   for iteration and reached through handles of a slot index and a
+   generation, a handle to a removed element is detected instead of
+   reaching whatever took its place.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_SLOTMAP_H_
+#define SPLASH_SLOTMAP_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_handle
+
+  The generation in the high 32 bits and the slot index in the low 32.
+\----------------------------------------------------------------------------*/
+typedef uint64_t Splash_handle;
+
+#define SPLASH_HANDLE_NULL 0                                      /**< never given out */
+#define SPLASH_HANDLE_INDEX(handle) ((uint32_t)(handle))          /**< slot index of a handle */
+#define SPLASH_HANDLE_GENERATION(handle) ((uint32_t)((handle) >> 32)) /**< generation of a handle */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_slotmap_slot
+
+  A slot, the generation is bumped each time its element is removed.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_slotmap_slot {
+  uint32_t generation;                  /**< generation of the handle in use */
+  int32_t dense;                        /**< position of the element, next free slot when free */
+} Splash_slotmap_slot;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_slotmap
+
+  The slot map, elements are element_size bytes stored by value.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_slotmap {
+  int32_t element_size;                 /**< bytes in an element */
+  char *data;                           /**< the packed elements */
+  uint32_t *dense_slot;                 /**< slot of each packed element */
+  Splash_slotmap_slot *slots;           /**< the slots */
+  int32_t size;                         /**< number of elements */
+  int32_t capacity;                     /**< elements that fit before growing */
+  int32_t slot_count;                   /**< slots made so far */
+  int32_t free_slot;                    /**< first free slot else -1 */
+} Splash_slotmap;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new slot map
+  @param    element_size  Bytes in an element
+  @return   New Splash_slotmap otherwise NULL.
+
+  Creates a new Splash_slotmap object destroy with splash_slotmap_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_slotmap SPLASHCALL *splash_slotmap_create(int32_t element_size);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Inserts an element
+  @param    slotmap   The slot map
+  @param    value     The element to copy in, NULL for a zeroed one
+  @return   The handle of the element else SPLASH_HANDLE_NULL
+
+  O(1) amortized, freed slots are reused with a new generation.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_handle SPLASHCALL splash_slotmap_insert(Splash_slotmap *slotmap, const void *value);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets an element
+  @param    slotmap   The slot map
+  @param    handle    The handle
+  @return   The element else NULL if the handle is stale
+
+  The pointer is valid until the next insert or remove.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_slotmap_get(Splash_slotmap *slotmap, Splash_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes an element
+  @param    slotmap   The slot map
+  @param    handle    The handle
+  @return   1 if removed else 0 if the handle is stale
+
+  The last element is moved into the gap so the elements stay packed.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_slotmap_remove(Splash_slotmap *slotmap, Splash_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of elements
+  @param    slotmap   The slot map
+  @return   Number of elements
+
+  Gets the number of live elements, the packed elements run from 0 to it.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_slotmap_get_size(Splash_slotmap *slotmap);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the packed elements
+  @param    slotmap   The slot map
+  @return   The first element, splash_slotmap_get_size(); follow it
+
+  Gets the elements packed together for iteration, the order changes
+  when an element is removed.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL *splash_slotmap_get_data(Splash_slotmap *slotmap);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the handle of a packed element
+  @param    slotmap   The slot map
+  @param    pos       Position in the packed elements
+  @return   The handle else SPLASH_HANDLE_NULL
+
+  Gets the handle of an element found by walking the packed elements so
+  it can be removed or kept.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_handle SPLASHCALL splash_slotmap_get_handle(Splash_slotmap *slotmap, int32_t pos);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the slot map
+  @param    slotmap   The slot map
+  @return   Void
+
+  Frees the elements and the slots, every handle of the slot map is
+  stale after.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_slotmap_destroy(Splash_slotmap *slotmap);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,146 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_sparse_set.h
+   @author  P. Batty
+   @brief   The sparse set structs
+
+   This module implements sets of integer ids. A sparse array indexed by
+   id points into a dense array of the members, so inserting, removing
+   and membership checks are O(1) and the members can be walked packed.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_SPARSE_SET_H_
+#define SPLASH_SPARSE_SET_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_sparse_set
+
+  The sparse set, the sparse array grows to the largest id inserted.
+\----------------------------------------------------------------------------*/
+typedef struct Splash_sparse_set {
+  uint32_t *dense;                      /**< the members */
+  uint32_t *sparse;                     /**< position of each id in dense */
+  int32_t size;                         /**< number of members */
+  int32_t dense_capacity;               /**< members that fit before growing */
+  uint32_t sparse_capacity;             /**< ids that fit before growing */
+} Splash_sparse_set;
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new sparse set
+  @return   New Splash_sparse_set otherwise NULL.
+
+  Creates a new Splash_sparse_set object destroy with splash_sparse_set_destroy();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_sparse_set SPLASHCALL *splash_sparse_set_create();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Inserts an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if inserted, 0 if already a member else -1
+
+  The sparse array is sized by the largest id, keep ids small and dense.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_sparse_set_insert(Splash_sparse_set *set, uint32_t id);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if removed else 0 if it was not a member
+
+  The last member is moved into the gap.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_sparse_set_remove(Splash_sparse_set *set, uint32_t id);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks for an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if a member else 0
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_sparse_set_contains(Splash_sparse_set *set, uint32_t id);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the position of an id
+  @param    set     The set
+  @param    id      The id
+  @return   Position in splash_sparse_set_get_data(); else -1
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_sparse_set_get_position(Splash_sparse_set *set, uint32_t id);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the members
+  @param    set     The set
+  @return   The first member, splash_sparse_set_get_size(); follow it
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint32_t SPLASHCALL *splash_sparse_set_get_data(Splash_sparse_set *set);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of members
+  @param    set     The set
+  @return   Number of members
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_sparse_set_get_size(Splash_sparse_set *set);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes every member
+  @param    set     The set
+  @return   Void
+
+  O(1), the capacity is kept.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_sparse_set_remove_all(Splash_sparse_set *set);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the sparse set
+  @param    set     The set
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_sparse_set_destroy(Splash_sparse_set *set);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
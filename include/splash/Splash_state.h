@@ -18,6 +18,7 @@
  ---------------------------------------------------------------------------*/
 
 #include "SDL2/SDL.h"
+#include "Splash_handle.h"
 #include <stdint.h>
 
 #include "splash_begin_code.h"
@@ -30,6 +31,16 @@ extern "C" {
                                 New types
  ---------------------------------------------------------------------------*/
 
+/*!--------------------------------------------------------------------------
+  @brief    Splash_state_handle
+
+  Compact handle given to a state when it is added to the machine.
+\----------------------------------------------------------------------------*/
+typedef int32_t Splash_state_handle;
+
+#define SPLASH_STATE_INVALID_HANDLE -1 /**< Returned when a state is not found */
+
+
 /*!--------------------------------------------------------------------------
   @brief    Splash_state
 
@@ -37,6 +48,8 @@ extern "C" {
 \----------------------------------------------------------------------------*/
 typedef struct Splash_state {
   char *name;                           /**< The state name */
+  Splash_state_handle handle;           /**< The handle given by splash_state_add */
+  Splash_handle id;                     /**< The object handle, see splash_handle_get */
   void (* init)(char *, void *);        /**< The states initlization function */
   void (* update)(float);               /**< The states update function */
   void (* event)(SDL_Event);            /**< The states event haneler */
@@ -48,6 +61,7 @@ typedef struct Splash_state {
   int l_event;                          /**< lua event refrance */
   int l_render;                         /**< lua render refrance */
   int l_cleanup;                        /**< lua cleanup refrance */
+  int l_object;                         /**< lua refrance keeping the state object alive while added */
 } Splash_state;
 
 
@@ -107,15 +121,28 @@ extern void splash_state_quit();
 extern DLL_EXPORT Splash_state SPLASHCALL *splash_state_create(char *name, void (* init)(char *, void *), void (* update)(float), void (* event)(SDL_Event), void (* render)(), void (* cleanup)(char *) );
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a state
+  @param    state       The state to destroy
+  @return   Void
+
+  Drops the handle of the state and frees it, remove the state from the
+  machine first.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_state_destroy(Splash_state *state);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a state to the machine
   @param    state       The state to add
-  @return   Void
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
 
-  Adds a state to the machine
+  Adds a state to the machine. The name is interned by the machine, adding
+  a state with a name that was used before gives back the same handle.
 
 \-----------------------------------------------------------------------------*/
-extern DLL_EXPORT void SPLASHCALL splash_state_add(Splash_state *state);
+extern DLL_EXPORT Splash_state_handle SPLASHCALL splash_state_add(Splash_state *state);
 
 
 /*!--------------------------------------------------------------------------
@@ -141,6 +168,18 @@ extern DLL_EXPORT void SPLASHCALL splash_state_remove(char *state_name);
 extern DLL_EXPORT void SPLASHCALL splash_state_start(char *state_name, void *data);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Starts the splash state
+  @param    handle      The state handle to start with
+  @param    data        Any data to pass in to the init
+  @return   Void
+
+  Starts the splash state machine without looking up the state name
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_state_start_handle(Splash_state_handle handle, void *data);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Switchs the current state
   @param    state_name  The state name to switch to
@@ -153,6 +192,18 @@ extern DLL_EXPORT void SPLASHCALL splash_state_start(char *state_name, void *dat
 extern DLL_EXPORT void SPLASHCALL splash_state_switch(char *state_name, void *data);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Switchs the current state
+  @param    handle      The state handle to switch to
+  @param    data        Any data to pass in to the init
+  @return   Void
+
+  Switches the state machine without looking up the state name
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_state_switch_handle(Splash_state_handle handle, void *data);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Stops the splash state
   @return   Void
@@ -183,6 +234,100 @@ extern DLL_EXPORT void SPLASHCALL splash_state_set_ticks(int32_t ticks);
 extern DLL_EXPORT Splash_state SPLASHCALL *splash_state_get_state(char *state_name);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets a state
+  @param    handle      The state handle
+  @return   Splash_state object else NULL
+
+  Gets the splash state tied to the handle else returns NULL
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_state SPLASHCALL *splash_state_get_state_handle(Splash_state_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a state handle
+  @param    state_name  The state name
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Looks up the handle for the state name, names are compared by content.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_state_handle SPLASHCALL splash_state_get_handle(char *state_name);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Records the state machine
+  @param    path    Path to the log file
+  @return   0 on success else -1
+
+  Records every update, event and frame of the next run to the log. The
+  recording stops when the state machine stops.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_state_record(const char *path);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops recording
+  @return   Void
+
+  Stops recording and closes the log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_state_record_stop();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Replays a log
+  @param    path        Path to the log file
+  @param    state_name  The state name to start with
+  @param    data        Any data to pass in to the init
+  @param    speed       Replay speed, 1 is real time, 0 or less is as fast as possible
+  @return   0 on success else -1
+
+  Drives the states from a recorded log without a window, render is not
+  called.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_state_replay(const char *path, char *state_name, void *data, float speed);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Begins a frame stepped replay
+  @param    path        Path to the log file
+  @param    state_name  The state name to start with
+  @param    data        Any data to pass in to the init
+  @return   0 on success else -1
+
+  Opens the log and enters the first state, step through the log with
+  splash_state_replay_step(); and finish with splash_state_replay_end();
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_state_replay_begin(const char *path, char *state_name, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Replays one frame
+  @return   1 if a frame was replayed else 0
+
+  Replays the updates and events of the next recorded frame, returns 0
+  once the log ends or the state machine stops.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_state_replay_step();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Ends a replay
+  @return   Void
+
+  Stops the state machine if the log did not and closes the log
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_state_replay_end();
+
+
 /*!--------------------------------------------------------------------------
   @brief    Gets the state macine uptime
   @return   Current state machine uptime
@@ -223,6 +368,38 @@ extern DLL_EXPORT int32_t SPLASHCALL splash_state_get_fps();
 extern DLL_EXPORT int32_t SPLASHCALL splash_state_get_ticks();
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets the state machine clock
+  @return   State machine time in milliseconds
+
+  The clock advances by one tick every update, so it follows the recorded
+  updates during a replay.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint32_t SPLASHCALL splash_state_get_clock();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the current state handle
+  @return   The current state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Gets the handle of the current state
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_state_handle SPLASHCALL splash_state_get_current_handle();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the current state
+  @return   The current state else NULL
+
+  Gets the current state, it is still current after being removed until
+  the machine switches away from it
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_state SPLASHCALL *splash_state_get_current();
+
+
 /* end C definitions */
 #ifdef __cplusplus
 }
@@ -18,6 +18,8 @@
  ---------------------------------------------------------------------------*/
 
 #include "GL/glew.h"
+#include "SDL2/SDL.h"
+#include "Splash_handle.h"
 #include <stdint.h>
 
 #include "splash_begin_code.h"
@@ -39,6 +41,7 @@ typedef struct Splash_texture {
   GLuint  texture;        /**< The texture */
   int32_t texture_width;  /**< The texture width */
   int32_t texture_height; /**< The texture height */
+  Splash_handle id;       /**< The handle of the texture, see splash_handle_get */
 } Splash_texture;
 
 
@@ -58,6 +61,17 @@ typedef struct Splash_texture {
 extern DLL_EXPORT Splash_texture SPLASHCALL *splash_texture_create(char *path);
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets the texture size
+  @param  texture      The texture to get
+  @return  The texture size inside a point
+
+  Gets the texture size
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT SDL_Point SPLASHCALL splash_texture_get_size(Splash_texture *texture);
+
+
 /*!--------------------------------------------------------------------------
   @brief    Destroy's the texture
   @param  texture      The texture to destroy
@@ -0,0 +1,185 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_timer.h
+   @author  P. Batty
+   @brief   The timers
+
+   This module implements the delayed and repeating timers driven by the
+   state machine clock.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef SPLASH_TIMER_H_
+#define SPLASH_TIMER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash_state.h"
+#include <stdint.h>
+
+#include "splash_begin_code.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_timer_handle
+
+  Handle to a timer, stays invalid once the timer is done or cancelled.
+\----------------------------------------------------------------------------*/
+typedef uint32_t Splash_timer_handle;
+
+#define SPLASH_TIMER_INVALID_HANDLE 0 /**< Never given to a timer */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Splash_timer_callback
+
+  Called when a timer expires with the timer handle and its data.
+\----------------------------------------------------------------------------*/
+typedef void (* Splash_timer_callback)(Splash_timer_handle, void *);
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Inits Splash timer
+  @return   0 on success else -1
+
+  Inits the splash timers
+
+\-----------------------------------------------------------------------------*/
+extern int8_t splash_timer_init();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Quits Splash timer
+  @return   Void
+
+  Cancels every timer and quits the splash timers
+
+\-----------------------------------------------------------------------------*/
+extern void splash_timer_quit();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a one shot timer
+  @param    delay     Milliseconds of state machine time before it fires
+  @param    callback  The function to call
+  @param    data      Any data to pass to the callback
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that fires once. Timers belong to the current state and
+  are cancelled when that state is cleaned up.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_timer_handle SPLASHCALL splash_timer_after(uint32_t delay, Splash_timer_callback callback, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a repeating timer
+  @param    interval  Milliseconds of state machine time between calls
+  @param    callback  The function to call
+  @param    data      Any data to pass to the callback
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that fires every interval until cancelled. Timers belong
+  to the current state and are cancelled when that state is cleaned up.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT Splash_timer_handle SPLASHCALL splash_timer_every(uint32_t interval, Splash_timer_callback callback, void *data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a lua timer
+  @param    delay       Milliseconds before it first fires
+  @param    interval    Milliseconds between calls, 0 for a one shot
+  @param    l_callback  lua callback refrance, released with the timer
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that calls back in to lua
+
+\-----------------------------------------------------------------------------*/
+extern Splash_timer_handle splash_timer_lua_create(uint32_t delay, uint32_t interval, int l_callback);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels a timer
+  @param    handle    The timer to cancel
+  @return   1 if the timer was cancelled else 0
+
+  Cancels a timer, stale handles are ignored
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_timer_cancel(Splash_timer_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a timer is active
+  @param    handle    The timer to check
+  @return   1 if the timer has not fired or been cancelled else 0
+
+  Checks if a timer is still waiting to fire
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int8_t SPLASHCALL splash_timer_active(Splash_timer_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels the timers of a state
+  @param    state     The state handle
+  @return   Void
+
+  Cancels every timer that belongs to the state
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_timer_clear_state(Splash_state_handle state);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Advances the timers
+  @param    now       The state machine clock in milliseconds
+  @return   Void
+
+  Fires every timer that expires up to and including now, called by the
+  state machine every tick.
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT void SPLASHCALL splash_timer_advance(uint32_t now);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the timer clock
+  @return   The last clock time the timers were advanced to
+
+  Gets the last clock time the timers were advanced to
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT uint32_t SPLASHCALL splash_timer_get_time();
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of active timers
+  @return   Number of active timers
+
+  Gets the number of active timers
+
+\-----------------------------------------------------------------------------*/
+extern DLL_EXPORT int32_t SPLASHCALL splash_timer_get_count();
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
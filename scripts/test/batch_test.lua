@@ -0,0 +1,40 @@
+-- test the batch api
+local positions = splash_batch.buffer(8)
+assert(getmetatable(positions) == "splash.buffer")
+assert(positions:length() == 8)
+assert(positions:get(1) == 0)
+positions:fill(1)
+positions:set(8, 4)
+assert(positions:get(8) == 4)
+assert(not pcall(positions.get, positions, 9))
+
+local velocities = splash_batch.buffer({1, 2, 3, 4, 5, 6, 7, 8})
+assert(velocities:length() == 8)
+splash_batch.integrate(positions, velocities, 0.5)
+assert(positions:get(1) == 1.5 and positions:get(8) == 8)
+
+positions:load({0, 0, 10, 10, 20, 20, 30, 30})
+positions:translate(5, -5)
+local values = positions:toTable()
+assert(#values == 8 and values[1] == 5 and values[2] == -5)
+
+local visible = {9, 9, 9, 9}
+assert(splash_batch.cull(positions, 0, 0, 20, 20, visible) == 1)
+assert(visible[1] == 2 and visible[2] == nil)
+local indices = splash_batch.buffer(4)
+assert(positions:cull(0, -10, 40, 40, indices) == 4)
+assert(indices:get(4) == 4)
+assert(positions:cull(100, 100, 200, 200) == 0)
+
+positions:clamp(0, 0, 15, 15)
+assert(positions:get(1) == 5 and positions:get(2) == 0 and positions:get(7) == 15)
+
+-- flat arrays are updated in place
+local flat = {0, 0, 1, 1}
+splash_batch.integrate(flat, {2, 2, 2, 2}, 1)
+splash_batch.translate(flat, 1, 1)
+assert(flat[1] == 3 and flat[4] == 4)
+
+assert(not pcall(splash_batch.integrate, positions, positions, 1))
+positions:destroy()
+assert(not pcall(positions.length, positions))
@@ -1,6 +1,7 @@
 -- test the camera api
 local camera = splash_camera.orthoCreate()
-assert(camera != nil)
+assert(camera ~= nil)
+assert(getmetatable(camera) == "splash.camera")
 splash_camera.setPosition(camera, 0, 0, 0)
 splash_camera.setSize(camera, 800, 600)
 splash_camera.setZoom(camera, 12)
@@ -8,8 +9,16 @@ splash_camera.setRotation(camera, 0, 0, 0)
 splash_camera.translate(camera, 0, 0, 0)
 splash_camera.zoom(camera, 0)
 splash_camera.rotate(camera, 0, 0, 0)
-local pos = splash_camera.getPosition(camera)
-local rot = splash_camera.getRotation(camera)
-local size = splash_camera.getSize(camera)
+local x, y, z = splash_camera.getPosition(camera)
+assert(x == 0 and y == 0 and z == 0)
+local yaw, pitch, roll = splash_camera.getRotation(camera)
+local w, h = splash_camera.getSize(camera)
+assert(w == 800 and h == 600)
 local zoom = splash_camera.getZoom(camera)
-splash_camera.destory(camera)
\ No newline at end of file
+camera:setZoom(2)
+assert(camera:getZoom() == splash_camera.getZoom(camera))
+assert(not pcall(splash_camera.getZoom, {}))
+splash_camera.destroy(camera)
+assert(not pcall(camera.getZoom, camera))
+splash_camera.orthoCreate()
+collectgarbage()
@@ -0,0 +1,28 @@
+-- test the profiler api
+local function busy()
+	local sum = 0
+	for i = 1, 100000 do
+		sum = sum + i % 7
+	end
+	return sum
+end
+
+splash_profiler.clear()
+splash_profiler.start(100)
+assert(splash_profiler.running())
+busy()
+splash_profiler.stop()
+assert(not splash_profiler.running())
+assert(splash_profiler.getSamples() > 0)
+assert(splash_profiler.write("profiler_test.folded"))
+
+local found = false
+for line in io.lines("profiler_test.folded") do
+	if line:find("busy", 1, true) then
+		found = true
+	end
+end
+os.remove("profiler_test.folded")
+assert(found)
+splash_profiler.clear()
+assert(splash_profiler.getSamples() == 0)
@@ -0,0 +1,24 @@
+-- test the reload api
+assert(not splash_reload.isReloading())
+
+local data = splash_reload.persist("reload_test", {count = 1})
+assert(data.count == 1)
+data.count = 2
+assert(splash_reload.persist("reload_test", {count = 1}).count == 2)
+
+local fresh = splash_reload.persist("reload_test_fresh")
+assert(type(fresh) == "table")
+assert(splash_reload.persist("reload_test_fresh") == fresh)
+
+local path = "reload_test_module.lua"
+local function write(version)
+	local file = assert(io.open(path, "w"))
+	file:write("return {version = " .. version .. ", get = function() return " .. version .. " end}\n")
+	file:close()
+end
+
+write(1)
+assert(splash_reload.watch(path))
+write(2)
+assert(splash_reload.reload(path))
+os.remove(path)
@@ -7,8 +7,24 @@ function update(delta)
 	splash_state.stop()
 end
 
-function events(e)
+local key
+local mouse_x
+local mouse_y
+local first_event
+local kept_event
 
+function events(e)
+	if e.type == splash_event.KEYDOWN then
+		key = e.key
+		assert(e.x == nil)
+	elseif e.type == splash_event.MOUSEMOTION then
+		mouse_x = e.x
+		mouse_y = e.y
+	end
+	if first_event == nil then
+		first_event = e
+		kept_event = e:copy()
+	end
 end
 
 function render()
@@ -20,8 +36,38 @@ function cleanup(state)
 end
 
 local state = splash_state.create("Test State", init, update, events, render, cleanup)
-splash_state.add(state)
+local handle = splash_state.add(state)
 splash_state.remove("Test State")
-splash_state.add(state)
-splash_state.start("Test State", "")
-splash_state.switch("Test State", "")
\ No newline at end of file
+assert(splash_state.add(state) == handle)
+assert(splash_state.getHandle("Test " .. "State") == handle)
+assert(getmetatable(state) == "splash.state")
+assert(state:getName() == "Test State" and state:getHandle() == handle)
+assert(splash_state.getState("Test State") == state)
+splash_state.startHandle(handle, "")
+
+assert(key == string.byte("a"))
+assert(mouse_x == 10 and mouse_y == 20)
+assert(getmetatable(kept_event) == "splash.event")
+assert(kept_event.type == splash_event.KEYDOWN and kept_event.key == string.byte("a"))
+local ok, err = pcall(function() return first_event.type end)
+assert(not ok and string.find(err, "expired"))
+splash_state.switch("Test State", "")
+
+-- a removed current state is let go once the machine switches away
+local collected = setmetatable({}, {__mode = "v"})
+
+local function stop_update(delta)
+	splash_state.stop()
+end
+
+local function remove_update(delta)
+	splash_state.remove("Removed State")
+	splash_state.switch("Next State", "")
+end
+
+collected[1] = splash_state.create("Removed State", init, remove_update, events, render, cleanup)
+splash_state.add(collected[1])
+splash_state.add(splash_state.create("Next State", init, stop_update, events, render, cleanup))
+splash_state.start("Removed State", "")
+collectgarbage()
+assert(collected[1] == nil)
@@ -0,0 +1,71 @@
+-- test the task api
+local ticks = 0
+local order = {}
+local ready = false
+local sleeper
+local yielded = false
+
+function init(state, data)
+	splash_task.spawn(function(name)
+		table.insert(order, name)
+		splash_task.waitFrames(3)
+		table.insert(order, "frames")
+		ready = true
+	end, "spawned")
+
+	splash_task.spawn(function()
+		splash_task.waitUntil(function() return ready end)
+		table.insert(order, "until")
+		splash_task.wait(0.05)
+		table.insert(order, "wait")
+	end)
+
+	splash_task.spawn(function()
+		coroutine.yield()
+		yielded = true
+	end)
+
+	sleeper = splash_task.spawn(function()
+		splash_task.wait(1000)
+		table.insert(order, "never")
+	end)
+
+	for i = 1, 1000 do
+		splash_task.spawn(function() splash_task.wait(60 + i) end)
+	end
+end
+
+function update(delta)
+	ticks = ticks + 1
+	if ticks == 20 then
+		splash_state.stop()
+	end
+end
+
+function events(e)
+
+end
+
+function render()
+
+end
+
+function cleanup(state)
+
+end
+
+assert(not pcall(splash_task.wait, 1))
+
+local state = splash_state.create("Task State", init, update, events, render, cleanup)
+splash_state.add(state)
+splash_state.start("Task State", "")
+
+assert(ticks == 20)
+assert(yielded)
+assert(#order == 4)
+assert(order[1] == "spawned" and order[2] == "frames" and order[3] == "until" and order[4] == "wait")
+assert(splash_task.active(sleeper))
+assert(splash_task.cancel(sleeper))
+assert(not splash_task.active(sleeper))
+assert(not splash_task.cancel(sleeper))
+assert(splash_task.getCount() == 1000)
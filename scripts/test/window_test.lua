@@ -9,10 +9,16 @@ splash_window.setVisible(window, false)
 splash_window.setVisible(window, true)
 splash_window.setResizable(window, true)
 assert(splash_window.getTitle(window) == "New Title","Error setting Title");
-local pos = splash_window.getPosition(window)
-assert(pos["x"] == 100, "Failed to get x position");
-assert(pos["y"] == 100, "Failed to get y position");
-local size = splash_window.getSize(window)
-assert(size["w"] == 800, "Failed to get width");
-assert(size["h"] == 600, "Failed to get hight");
-splash_window.destroy(window)
\ No newline at end of file
+local x, y = splash_window.getPosition(window)
+assert(x == 100, "Failed to get x position");
+assert(y == 100, "Failed to get y position");
+local w, h = splash_window.getSize(window)
+assert(w == 800, "Failed to get width");
+assert(h == 600, "Failed to get hight");
+assert(getmetatable(window) == "splash.window")
+assert(window:getTitle() == "New Title")
+window:setTitle("Method Title")
+assert(splash_window.getTitle(window) == "Method Title")
+assert(not pcall(splash_window.getTitle, splash_camera.orthoCreate()))
+splash_window.destroy(window)
+assert(not pcall(window.getTitle, window))
\ No newline at end of file
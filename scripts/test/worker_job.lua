@@ -0,0 +1,23 @@
+-- job function of the worker tests
+return function(op, value)
+	if op == "echo" then
+		return value
+	elseif op == "sum" then
+		local sum = 0
+		for i = 1, value do
+			sum = sum + i
+		end
+		return sum
+	elseif op == "table" then
+		local count = 0
+		for k in pairs(value) do
+			count = count + 1
+		end
+		return count, value.name, value.nested.x, value[1]
+	elseif op == "globals" then
+		return splash_camera ~= nil, splash_state ~= nil
+	elseif op == "function" then
+		return print
+	end
+	error("job failed")
+end
@@ -0,0 +1,31 @@
+-- test the worker api
+local worker = splash_worker.create("../scripts/test/worker_job.lua")
+assert(getmetatable(worker) == "splash.worker")
+
+-- only the bindings without global state are registered
+worker:post("globals")
+local ok, camera, state = worker:wait()
+assert(ok and camera and not state)
+
+worker:post("sum", 100)
+worker:post("table", {"first", name = "worker", nested = {x = 1.5}})
+worker:post("fail")
+assert(worker:pending() == 3)
+
+local ok, sum = worker:wait()
+assert(ok and sum == 5050)
+local ok, count, name, x, first = worker:wait()
+assert(ok and count == 3 and name == "worker" and x == 1.5 and first == "first")
+local ok, message = worker:wait()
+assert(not ok and message:find("job failed", 1, true))
+assert(worker:pending() == 0)
+assert(worker:poll() == nil)
+
+assert(not pcall(worker.post, worker, "echo", print))
+worker:post("function")
+local ok, message = worker:wait()
+assert(not ok)
+
+worker:destroy()
+assert(not pcall(worker.pending, worker))
+assert(splash_worker.create("../scripts/test/missing.lua") == nil)
@@ -20,6 +20,7 @@
 #include "SDL2/SDL_ttf.h"
 #include "GL/glew.h"
 #include "Splash/Splash_lua_wrapper.h"
+#include "Splash/Splash_lua_memory.h"
 #include "lua/lua.h"
 
 /*---------------------------------------------------------------------------
@@ -83,7 +84,11 @@ int8_t splash_init() {
 		SDL_GL_DeleteContext(fake_context);
 		SDL_DestroyWindow(fake_window);
 
-		splash_lua_state = luaL_newstate();
+		splash_lua_state = splash_lua_newstate();
+		if (splash_lua_state == NULL) {
+			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Lua", "FATAL: Could not start Lua!", NULL);
+			return -1;
+		}
 		luaL_openlibs(splash_lua_state);
 		splash_lua_register_all(splash_lua_state);
 
@@ -102,7 +107,10 @@ int8_t splash_init() {
 \-----------------------------------------------------------------------------*/
 int8_t splash_quit() {
 	splash_state_quit();
- 	lua_close(splash_lua_state);
+	splash_lua_unwatch_all();
+ 	splash_lua_close(splash_lua_state);
+	splash_lua_state = NULL;
+	splash_handle_quit();
 	Mix_Quit();
 	TTF_Quit();
 	IMG_Quit();
@@ -0,0 +1,272 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_array.c
+   @author  P. Batty
+   @brief   The array structs
+
+   This module implements the creation and manipulations of the
+   array structs in the framework. The elements are kept in one block
+   that grows as needed.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_array.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define INITIAL_CAPACITY 16   /**< elements of the first block */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Grows the array to hold a number of elements
+  @param    array   The array
+  @param    count   Elements needed
+  @return   0 on success else -1
+
+  Doubles the capacity until it fits.
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow(Splash_array *array, int32_t count) {
+  int32_t capacity = array->capacity ? array->capacity : INITIAL_CAPACITY;
+
+  if (count <= array->capacity) {
+    return 0;
+  }
+
+  while (capacity < count) {
+    if (capacity > INT32_MAX / 2) {
+      capacity = count;
+      break;
+    }
+    capacity <<= 1;
+  }
+
+  void **data = realloc(array->data, (size_t)capacity * sizeof(void *));
+  if (data == NULL) {
+    return -1;
+  }
+
+  array->data = data;
+  array->capacity = capacity;
+ return 0;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new Splash_array
+  @return   New Splash_array otherwise NULL.
+
+  Creates a new Splash_array object destroy with splash_array_destroy();
+  Nothing is allocated for the elements until the first one is added.
+
+\-----------------------------------------------------------------------------*/
+Splash_array *splash_array_create() {
+  Splash_array *array = malloc(sizeof(Splash_array));
+
+  if (!array) {
+    return NULL;
+  }
+
+  array->data = NULL;
+  array->size = 0;
+  array->capacity = 0;
+ return array;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a item to the end of the array
+  @param    array     The array to add to
+  @param    data      The data to add
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_array_push(Splash_array *array, void *data) {
+  if (array->size == array->capacity && grow(array, array->size + 1) == -1) {
+    return -1;
+  }
+
+  array->data[array->size++] = data;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds many items to the end of the array
+  @param    array     The array to add to
+  @param    data      The items to add
+  @param    count     Number of items
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_array_append(Splash_array *array, void **data, int32_t count) {
+  if (count <= 0) {
+    return 0;
+  }
+
+  if (count > INT32_MAX - array->size || grow(array, array->size + count) == -1) {
+    return -1;
+  }
+
+  memcpy(array->data + array->size, data, (size_t)count * sizeof(void *));
+  array->size += count;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the last item
+  @param    array     The array
+  @return   The removed item, -1 if the array is empty
+
+\-----------------------------------------------------------------------------*/
+void *splash_array_pop(Splash_array *array) {
+  if (array->size == 0) {
+    return (void *)-1;
+  }
+ return array->data[--array->size];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the element at the given position
+  @param    array     The array
+  @param    pos       The position to get
+  @return   Data at the position, -1 if not found
+
+\-----------------------------------------------------------------------------*/
+void *splash_array_get(Splash_array *array, int32_t pos) {
+  if (pos < 0 || pos >= array->size) {
+    return (void *)-1;
+  }
+ return array->data[pos];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the element at the given position
+  @param    array     The array
+  @param    pos       The position to set
+  @param    data      The data
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_array_set(Splash_array *array, int32_t pos, void *data) {
+  if (pos < 0 || pos >= array->size) {
+    return;
+  }
+  array->data[pos] = data;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the position of the data in the array
+  @param    array     The array
+  @param    data      The data to search for
+  @return   Position of the data, -1 if not found
+
+  Performs a liniar search on the array.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_array_get_position(Splash_array *array, void *data) {
+  int32_t i;
+
+  for (i = 0; i < array->size; i++) {
+    if (array->data[i] == data) {
+      return i;
+    }
+  }
+ return -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the data at a position
+  @param    array     The array
+  @param    pos       The position to remove
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_array_remove_position(Splash_array *array, int32_t pos) {
+  if (pos < 0 || pos >= array->size) {
+    return;
+  }
+
+  memmove(array->data + pos, array->data + pos + 1, (size_t)(array->size - pos - 1) * sizeof(void *));
+  array->size--;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the data at a position without keeping the order
+  @param    array     The array
+  @param    pos       The position to remove
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_array_swap_remove(Splash_array *array, int32_t pos) {
+  if (pos < 0 || pos >= array->size) {
+    return;
+  }
+
+  array->data[pos] = array->data[--array->size];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes room for a number of elements
+  @param    array     The array
+  @param    count     Elements to hold without growing
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_array_reserve(Splash_array *array, int32_t count) {
+ return grow(array, count);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes everything in the array
+  @param    array     The array to empty
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_array_remove_all(Splash_array *array) {
+  array->size = 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the size of the array
+  @param    array     The array
+  @return   Number of elements
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_array_get_size(Splash_array *array) {
+ return array->size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the array
+  @param    array     The array to destroy
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_array_destroy(Splash_array *array) {
+  free(array->data);
+  free(array);
+}
@@ -0,0 +1,402 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_bitset.c
+   @author  P. Batty
+   @brief   The bitset structs
+
+   This module implements growable sets of bits stored in 64 bit words.
+   Whole set operations work a word, or with SSE2 two words, at a time.
+
+   Words are allocated in pairs so the SSE2 loops never need a tail, and
+   the bits past the size are kept clear so counts and and/or/andnot do
+   not have to mask the last word.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_bitset.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPLASH_BITSET_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define WORD_BITS 64    /**< bits in a word */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the words needed for a number of bits
+  @param    size  Number of bits
+  @return   Number of words, rounded up to a pair
+
+\-----------------------------------------------------------------------------*/
+static int32_t words_for(int32_t size) {
+  int32_t words = (int32_t)(((int64_t)size + WORD_BITS - 1) / WORD_BITS);
+ return (words + 1) & ~1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Counts the set bits of a word
+  @param    word  The word
+  @return   Number of set bits
+
+\-----------------------------------------------------------------------------*/
+static int32_t popcount(uint64_t word) {
+#if defined(__GNUC__)
+ return __builtin_popcountll(word);
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+ return (int32_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the index of the lowest set bit
+  @param    word  Non zero word
+  @return   The index
+
+\-----------------------------------------------------------------------------*/
+static int32_t lowest_bit(uint64_t word) {
+#if defined(__GNUC__)
+ return __builtin_ctzll(word);
+#else
+  int32_t i = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    i++;
+  }
+ return i;
+#endif
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears the bits past the size in the last word
+  @param    bitset  The bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void trim(Splash_bitset *bitset) {
+  int32_t used = bitset->size / WORD_BITS;
+  int32_t extra = bitset->size % WORD_BITS;
+
+  if (extra != 0) {
+    bitset->words[used] &= (1ULL << extra) - 1;
+    used++;
+  }
+  if (used < bitset->word_count) {
+    memset(bitset->words + used, 0, (size_t)(bitset->word_count - used) * sizeof(uint64_t));
+  }
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new bitset
+  @param    size    Number of bits, all clear
+  @return   New Splash_bitset otherwise NULL.
+
+  Creates a new Splash_bitset object destroy with splash_bitset_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_bitset *splash_bitset_create(int32_t size) {
+  Splash_bitset *bitset = malloc(sizeof(Splash_bitset));
+
+  if (!bitset) {
+    return NULL;
+  }
+
+  bitset->words = NULL;
+  bitset->size = 0;
+  bitset->word_count = 0;
+
+  if (splash_bitset_resize(bitset, size) == -1) {
+    free(bitset);
+    return NULL;
+  }
+ return bitset;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Resizes the bitset
+  @param    bitset  The bitset
+  @param    size    Number of bits
+  @return   0 on success else -1
+
+  Grows the words by at least double so setting bits one past the end
+  is O(1) amortized, shrinking keeps the words.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_bitset_resize(Splash_bitset *bitset, int32_t size) {
+  if (size < 0) {
+    return -1;
+  }
+
+  int32_t words = words_for(size);
+
+  if (words > bitset->word_count) {
+    if (words < bitset->word_count * 2) {
+      words = bitset->word_count * 2;
+    }
+
+    uint64_t *data = realloc(bitset->words, (size_t)words * sizeof(uint64_t));
+    if (data == NULL) {
+      return -1;
+    }
+
+    memset(data + bitset->word_count, 0, (size_t)(words - bitset->word_count) * sizeof(uint64_t));
+    bitset->words = data;
+    bitset->word_count = words;
+  }
+
+  bitset->size = size;
+  trim(bitset);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets a bit
+  @param    bitset  The bitset
+  @param    bit     The bit, the bitset grows to hold it
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_bitset_set(Splash_bitset *bitset, int32_t bit) {
+  if (bit < 0 || bit == INT32_MAX) {
+    return -1;
+  }
+
+  if (bit >= bitset->size && splash_bitset_resize(bitset, bit + 1) == -1) {
+    return -1;
+  }
+
+  bitset->words[bit / WORD_BITS] |= 1ULL << (bit % WORD_BITS);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears a bit
+  @param    bitset  The bitset
+  @param    bit     The bit
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_bitset_clear(Splash_bitset *bitset, int32_t bit) {
+  if (bit < 0 || bit >= bitset->size) {
+    return;
+  }
+  bitset->words[bit / WORD_BITS] &= ~(1ULL << (bit % WORD_BITS));
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Tests a bit
+  @param    bitset  The bitset
+  @param    bit     The bit
+  @return   1 if set else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_bitset_test(Splash_bitset *bitset, int32_t bit) {
+  if (bit < 0 || bit >= bitset->size) {
+    return 0;
+  }
+ return (bitset->words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears every bit
+  @param    bitset  The bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_bitset_clear_all(Splash_bitset *bitset) {
+  if (bitset->word_count > 0) {
+    memset(bitset->words, 0, (size_t)bitset->word_count * sizeof(uint64_t));
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Counts the set bits
+  @param    bitset  The bitset
+  @return   Number of set bits
+
+  Four counters break the dependency between words.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_bitset_count(Splash_bitset *bitset) {
+  int32_t counts[4] = {0, 0, 0, 0};
+  int32_t i = 0;
+
+  for (; i + 4 <= bitset->word_count; i += 4) {
+    counts[0] += popcount(bitset->words[i]);
+    counts[1] += popcount(bitset->words[i + 1]);
+    counts[2] += popcount(bitset->words[i + 2]);
+    counts[3] += popcount(bitset->words[i + 3]);
+  }
+  for (; i < bitset->word_count; i++) {
+    counts[0] += popcount(bitset->words[i]);
+  }
+ return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Keeps the bits also set in another bitset
+  @param    bitset  The bitset to change
+  @param    other   The other bitset
+  @return   Void
+
+  Words past the end of the other bitset are cleared.
+
+\-----------------------------------------------------------------------------*/
+void splash_bitset_and(Splash_bitset *bitset, Splash_bitset *other) {
+  int32_t count = bitset->word_count < other->word_count ? bitset->word_count : other->word_count;
+  int32_t i;
+
+#if defined(SPLASH_BITSET_SSE2)
+  for (i = 0; i < count; i += 2) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(bitset->words + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(other->words + i));
+    _mm_storeu_si128((__m128i *)(bitset->words + i), _mm_and_si128(a, b));
+  }
+#else
+  for (i = 0; i < count; i++) {
+    bitset->words[i] &= other->words[i];
+  }
+#endif
+
+  if (count < bitset->word_count) {
+    memset(bitset->words + count, 0, (size_t)(bitset->word_count - count) * sizeof(uint64_t));
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds the bits set in another bitset
+  @param    bitset  The bitset to change, grows to the size of the other
+  @param    other   The other bitset
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_bitset_or(Splash_bitset *bitset, Splash_bitset *other) {
+  int32_t count;
+  int32_t i;
+
+  if (other->size > bitset->size && splash_bitset_resize(bitset, other->size) == -1) {
+    return -1;
+  }
+
+  count = words_for(other->size);
+#if defined(SPLASH_BITSET_SSE2)
+  for (i = 0; i < count; i += 2) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(bitset->words + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(other->words + i));
+    _mm_storeu_si128((__m128i *)(bitset->words + i), _mm_or_si128(a, b));
+  }
+#else
+  for (i = 0; i < count; i++) {
+    bitset->words[i] |= other->words[i];
+  }
+#endif
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes the bits set in another bitset
+  @param    bitset  The bitset to change
+  @param    other   The other bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_bitset_andnot(Splash_bitset *bitset, Splash_bitset *other) {
+  int32_t count = bitset->word_count < other->word_count ? bitset->word_count : other->word_count;
+  int32_t i;
+
+#if defined(SPLASH_BITSET_SSE2)
+  for (i = 0; i < count; i += 2) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(bitset->words + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(other->words + i));
+    _mm_storeu_si128((__m128i *)(bitset->words + i), _mm_andnot_si128(b, a));
+  }
+#else
+  for (i = 0; i < count; i++) {
+    bitset->words[i] &= ~other->words[i];
+  }
+#endif
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the next set bit
+  @param    bitset  The bitset
+  @param    bit     The bit to start at
+  @return   The first set bit at or after it else -1
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_bitset_next(Splash_bitset *bitset, int32_t bit) {
+  int32_t i;
+
+  if (bit < 0) {
+    bit = 0;
+  }
+  if (bit >= bitset->size) {
+    return -1;
+  }
+
+  i = bit / WORD_BITS;
+  uint64_t word = bitset->words[i] & (~0ULL << (bit % WORD_BITS));
+  while (word == 0) {
+    if (++i >= bitset->word_count) {
+      return -1;
+    }
+    word = bitset->words[i];
+  }
+ return i * WORD_BITS + lowest_bit(word);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of bits
+  @param    bitset  The bitset
+  @return   Number of bits
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_bitset_get_size(Splash_bitset *bitset) {
+ return bitset->size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the bitset
+  @param    bitset  The bitset
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_bitset_destroy(Splash_bitset *bitset) {
+  free(bitset->words);
+  free(bitset);
+}
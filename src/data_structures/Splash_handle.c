@@ -0,0 +1,195 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_handle.c
+   @author  P. Batty
+   @brief   The object handles
+
+   This module implements the handles of the Splash objects. Textures,
+   cameras and states are given a handle when made and drop it when
+   destroyed, so code holding a handle can check the object still exists
+   instead of following a stale pointer.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_handle.h"
+#include "Splash/Splash_slotmap.h"
+#include "Splash/Splash_hashmap.h"
+#include "SDL2/SDL.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+static Splash_slotmap *objects = NULL;    /**< the objects by handle */
+static Splash_hashmap *handles = NULL;    /**< the handles by object, stored as SPLASH_HASHMAP_INT */
+static SDL_SpinLock lock = 0;             /**< guards the maps */
+static uint32_t epoch = 0;                /**< times the maps were freed */
+
+#define EPOCH_STRIDE 0x9E3779B9u          /**< generation offset of each epoch, odd and far from 0 */
+#define EPOCH_OFFSET ((Splash_handle)(uint32_t)(epoch * EPOCH_STRIDE) << 32)  /**< added to slot map handles */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes the maps on first use, the lock must be held
+  @return   0 on success else -1
+
+  The maps are made lazily so objects can be given handles before
+  splash_init(); and again after splash_handle_quit();
+
+\-----------------------------------------------------------------------------*/
+static int8_t create_maps() {
+  if (objects == NULL) {
+    objects = splash_slotmap_create(sizeof(void *));
+  }
+  if (handles == NULL) {
+    handles = splash_hashmap_create_pointer();
+  }
+ return (objects == NULL || handles == NULL) ? -1 : 0;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives an object a handle
+  @param    object    The object
+  @return   The handle else SPLASH_HANDLE_NULL
+
+  An object that already has a handle gets the same one back.
+
+\-----------------------------------------------------------------------------*/
+Splash_handle splash_handle_create(void *object) {
+  Splash_handle handle = SPLASH_HANDLE_NULL;
+
+  if (object == NULL) {
+    return SPLASH_HANDLE_NULL;
+  }
+
+  SDL_AtomicLock(&lock);
+  if (create_maps() == 0) {
+    if (splash_hashmap_get_type(handles, object) == SPLASH_HASHMAP_INT64) {
+      handle = (Splash_handle)splash_hashmap_get_int64(handles, object);
+    } else {
+      handle = splash_slotmap_insert(objects, &object);
+      if (handle != SPLASH_HANDLE_NULL) {
+        handle += EPOCH_OFFSET;
+        splash_hashmap_set_int(handles, object, (int64_t)handle);
+      }
+    }
+  }
+  SDL_AtomicUnlock(&lock);
+ return handle;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the object of a handle
+  @param    handle    The handle
+  @return   The object else NULL if it was destroyed
+
+  Gets the object with one locked lookup, a destroyed object or a stale
+  handle gives NULL rather than a dangling pointer.
+
+\-----------------------------------------------------------------------------*/
+void *splash_handle_get(Splash_handle handle) {
+  void *object = NULL;
+
+  SDL_AtomicLock(&lock);
+  if (objects != NULL) {
+    void **found = splash_slotmap_get(objects, handle - EPOCH_OFFSET);
+    if (found != NULL) {
+      object = *found;
+    }
+  }
+  SDL_AtomicUnlock(&lock);
+ return object;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the handle of an object
+  @param    object    The object
+  @return   The handle else SPLASH_HANDLE_NULL if it has none
+
+  Gets the handle given to an object by splash_handle_create();, used
+  when only the object pointer is at hand.
+
+\-----------------------------------------------------------------------------*/
+Splash_handle splash_handle_find(void *object) {
+  Splash_handle handle = SPLASH_HANDLE_NULL;
+
+  SDL_AtomicLock(&lock);
+  if (handles != NULL && splash_hashmap_get_type(handles, object) == SPLASH_HASHMAP_INT64) {
+    handle = (Splash_handle)splash_hashmap_get_int64(handles, object);
+  }
+  SDL_AtomicUnlock(&lock);
+ return handle;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Drops a handle
+  @param    handle    The handle, stale handles are ignored
+  @return   Void
+
+  Removes the object from the handles, splash_handle_get(); gives NULL
+  for the handle after.
+
+\-----------------------------------------------------------------------------*/
+void splash_handle_destroy(Splash_handle handle) {
+  SDL_AtomicLock(&lock);
+  if (objects != NULL) {
+    void **found = splash_slotmap_get(objects, handle - EPOCH_OFFSET);
+    if (found != NULL) {
+      splash_hashmap_remove(handles, *found);
+      splash_slotmap_remove(objects, handle - EPOCH_OFFSET);
+    }
+  }
+  SDL_AtomicUnlock(&lock);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of live handles
+  @return   Number of objects with a handle
+
+  Gets the number of objects with a handle, objects not destroyed show
+  up here as leaks.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_handle_get_count() {
+ return objects ? splash_slotmap_get_size(objects) : 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees the handles
+  @return   Void
+
+  Frees the maps behind the handles, every handle is stale after. Called
+  by splash_quit(); once lua has destroyed its objects, the maps are made
+  again on the next splash_handle_create(); with a new epoch so handles
+  kept from before never reach the new objects.
+
+\-----------------------------------------------------------------------------*/
+void splash_handle_quit() {
+  SDL_AtomicLock(&lock);
+  epoch++;
+  if (objects != NULL) {
+    splash_slotmap_destroy(objects);
+    objects = NULL;
+  }
+  if (handles != NULL) {
+    splash_hashmap_destory(handles);
+    handles = NULL;
+  }
+  SDL_AtomicUnlock(&lock);
+}
@@ -19,91 +19,376 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPLASH_HASHMAP_SSE2
+#include <emmintrin.h>
+#endif
+
 
 /*---------------------------------------------------------------------------
                             Private functions
  ---------------------------------------------------------------------------*/
 
+#define EMPTY 0x80          /**< control byte of an empty slot, full slots are 0 - 127 */
+#define DELETED 0xfe        /**< control byte of a slot removed from a table being migrated */
+#define INITIAL_SIZE 256    /**< slots of a new hashmap */
+
+
 /*!--------------------------------------------------------------------------
-  @brief    Creates a new hashmap element
-  @return   New hashmap element
+  @brief    Mixes a word
+  @param    x   The word
+  @return   The mixed word
 
-  Creates a new hashmap element
+  Finalizer of splitmix64, every output bit depends on every input bit so
+  the low bits pick the slot and the top 7 bits fill the control byte.
 
 \-----------------------------------------------------------------------------*/
-static struct _Splash_hashmap_element_ *create_element(void *key, void *value) {
-  struct _Splash_hashmap_element_ *element = malloc(sizeof(struct _Splash_hashmap_element_));
-  element->key = key;
-  element->value = value;
-  return element;
+static uint64_t mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+ return x;
 }
 
 
 /*!--------------------------------------------------------------------------
-  @brief    Hashing function
-  @return   Hash
+  @brief    Gets the index of the lowest set bit
+  @param    mask  Non zero mask
+  @return   The index
 
-  Hashes
+\-----------------------------------------------------------------------------*/
+static int lowest_bit(uint32_t mask) {
+#if defined(__GNUC__)
+ return __builtin_ctz(mask);
+#else
+  int i = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    i++;
+  }
+ return i;
+#endif
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Matches a group of control bytes
+  @param    group   The first control byte of the group
+  @param    byte    The control byte to look for
+  @return   Bit i is set when group[i] is the byte
 
 \-----------------------------------------------------------------------------*/
-static int hash(void * key, int size) {
-    char *p = key;
-    int len = strlen(p);
-    int hash = 0;
-    int g;
-    int i;
+static uint32_t group_match(const uint8_t *group, uint8_t byte) {
+#ifdef SPLASH_HASHMAP_SSE2
+  __m128i control = _mm_loadu_si128((const __m128i *)group);
+ return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)byte)));
+#else
+  uint32_t mask = 0;
+  int i;
+  for (i = 0; i < SPLASH_HASHMAP_GROUP; i++) {
+    mask |= (uint32_t)(group[i] == byte) << i;
+  }
+ return mask;
+#endif
+}
 
-    for (i = 0; i < len; i++) {
-        hash = (hash << 4) + p[i];
-        g = hash & 0xf0000000L;
 
-        if (g != 0) {
-            hash ^= g >> 24;
-        }
+/*!--------------------------------------------------------------------------
+  @brief    Finds the empty slots in a group
+  @param    group   The first control byte of the group
+  @return   Bit i is set when group[i] is empty
+
+\-----------------------------------------------------------------------------*/
+static uint32_t group_empty(const uint8_t *group) {
+#ifdef SPLASH_HASHMAP_SSE2
+ return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+  return group_match(group, EMPTY);
+#endif
+}
 
-        hash &= ~g;
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets a control byte
+  @param    control   The control bytes
+  @param    size      Number of slots
+  @param    index     The slot
+  @param    byte      The control byte
+  @return   Void
+
+  Keeps the copy of the first group after the last slot in step so a group
+  can be loaded at any slot.
+
+\-----------------------------------------------------------------------------*/
+static void set_control(uint8_t *control, int32_t size, int32_t index, uint8_t byte) {
+  control[index] = byte;
+  if (index < SPLASH_HASHMAP_GROUP - 1) {
+    control[size + index] = byte;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the slot of a key in a table
+  @param    hashmap   The hashmap
+  @param    control   The control bytes of the table
+  @param    slots     The slots of the table
+  @param    size      Number of slots in the table
+  @param    skip      Slots below this index are ignored
+  @param    key       The key
+  @param    h         Hash of the key
+  @return   The slot else -1
+
+  Slots are probed linearly a group at a time from the home slot, the key
+  can not be past the first empty slot. Only the table being migrated has
+  deleted slots, it is probed past them.
+
+\-----------------------------------------------------------------------------*/
+static int32_t find_in(Splash_hashmap *hashmap, const uint8_t *control, Splash_hashmap_slot *slots, int32_t size, int32_t skip, void *key, uint64_t h) {
+  int32_t mask = size - 1;
+  int32_t position = h & mask;
+  uint8_t byte = h >> 57;
+  int8_t migrating = control != hashmap->control;
+
+  for (;;) {
+    const uint8_t *group = control + position;
+    uint32_t match = group_match(group, byte);
+
+    while (match) {
+      int32_t index = (position + lowest_bit(match)) & mask;
+      Splash_hashmap_slot *slot = &slots[index];
+      if (index >= skip && slot->hash == h && (slot->key == key || (hashmap->equal && hashmap->equal(slot->key, key)))) {
+        return index;
+      }
+      match &= match - 1;
     }
 
-  return hash % size;
+    if (migrating ? group_match(group, EMPTY) : group_empty(group)) {
+      return -1;
+    }
+    position = (position + SPLASH_HASHMAP_GROUP) & mask;
+  }
 }
 
 
 /*!--------------------------------------------------------------------------
-  @brief    Re-Hashing function
+  @brief    Finds the slot of a key
+  @param    hashmap   The hashmap
+  @param    key       The key
+  @param    h         Hash of the key
+  @param    old       Set to 1 if the key is in the table being migrated
+  @return   The slot else -1
+
+\-----------------------------------------------------------------------------*/
+static int32_t find_slot(Splash_hashmap *hashmap, void *key, uint64_t h, int8_t *old) {
+  int32_t index = find_in(hashmap, hashmap->control, hashmap->slots, hashmap->size, 0, key, h);
+
+  *old = 0;
+  if (index == -1 && hashmap->old_control != NULL) {
+    index = find_in(hashmap, hashmap->old_control, hashmap->old_slots, hashmap->old_size, hashmap->migrated, key, h);
+    *old = index != -1;
+  }
+ return index;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores a slot in a table
+  @param    control   The control bytes
+  @param    slots     The slots
+  @param    size      Number of slots
+  @param    slot      The slot to store
   @return   Void
 
-  Re-Hashes
+  Stores the slot in the first empty slot from the home of its hash.
 
 \-----------------------------------------------------------------------------*/
-static void rehash(Splash_hashmap * hashmap) {
-  struct _Splash_hashmap_element_ **current;
-  struct _Splash_hashmap_element_ **buckets;
+static void insert_slot(uint8_t *control, Splash_hashmap_slot *slots, int32_t size, const Splash_hashmap_slot *slot) {
+  int32_t mask = size - 1;
+  int32_t position = slot->hash & mask;
+
+  for (;;) {
+    uint32_t empty = group_empty(control + position);
+    if (empty) {
+      int32_t index = (position + lowest_bit(empty)) & mask;
+      set_control(control, size, index, slot->hash >> 57);
+      slots[index] = *slot;
+      return;
+    }
+    position = (position + SPLASH_HASHMAP_GROUP) & mask;
+  }
+}
 
-  struct _Splash_hashmap_element_ *item;
-  struct _Splash_hashmap_element_ *next;
-  size_t s;
-  size_t size;
-  int i;
-  int index;
 
-  current = hashmap->buckets;
-  s = hashmap->size;
-  size = s << 1;
+/*!--------------------------------------------------------------------------
+  @brief    Allocates the control bytes and slots
+  @param    size      Number of slots
+  @param    control   Receives the control bytes
+  @param    slots     Receives the slots
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t allocate(int32_t size, uint8_t **control, Splash_hashmap_slot **slots) {
+  *control = malloc(size + SPLASH_HASHMAP_GROUP - 1);
+  *slots = malloc(size * sizeof(Splash_hashmap_slot));
+
+  if (*control == NULL || *slots == NULL) {
+    free(*control);
+    free(*slots);
+    return -1;
+  }
+
+  memset(*control, EMPTY, size + SPLASH_HASHMAP_GROUP - 1);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves slots out of the table being migrated
+  @param    hashmap   The hashmap
+  @param    count     Number of old slots to move
+  @return   Void
+
+  Old slots below the migrated index are ignored by lookups rather than
+  cleared, so the probe runs of the slots left stay intact. The old table
+  is freed once every slot is moved.
+
+\-----------------------------------------------------------------------------*/
+static void migrate(Splash_hashmap *hashmap, int32_t count) {
+  while (hashmap->old_control != NULL && count-- > 0) {
+    int32_t i = hashmap->migrated++;
 
-  buckets = calloc(size, sizeof(struct _Splash_hashmap_element_));
+    if (hashmap->old_control[i] < EMPTY) {
+      insert_slot(hashmap->control, hashmap->slots, hashmap->size, &hashmap->old_slots[i]);
+    }
 
-  for (i = 0; i < s; i++) {
-    for (item = current[i]; item != NULL; item = next) {
-      index = hash(item->key, size);
-      next = item->next;
-      item->next = buckets[index];
-      buckets[index] = item;
+    if (hashmap->migrated == hashmap->old_size) {
+      free(hashmap->old_control);
+      free(hashmap->old_slots);
+      hashmap->old_control = NULL;
+      hashmap->old_slots = NULL;
+      hashmap->old_size = 0;
+      hashmap->migrated = 0;
     }
   }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Re-Hashing function
+  @param    hashmap   The hashmap
+  @param    size      The new number of slots
+  @return   0 on success else -1
+
+  Moves the elements using their stored hashes, the keys are not hashed
+  or compared again. In incremental mode the old table is kept and moved
+  a step at a time by the following operations.
+
+\-----------------------------------------------------------------------------*/
+static int8_t rehash(Splash_hashmap *hashmap, int32_t size) {
+  uint8_t *control;
+  Splash_hashmap_slot *slots;
+
+  migrate(hashmap, INT32_MAX);
+  if (allocate(size, &control, &slots) == -1) {
+    return -1;
+  }
 
-  free(hashmap->buckets);
-  hashmap->buckets = buckets;
+  hashmap->old_control = hashmap->control;
+  hashmap->old_slots = hashmap->slots;
+  hashmap->old_size = hashmap->size;
+  hashmap->migrated = 0;
+  hashmap->control = control;
+  hashmap->slots = slots;
   hashmap->size = size;
+
+  if (!hashmap->step) {
+    migrate(hashmap, INT32_MAX);
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the slot of a key
+  @param    hashmap   The hashmap
+  @param    key       The key
+  @return   The slot holding the key else NULL
+
+\-----------------------------------------------------------------------------*/
+static Splash_hashmap_slot *find(Splash_hashmap *hashmap, void *key) {
+  int8_t old;
+  int32_t index;
+
+  migrate(hashmap, hashmap->step);
+  index = find_slot(hashmap, key, hashmap->hash(key), &old);
+
+  if (index == -1) {
+    return NULL;
+  }
+ return &(old ? hashmap->old_slots : hashmap->slots)[index];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores a typed value
+  @param    hashmap   The hashmap
+  @param    key       The key
+  @param    value     The value
+  @param    type      The Splash_hashmap_type of the value
+  @return   Void
+
+  Replaces the value and type of an existing key, else inserts the key.
+  Grows before the slots are three quarters full.
+
+\-----------------------------------------------------------------------------*/
+static void put(Splash_hashmap *hashmap, void *key, Splash_hashmap_value value, int32_t type) {
+  uint64_t h = hashmap->hash(key);
+  int8_t old;
+  int32_t index;
+
+  migrate(hashmap, hashmap->step);
+  index = find_slot(hashmap, key, h, &old);
+
+  if (index != -1) {/* key already exists */
+    Splash_hashmap_slot *slot = &(old ? hashmap->old_slots : hashmap->slots)[index];
+    slot->value = value;
+    slot->type = type;
+    return;
+  }
+
+  if ((hashmap->count + 1) * 4 > hashmap->size * 3 && rehash(hashmap, hashmap->size << 1) == -1) {
+    return;
+  }
+
+  Splash_hashmap_slot slot = {key, value, h, type};
+  insert_slot(hashmap->control, hashmap->slots, hashmap->size, &slot);
+  hashmap->count++;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reads a slot as a double
+  @param    slot    The slot, may be NULL
+  @return   The value else -1
+
+  Numbers are converted, pointer and string values are parsed as text.
+
+\-----------------------------------------------------------------------------*/
+static double slot_number(const Splash_hashmap_slot *slot) {
+  if (slot == NULL) {
+    return -1;
+  }
+
+  switch (slot->type) {
+    case SPLASH_HASHMAP_INT64:
+      return (double)slot->value.integer;
+    case SPLASH_HASHMAP_DOUBLE:
+      return slot->value.number;
+  }
+ return strtod(slot->value.pointer, NULL);
 }
 
 /*---------------------------------------------------------------------------
@@ -115,29 +400,129 @@ static void rehash(Splash_hashmap * hashmap) {
   @return   New hashmap object else NULL
 
   Creates a new Splash_hashmap object destroy with splash_hashmap_destroy();
-  On success will return a new Splash_object else NULL.
+  On success will return a new Splash_object else NULL. The keys are C
+  strings compared by their contents.
 
 \-----------------------------------------------------------------------------*/
 Splash_hashmap *splash_hashmap_create() {
+ return splash_hashmap_create_with(splash_hashmap_hash_string, splash_hashmap_equal_string);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with integer keys
+  @return   New hashmap object else NULL
+
+  The keys are integers made with SPLASH_HASHMAP_INT(i);
+
+\-----------------------------------------------------------------------------*/
+Splash_hashmap *splash_hashmap_create_int() {
+ return splash_hashmap_create_with(splash_hashmap_hash_int, NULL);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with pointer keys
+  @return   New hashmap object else NULL
+
+  The keys are compared by address, the memory they point to is not read.
+
+\-----------------------------------------------------------------------------*/
+Splash_hashmap *splash_hashmap_create_pointer() {
+ return splash_hashmap_create_with(splash_hashmap_hash_int, NULL);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new hashmap with custom keys
+  @param    hash    Hashes the keys
+  @param    equal   Compares the keys, NULL to compare the pointers
+  @return   New hashmap object else NULL
+
+  Each key is hashed once when added, the hash is stored with it.
+
+\-----------------------------------------------------------------------------*/
+Splash_hashmap *splash_hashmap_create_with(Splash_hashmap_hash hash, Splash_hashmap_equal equal) {
+	if (hash == NULL) {
+		return NULL;
+	}
+
 	Splash_hashmap *hashmap = malloc(sizeof(Splash_hashmap));
 
 	if (!hashmap) {
 		return NULL;
 	}
 
-	hashmap->buckets = calloc(256, sizeof(struct _Splash_hashmap_element_ *));
-
-	if (!hashmap->buckets) {
+	if (allocate(INITIAL_SIZE, &hashmap->control, &hashmap->slots) == -1) {
+		free(hashmap);
 		return NULL;
 	}
 
-  hashmap->size = 256;
+  hashmap->size = INITIAL_SIZE;
 	hashmap->count = 0;
+	hashmap->hash = hash;
+	hashmap->equal = equal;
+	hashmap->old_control = NULL;
+	hashmap->old_slots = NULL;
+	hashmap->old_size = 0;
+	hashmap->migrated = 0;
+	hashmap->step = 0;
 
  return hashmap;
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Hashes a string key
+  @param    key   The C string
+  @return   Hash
+
+  Packs the string into eight byte words in one pass without strlen, each
+  word is folded in with a multiply and the result is mixed once at the
+  end.
+
+\-----------------------------------------------------------------------------*/
+uint64_t splash_hashmap_hash_string(const void *key) {
+  const unsigned char *p = key;
+  uint64_t hash = 0x9e3779b97f4a7c15ULL;
+
+  while (*p) {
+    uint64_t word = 0;
+    int n;
+    for (n = 0; n < 8 && p[n]; n++) {
+      word |= (uint64_t)p[n] << (n * 8);
+    }
+    hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 32;
+    p += n;
+  }
+ return mix(hash ^ (p - (const unsigned char *)key));
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Compares two string keys
+  @param    a     The first C string
+  @param    b     The second C string
+  @return   1 if equal else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_hashmap_equal_string(const void *a, const void *b) {
+ return strcmp(a, b) == 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes an integer or pointer key
+  @param    key   The key
+  @return   Hash
+
+\-----------------------------------------------------------------------------*/
+uint64_t splash_hashmap_hash_int(const void *key) {
+ return mix((uint64_t)(uintptr_t)key);
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a element to the Splash_hashmap
   @param    hashmap     The hashmap to add the data to
@@ -145,30 +530,14 @@ Splash_hashmap *splash_hashmap_create() {
   @param    value       The value to tie to the key
   @return    void
 
-  Adds the data passed in to the key inside the hashmap
+  Adds the data passed in to the key inside the hashmap, the key is not
+  copied. Grows before the slots are three quarters full.
 
 \-----------------------------------------------------------------------------*/
 void splash_hashmap_add(Splash_hashmap *hashmap, void *key, void *value) {
-  struct _Splash_hashmap_element_ *item;
-  struct _Splash_hashmap_element_ **p;
-  int index = hash(key, hashmap->size);
-
-  p = &(hashmap->buckets[index]);
-
-  for (item = *p; item != NULL; item = item->next) {
-    if (item->key == key) {/* key already exists */
-      item->value = value;
-      return;
-    }
-  }
-
-  item = *p;
-  (*p) = create_element(key, value);
-  (*p)->next = item;
-
-  if (++hashmap->count >= hashmap->size * 3 / 4) {
-    rehash(hashmap);
-  }
+  Splash_hashmap_value stored;
+  stored.pointer = value;
+  put(hashmap, key, stored, SPLASH_HASHMAP_POINTER);
 }
 
 
@@ -179,19 +548,16 @@ void splash_hashmap_add(Splash_hashmap *hashmap, void *key, void *value) {
   @return    the value stored at that location else -1
 
   Returns the value at the given location. NOTE: DOES NOTE CAST TO A TYPE.
+  Integer and double values are not pointers, -1 is returned for them.
 
 \-----------------------------------------------------------------------------*/
 void *splash_hashmap_get(Splash_hashmap *hashmap, void *key) {
-	int index = hash(key, hashmap->size);
-  struct _Splash_hashmap_element_ *item;
+  Splash_hashmap_slot *slot = find(hashmap, key);
 
-  for (item = hashmap->buckets[index]; item != NULL; item = item->next) {
-    if (item->key == key) {
-      return item->value;
-    }
+  if (slot == NULL || slot->type == SPLASH_HASHMAP_INT64 || slot->type == SPLASH_HASHMAP_DOUBLE) {
+    return (void *)-1;
   }
-
-  return (void *)-1;
+  return slot->value.pointer;
 }
 
 
@@ -215,15 +581,12 @@ char *splash_hashmap_get_string(Splash_hashmap *hashmap, void *key) {
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a int.
+  Returns the value at the given location as a int. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 int splash_hashmap_get_int(Splash_hashmap *hashmap, void *key) {
-  void *value = splash_hashmap_get(hashmap, key);
-  if (value == (void *)-1) {
-    return -1;
-  }
-	return strtol(value, NULL, 10);
+	return (int) splash_hashmap_get_int64(hashmap, key);
 }
 
 
@@ -233,15 +596,17 @@ int splash_hashmap_get_int(Splash_hashmap *hashmap, void *key) {
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a float.
+  Returns the value at the given location as a float. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 float splash_hashmap_get_float(Splash_hashmap *hashmap, void *key) {
-	void *value = splash_hashmap_get(hashmap, key);
-  if (value == (void *)-1) {
-    return -1;
+  Splash_hashmap_slot *slot = find(hashmap, key);
+
+  if (slot != NULL && (slot->type == SPLASH_HASHMAP_POINTER || slot->type == SPLASH_HASHMAP_STRING)) {
+    return strtof(slot->value.pointer, NULL);
   }
-  return strtof(value, NULL);
+  return (float)slot_number(slot);
 }
 
 
@@ -251,15 +616,100 @@ float splash_hashmap_get_float(Splash_hashmap *hashmap, void *key) {
   @param    key         The key to search for
   @return    the value stored at that location else -1
 
-  Returns the value at the given location as a double.
+  Returns the value at the given location as a double. Integer and double
+  values are converted, pointer and string values are parsed as text.
 
 \-----------------------------------------------------------------------------*/
 double splash_hashmap_get_double(Splash_hashmap *hashmap, void *key) {
-	void *value = splash_hashmap_get(hashmap, key);
-  if (value == (void *)-1) {
+ return slot_number(find(hashmap, key));
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores a string
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The string, it is not copied
+  @return    void
+
+\-----------------------------------------------------------------------------*/
+void splash_hashmap_set_string(Splash_hashmap *hashmap, void *key, char *value) {
+  Splash_hashmap_value stored;
+  stored.pointer = value;
+  put(hashmap, key, stored, SPLASH_HASHMAP_STRING);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores an integer
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The integer
+  @return    void
+
+\-----------------------------------------------------------------------------*/
+void splash_hashmap_set_int(Splash_hashmap *hashmap, void *key, int64_t value) {
+  Splash_hashmap_value stored;
+  stored.integer = value;
+  put(hashmap, key, stored, SPLASH_HASHMAP_INT64);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stores a double
+  @param    hashmap     The hashmap to add the data to
+  @param    key         The key to add the data to
+  @param    value       The double
+  @return    void
+
+\-----------------------------------------------------------------------------*/
+void splash_hashmap_set_double(Splash_hashmap *hashmap, void *key, double value) {
+  Splash_hashmap_value stored;
+  stored.number = value;
+  put(hashmap, key, stored, SPLASH_HASHMAP_DOUBLE);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a 64 bit integer element
+  @param    hashmap     The hashmap to get the data from
+  @param    key         The key to search for
+  @return    the value stored at that location else -1
+
+  Doubles are truncated, pointer and string values are parsed as text.
+
+\-----------------------------------------------------------------------------*/
+int64_t splash_hashmap_get_int64(Splash_hashmap *hashmap, void *key) {
+  Splash_hashmap_slot *slot = find(hashmap, key);
+
+  if (slot == NULL) {
     return -1;
   }
- return strtod(value, NULL);
+
+  switch (slot->type) {
+    case SPLASH_HASHMAP_INT64:
+      return slot->value.integer;
+    case SPLASH_HASHMAP_DOUBLE:
+      return (int64_t)slot->value.number;
+  }
+ return strtoll(slot->value.pointer, NULL, 10);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the type of an element
+  @param    hashmap     The hashmap to get the data from
+  @param    key         The key to search for
+  @return    The type of the value else SPLASH_HASHMAP_NONE
+
+\-----------------------------------------------------------------------------*/
+Splash_hashmap_type splash_hashmap_get_type(Splash_hashmap *hashmap, void *key) {
+  Splash_hashmap_slot *slot = find(hashmap, key);
+
+  if (slot == NULL) {
+    return SPLASH_HASHMAP_NONE;
+  }
+ return (Splash_hashmap_type)slot->type;
 }
 
 
@@ -269,36 +719,107 @@ double splash_hashmap_get_double(Splash_hashmap *hashmap, void *key) {
   @param    key     The key to search for
   @return    void
 
-  remove the value in the SSL_Hashmap.
+  remove the value in the SSL_Hashmap. The elements after it are moved back
+  so the probe runs stay unbroken without tombstones.
 
 \-----------------------------------------------------------------------------*/
 void splash_hashmap_remove(Splash_hashmap *hashmap, void *key) {
-  int index = hash(key, hashmap->size);
-  struct _Splash_hashmap_element_ *item;
-  struct _Splash_hashmap_element_ *next;
+  int8_t old;
+  int32_t i;
+  int32_t mask = hashmap->size - 1;
+  int32_t j;
 
-  item = hashmap->buckets[index];
+  migrate(hashmap, hashmap->step);
+  i = find_slot(hashmap, key, hashmap->hash(key), &old);
 
-  if (item == NULL)
+  if (i == -1) {
     return;
+  }
 
-  if (item->next == NULL) {
-    free(item);
-    hashmap->buckets[index] = NULL;
+  /* the old table is only probed until it is freed, a marker is enough */
+  if (old) {
+    set_control(hashmap->old_control, hashmap->old_size, i, DELETED);
     hashmap->count--;
     return;
   }
 
-  while (item != NULL) {
-    next = item->next;
-    if (next != NULL && next->key == key) {
-      item->next = next->next;
-      hashmap->count--;
-      free(next);
-      return;
+  /* shift the rest of the run back so no tombstone is left */
+  for (j = (i + 1) & mask; hashmap->control[j] != EMPTY; j = (j + 1) & mask) {
+    int32_t home = hashmap->slots[j].hash & mask;
+    int8_t reachable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+
+    if (reachable) {
+      hashmap->slots[i] = hashmap->slots[j];
+      set_control(hashmap->control, hashmap->size, i, hashmap->control[j]);
+      i = j;
     }
-    item = next;
   }
+
+  set_control(hashmap->control, hashmap->size, i, EMPTY);
+  hashmap->count--;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the incremental rehash mode
+  @param    hashmap   The hashmap
+  @param    step      Old slots moved per operation while growing, 0 moves
+                      them all when the hashmap grows
+  @return   Void
+
+  With a step the old slots are kept when the hashmap grows and each add,
+  get and remove moves a few, spreading the cost of growing. A step of 2
+  or more finishes before the next grow.
+
+\-----------------------------------------------------------------------------*/
+void splash_hashmap_set_incremental(Splash_hashmap *hashmap, int32_t step) {
+  hashmap->step = step > 0 ? step : 0;
+  if (!hashmap->step) {
+    migrate(hashmap, INT32_MAX);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reserves room for elements
+  @param    hashmap   The hashmap
+  @param    count     Number of elements
+  @return   0 on success else -1
+
+  Grows the hashmap at once so count elements fit without growing again.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_hashmap_reserve(Splash_hashmap *hashmap, int32_t count) {
+  int32_t size = hashmap->size;
+
+  while ((int64_t)count * 4 > (int64_t)size * 3) {
+    if (size > INT32_MAX / 2) {
+      return -1;
+    }
+    size <<= 1;
+  }
+
+  migrate(hashmap, INT32_MAX);
+  if (size == hashmap->size) {
+    return 0;
+  }
+
+  int32_t step = hashmap->step;
+  hashmap->step = 0;
+  int8_t result = rehash(hashmap, size);
+  hashmap->step = step;
+ return result;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity of the hashmap
+  @param    hashmap   The hashmap
+  @return   Number of elements that fit before the hashmap grows
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_hashmap_get_capacity(Splash_hashmap *hashmap) {
+ return hashmap->size / 4 * 3;
 }
 
 
@@ -324,18 +845,9 @@ int32_t splash_hashmap_get_size(Splash_hashmap *hashmap) {
   
 \-----------------------------------------------------------------------------*/
 void splash_hashmap_destory(Splash_hashmap *hashmap) {
-  int i;
-  struct _Splash_hashmap_element_ *item;
-  struct _Splash_hashmap_element_ *next;
-
-  for (i = 0; i < hashmap->size; i++) {
-    for (item = hashmap->buckets[i]; item != NULL;) {
-      next = item->next;
-      free(item);
-      item = next;
-    }
-  }
-
-  free(hashmap->buckets);
+  free(hashmap->old_control);
+  free(hashmap->old_slots);
+  free(hashmap->control);
+  free(hashmap->slots);
   free(hashmap);
 }
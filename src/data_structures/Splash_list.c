@@ -15,6 +15,8 @@
  ---------------------------------------------------------------------------*/
 
 #include "Splash/Splash_list.h"
+#include "Splash/Splash_pool.h"
+#include "SDL2/SDL.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -23,16 +25,21 @@
                             Private functions
  ---------------------------------------------------------------------------*/
 
+static Splash_pool *shared_pool = NULL;	/**< the node pool of lists made without one */
+static SDL_SpinLock shared_lock = 0;	/**< guards making the shared pool */
+
+
 /*!--------------------------------------------------------------------------
   @brief    Creates a new Splash_list_Node
+  @param  pool      The pool to take the node from
   @return   New Splash_List_Node otherwise NULL.
 
   Creates a new Splash_list_node object returns  a new object else 
   null if unsuccessful
 
 \-----------------------------------------------------------------------------*/
-static struct _splash_list_node_ *splash_list_node_create() {
-	struct _splash_list_node_ *node = malloc(sizeof(_splash_list_node_));
+static struct _splash_list_node_ *splash_list_node_create(Splash_pool *pool) {
+	struct _splash_list_node_ *node = splash_pool_alloc(pool);
 
 		if (!node) {
 			return NULL;
@@ -58,6 +65,24 @@ static struct _splash_list_node_ *splash_list_node_create() {
 
 \-----------------------------------------------------------------------------*/
 Splash_list *splash_list_create() {
+	Splash_pool *pool = splash_list_get_shared_pool();
+
+	if (!pool) {
+		return NULL;
+	}
+ return splash_list_create_pool(pool);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new Splash_list using a pool
+  @param  pool      Pool of blocks of sizeof(struct _splash_list_node_)
+  @return   New Splash_List otherwise NULL.
+
+  Like splash_list_create(); but the nodes come from the given pool.
+
+\-----------------------------------------------------------------------------*/
+Splash_list *splash_list_create_pool(Splash_pool *pool) {
 	Splash_list *list = malloc(sizeof(Splash_list));
 
 	if (!list) {
@@ -65,33 +90,66 @@ Splash_list *splash_list_create() {
 	}
 
 	list->size = 0;
-	list->next = splash_list_node_create();
+	list->pool = pool;
+	list->next = splash_list_node_create(pool);
+	list->tail = list->next;
+
+	if (!list->next) {
+		free(list);
+		return NULL;
+	}
 
  return list;
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets the pool shared by the lists
+  @return   The shared node pool else NULL
+
+  Made on first use.
+
+\-----------------------------------------------------------------------------*/
+Splash_pool *splash_list_get_shared_pool() {
+	Splash_pool *pool = SDL_AtomicGetPtr((void **)&shared_pool);
+
+	if (pool == NULL) {
+		SDL_AtomicLock(&shared_lock);
+		if (shared_pool == NULL) {
+			pool = splash_pool_create_shared(sizeof(struct _splash_list_node_), 0);
+			if (pool) {
+				splash_pool_set_thread_cache(pool, 1);
+			}
+			SDL_AtomicSetPtr((void **)&shared_pool, pool);
+		}
+		pool = shared_pool;
+		SDL_AtomicUnlock(&shared_lock);
+	}
+ return pool;
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a item to the list
   @param  list      The list to add to
   @param  data       The data to add
   @return  Void
 
-  Adds a item to the end of the list
+  Adds a item to the end of the list, the tail is kept so this is O(1).
 
 \-----------------------------------------------------------------------------*/
 void splash_list_add(Splash_list *list, void *data) {
-	struct _splash_list_node_ *node = list->next;
+	struct _splash_list_node_ *tmp = splash_list_node_create(list->pool);
 
-	while((int)(node->next) != 0 ) node = node->next;
-
-	struct _splash_list_node_ *tmp = splash_list_node_create();
-	tmp->data = malloc(sizeof(data));
+	if (!tmp) {
+		return;
+	}
 
 	tmp->data = data;
 	tmp->next = 0;
 
-	node->next = tmp;
+	list->tail->next = tmp;
+	list->tail = tmp;
 	list->size++;
 }
 
@@ -249,8 +307,11 @@ void splash_list_remove_position(Splash_list *list, int32_t pos) {
 		return;
 	}
 
+	if (node == list->tail) {
+		list->tail = previous_node;
+	}
 	previous_node->next = node->next;
-	free(node);
+	splash_pool_free(list->pool, node);
 	if (list->size > 0) {
 		list->size--;
 	}
@@ -275,12 +336,15 @@ void splash_list_remove(Splash_list *list, void *data) {
 		node = node->next;
 	}
 
-	if (node->data != data) {
+	if (node->data != data || previous_node == NULL) {
 		return;
 	}
 
+	if (node == list->tail) {
+		list->tail = previous_node;
+	}
 	previous_node->next = node->next;
-	free(node);
+	splash_pool_free(list->pool, node);
 	if (list->size > 0) {
 		list->size--;
 	}
@@ -292,15 +356,21 @@ void splash_list_remove(Splash_list *list, void *data) {
   @param  list      The list to empty
   @return  Void
 
-  Empties the list.
+  Empties the list in one pass.
   
 \-----------------------------------------------------------------------------*/
 void splash_list_remove_all(Splash_list *list) {
-	int32_t i;
-	int32_t size = list->size;
-	for (i = 0; i < size; i++) {
-		splash_list_remove_position(list, 0);
+	struct _splash_list_node_ *node = list->next->next;
+
+	while(node != 0) {
+		struct _splash_list_node_ *next_node = node->next;
+		splash_pool_free(list->pool, node);
+		node = next_node;
 	}
+
+	list->next->next = 0;
+	list->tail = list->next;
+	list->size = 0;
 }
 
 
@@ -333,9 +403,9 @@ void splash_list_destroy(Splash_list *list) {
 		previous_node = node;
 		node = node->next;
 		free(previous_node->data);
-		free(previous_node);
+		splash_pool_free(list->pool, previous_node);
 	}
 
-	free(previous_node);
-	free(node);
+	/* the nodes before the last went back in the loop */
+	splash_pool_free(list->pool, node);
 }
\ No newline at end of file
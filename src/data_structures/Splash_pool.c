@@ -0,0 +1,469 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_pool.c
+   @author  P. Batty
+   @brief   The pool structs
+
+   This module implements fixed size block pools. Blocks are carved from
+   pages and reused through a free list, all of them are freed at once
+   when the pool is destroyed.
+
+   Each pool has a generation, new on create and on free all, that thread
+   caches remember. A cache of an old generation is thrown away instead
+   of used, and a cache is only given back to a pool found in the list of
+   cached pools, so emptying or destroying a pool from another thread
+   never hands out or touches stale blocks.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_pool.h"
+#include "SDL2/SDL.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+struct Splash_pool_page {
+  struct Splash_pool_page *next;        /**< next page of the pool */
+  uint64_t align;                       /**< keeps the blocks after the header aligned */
+};
+
+static THREAD_LOCAL Splash_pool *cache_pool;          /**< the pool the thread cache holds blocks of */
+static THREAD_LOCAL Splash_pool_block *cache_blocks;  /**< the cached free blocks */
+static THREAD_LOCAL int32_t cache_count;              /**< number of cached blocks */
+static THREAD_LOCAL int cache_generation;             /**< generation of the pool when cached */
+
+static SDL_atomic_t generations;                      /**< last generation given out */
+static Splash_pool *cached_pools;                     /**< pools that have had thread caches */
+static SDL_SpinLock cached_lock;                      /**< guards the cached pools */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Locks a shared pool
+  @param    pool    The pool
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void lock(Splash_pool *pool) {
+  if (pool->shared) {
+    SDL_AtomicLock(&pool->lock);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Unlocks a shared pool
+  @param    pool    The pool
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void unlock(Splash_pool *pool) {
+  if (pool->shared) {
+    SDL_AtomicUnlock(&pool->lock);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives out a new generation
+  @return   The generation, never given out before
+
+\-----------------------------------------------------------------------------*/
+static int next_generation() {
+ return SDL_AtomicAdd(&generations, 1) + 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Puts the blocks of a page on the free list
+  @param    pool    The pool
+  @param    page    The page
+  @return   Void
+
+  Pushed last to first so blocks are handed out in address order.
+
+\-----------------------------------------------------------------------------*/
+static void carve(Splash_pool *pool, struct Splash_pool_page *page) {
+  char *blocks = (char *)(page + 1);
+  int32_t i;
+
+  for (i = pool->page_blocks; i > 0; i--) {
+    Splash_pool_block *block = (Splash_pool_block *)(blocks + (size_t)(i - 1) * pool->block_size);
+    block->next = pool->free;
+    pool->free = block;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a free block, the pool must be locked
+  @param    pool    The pool
+  @return   The block else NULL
+
+  Adds a page when no block is free.
+
+\-----------------------------------------------------------------------------*/
+static Splash_pool_block *take(Splash_pool *pool) {
+  Splash_pool_block *block = pool->free;
+
+  if (block == NULL) {
+    struct Splash_pool_page *page = malloc(sizeof(struct Splash_pool_page) + (size_t)pool->page_blocks * pool->block_size);
+    if (page == NULL) {
+      return NULL;
+    }
+    page->next = pool->pages;
+    pool->pages = page;
+    pool->capacity += pool->page_blocks;
+    carve(pool, page);
+    block = pool->free;
+  }
+
+  pool->free = block->next;
+  pool->used++;
+ return block;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives a block back, the pool must be locked
+  @param    pool    The pool
+  @param    block   The block
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void give(Splash_pool *pool, Splash_pool_block *block) {
+  block->next = pool->free;
+  pool->free = block;
+  pool->used--;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Binds the thread cache to a pool
+  @param    pool    The pool
+  @return   Void
+
+  Gives the blocks of the previous pool back first, a cache of an older
+  generation of the same pool is thrown away as its blocks were freed.
+
+\-----------------------------------------------------------------------------*/
+static void bind_cache(Splash_pool *pool) {
+  int generation = SDL_AtomicGet(&pool->generation);
+
+  if (cache_pool == pool && cache_generation == generation) {
+    return;
+  }
+
+  if (cache_pool == pool) {
+    cache_blocks = NULL;
+    cache_count = 0;
+  } else {
+    splash_pool_flush_thread_cache();
+  }
+  cache_pool = pool;
+  cache_generation = generation;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a pool
+  @param    block_size    Bytes in a block
+  @param    page_blocks   Blocks carved per page
+  @param    shared        Guard the pool with a lock
+  @return   New Splash_pool otherwise NULL.
+
+\-----------------------------------------------------------------------------*/
+static Splash_pool *create(int32_t block_size, int32_t page_blocks, int8_t shared) {
+  if (block_size <= 0 || page_blocks < 0) {
+    return NULL;
+  }
+
+  Splash_pool *pool = malloc(sizeof(Splash_pool));
+  if (!pool) {
+    return NULL;
+  }
+
+  if (block_size < (int32_t)sizeof(Splash_pool_block)) {
+    block_size = sizeof(Splash_pool_block);
+  }
+  pool->block_size = (block_size + 7) & ~7;
+  pool->page_blocks = page_blocks ? page_blocks : SPLASH_POOL_PAGE_BLOCKS;
+  pool->free = NULL;
+  pool->pages = NULL;
+  pool->used = 0;
+  pool->capacity = 0;
+  pool->shared = shared;
+  pool->thread_cache = 0;
+  pool->lock = 0;
+  pool->next_cached = NULL;
+  SDL_AtomicSet(&pool->generation, next_generation());
+ return pool;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new pool
+  @param    block_size    Bytes in a block
+  @param    page_blocks   Blocks carved per page, 0 for SPLASH_POOL_PAGE_BLOCKS
+  @return   New Splash_pool otherwise NULL.
+
+  Creates a pool for one thread, destroy with splash_pool_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_pool *splash_pool_create(int32_t block_size, int32_t page_blocks) {
+ return create(block_size, page_blocks, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new shared pool
+  @param    block_size    Bytes in a block
+  @param    page_blocks   Blocks carved per page, 0 for SPLASH_POOL_PAGE_BLOCKS
+  @return   New Splash_pool otherwise NULL.
+
+\-----------------------------------------------------------------------------*/
+Splash_pool *splash_pool_create_shared(int32_t block_size, int32_t page_blocks) {
+ return create(block_size, page_blocks, 1);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Turns the thread caches of a shared pool on or off
+  @param    pool      The shared pool
+  @param    enabled   Let threads keep free blocks
+  @return   Void
+
+  Ignored for pools that are not shared, they have no lock to skip. The
+  pool joins the cached pools so threads can find it to give blocks back.
+
+\-----------------------------------------------------------------------------*/
+void splash_pool_set_thread_cache(Splash_pool *pool, int8_t enabled) {
+  Splash_pool *cached;
+
+  if (!pool->shared) {
+    return;
+  }
+
+  if (enabled) {
+    SDL_AtomicLock(&cached_lock);
+    for (cached = cached_pools; cached != NULL && cached != pool; cached = cached->next_cached);
+    if (cached == NULL) {
+      pool->next_cached = cached_pools;
+      cached_pools = pool;
+    }
+    SDL_AtomicUnlock(&cached_lock);
+  }
+
+  if (!enabled && cache_pool == pool) {
+    splash_pool_flush_thread_cache();
+  }
+  pool->thread_cache = enabled != 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives the cached blocks of this thread back
+  @return   Void
+
+  The blocks are only given back when the pool is still cached and of the
+  same generation, else they went with the pool or its free all.
+
+\-----------------------------------------------------------------------------*/
+void splash_pool_flush_thread_cache() {
+  Splash_pool *pool;
+
+  if (cache_pool == NULL) {
+    return;
+  }
+
+  SDL_AtomicLock(&cached_lock);
+  for (pool = cached_pools; pool != NULL && pool != cache_pool; pool = pool->next_cached);
+  if (pool != NULL) {
+    lock(pool);
+    if (SDL_AtomicGet(&pool->generation) == cache_generation) {
+      while (cache_blocks != NULL) {
+        Splash_pool_block *block = cache_blocks;
+        cache_blocks = block->next;
+        give(pool, block);
+      }
+    }
+    unlock(pool);
+  }
+  SDL_AtomicUnlock(&cached_lock);
+
+  cache_pool = NULL;
+  cache_blocks = NULL;
+  cache_count = 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a block from the pool
+  @param    pool    The pool
+  @return   The block else NULL
+
+  With a thread cache an empty cache is refilled with half of
+  SPLASH_POOL_CACHE blocks under one lock.
+
+\-----------------------------------------------------------------------------*/
+void *splash_pool_alloc(Splash_pool *pool) {
+  Splash_pool_block *block;
+
+  if (!pool->thread_cache) {
+    lock(pool);
+    block = take(pool);
+    unlock(pool);
+    return block;
+  }
+
+  bind_cache(pool);
+  if (cache_blocks == NULL) {
+    lock(pool);
+    while (cache_count < SPLASH_POOL_CACHE / 2 && (block = take(pool)) != NULL) {
+      block->next = cache_blocks;
+      cache_blocks = block;
+      cache_count++;
+    }
+    unlock(pool);
+
+    if (cache_blocks == NULL) {
+      return NULL;
+    }
+  }
+
+  block = cache_blocks;
+  cache_blocks = block->next;
+  cache_count--;
+ return block;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives a block back to the pool
+  @param    pool    The pool the block came from
+  @param    block   The block, NULL is ignored
+  @return   Void
+
+  With a thread cache a full cache gives half its blocks back under one
+  lock.
+
+\-----------------------------------------------------------------------------*/
+void splash_pool_free(Splash_pool *pool, void *block) {
+  Splash_pool_block *free_block = block;
+
+  if (free_block == NULL) {
+    return;
+  }
+
+  if (!pool->thread_cache) {
+    lock(pool);
+    give(pool, free_block);
+    unlock(pool);
+    return;
+  }
+
+  bind_cache(pool);
+  free_block->next = cache_blocks;
+  cache_blocks = free_block;
+  cache_count++;
+
+  if (cache_count > SPLASH_POOL_CACHE) {
+    lock(pool);
+    while (cache_count > SPLASH_POOL_CACHE / 2) {
+      free_block = cache_blocks;
+      cache_blocks = free_block->next;
+      give(pool, free_block);
+      cache_count--;
+    }
+    unlock(pool);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives every block back to the pool
+  @param    pool    The pool
+  @return   Void
+
+  Rebuilds the free list from the pages, the pages are kept for reuse. The
+  new generation makes every thread cache of the pool stale.
+
+\-----------------------------------------------------------------------------*/
+void splash_pool_free_all(Splash_pool *pool) {
+  struct Splash_pool_page *page;
+
+  lock(pool);
+  SDL_AtomicSet(&pool->generation, next_generation());
+  pool->free = NULL;
+  for (page = pool->pages; page != NULL; page = page->next) {
+    carve(pool, page);
+  }
+  pool->used = 0;
+  unlock(pool);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of blocks in use
+  @param    pool    The pool
+  @return   Blocks handed out
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_pool_get_used(Splash_pool *pool) {
+ return pool->used;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of blocks in the pages
+  @param    pool    The pool
+  @return   Blocks carved so far
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_pool_get_capacity(Splash_pool *pool) {
+ return pool->capacity;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the pool
+  @param    pool    The pool
+  @return   Void
+
+  Frees every page, blocks still in use are freed with them. The pool
+  leaves the cached pools first so no thread gives blocks back to it.
+
+\-----------------------------------------------------------------------------*/
+void splash_pool_destroy(Splash_pool *pool) {
+  Splash_pool **link;
+
+  SDL_AtomicLock(&cached_lock);
+  for (link = &cached_pools; *link != NULL && *link != pool; link = &(*link)->next_cached);
+  if (*link != NULL) {
+    *link = pool->next_cached;
+  }
+  SDL_AtomicUnlock(&cached_lock);
+
+  while (pool->pages != NULL) {
+    struct Splash_pool_page *page = pool->pages;
+    pool->pages = page->next;
+    free(page);
+  }
+  free(pool);
+}
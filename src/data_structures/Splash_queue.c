@@ -0,0 +1,691 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_queue.c
+   @author  P. Batty
+   @brief   The queue structs
+
+   This module implements bounded lock free queues for passing pointers
+   between threads. Splash_ring has one producer and one consumer,
+   Splash_queue any number of both.
+
+   Positions only ever grow and wrap around as unsigned 32 bit numbers,
+   the slot is the position masked by the capacity. Indices are
+   published with SDL_AtomicAdd, a full barrier, so the items are written
+   before they are seen and a waiter check after it can not miss a
+   thread that went to sleep.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_queue.h"
+#include "SDL2/SDL.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define MAX_CAPACITY (1 << 30)    /**< most slots in a queue */
+#define SPIN_TRIES 64             /**< tries before a wait goes to sleep */
+
+typedef int8_t (*attempt_function)(void *queue, void **data);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Rounds a capacity up to a power of two
+  @param    capacity    The capacity asked for
+  @return   The capacity else 0 if it is out of range
+
+\-----------------------------------------------------------------------------*/
+static int32_t round_capacity(int32_t capacity) {
+  int32_t size = 1;
+
+  if (capacity <= 0 || capacity > MAX_CAPACITY) {
+    return 0;
+  }
+
+  while (size < capacity) {
+    size <<= 1;
+  }
+ return size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets up the waiting of a queue
+  @param    wait    The wait
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t wait_create(Splash_queue_wait *wait) {
+  wait->lock = SDL_CreateMutex();
+  wait->changed = SDL_CreateCond();
+  SDL_AtomicSet(&wait->waiters, 0);
+
+  if (wait->lock == NULL || wait->changed == NULL) {
+    return -1;
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees the waiting of a queue
+  @param    wait    The wait
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void wait_destroy(Splash_queue_wait *wait) {
+  if (wait->changed != NULL) {
+    SDL_DestroyCond(wait->changed);
+  }
+  if (wait->lock != NULL) {
+    SDL_DestroyMutex(wait->lock);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Wakes the waiting threads
+  @param    wait    The wait
+  @return   Void
+
+  Called after a push or pop, does not lock unless a thread is waiting.
+
+\-----------------------------------------------------------------------------*/
+static void wait_notify(Splash_queue_wait *wait) {
+  if (SDL_AtomicGet(&wait->waiters) > 0) {
+    SDL_LockMutex(wait->lock);
+    SDL_CondBroadcast(wait->changed);
+    SDL_UnlockMutex(wait->lock);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Retries a push or pop until it works
+  @param    wait      The wait
+  @param    attempt   The push or pop
+  @param    queue     The queue
+  @param    data      The item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+  Spins a little first, then sleeps until the other side changes the
+  queue. The waiter count is raised before the last try under the lock,
+  so a change made after that try always wakes us. The attempts do not
+  wake anyone themselves as they run with the lock held.
+
+\-----------------------------------------------------------------------------*/
+static int8_t wait_for(Splash_queue_wait *wait, attempt_function attempt, void *queue, void **data, int32_t timeout) {
+  Uint32 start = SDL_GetTicks();
+  int8_t result;
+  int32_t i;
+
+  for (i = 0; i < SPIN_TRIES; i++) {
+    if (attempt(queue, data) == 0) {
+      wait_notify(wait);
+      return 0;
+    }
+  }
+
+  if (timeout == 0) {
+    return -1;
+  }
+
+  SDL_AtomicAdd(&wait->waiters, 1);
+  SDL_LockMutex(wait->lock);
+  while ((result = attempt(queue, data)) != 0) {
+    if (timeout < 0) {
+      SDL_CondWait(wait->changed, wait->lock);
+    } else {
+      Uint32 elapsed = SDL_GetTicks() - start;
+      if (elapsed >= (Uint32)timeout) {
+        break;
+      }
+      SDL_CondWaitTimeout(wait->changed, wait->lock, (Uint32)timeout - elapsed);
+    }
+  }
+  SDL_UnlockMutex(wait->lock);
+  SDL_AtomicAdd(&wait->waiters, -1);
+
+  if (result == 0) {
+    wait_notify(wait);
+  }
+ return result;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items without waking waiters
+  @param    ring      The ring
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+  The head is only read again when the cached one says the ring is full.
+
+\-----------------------------------------------------------------------------*/
+static int32_t ring_push(Splash_ring *ring, void **data, int32_t count) {
+  uint32_t tail = (uint32_t)SDL_AtomicGet(&ring->tail);
+  uint32_t free_slots = ring->capacity - (tail - ring->head_cache);
+  int32_t i;
+
+  if (free_slots < (uint32_t)count) {
+    ring->head_cache = (uint32_t)SDL_AtomicGet(&ring->head);
+    free_slots = ring->capacity - (tail - ring->head_cache);
+  }
+  if (count > (int32_t)free_slots) {
+    count = free_slots;
+  }
+  if (count <= 0) {
+    return 0;
+  }
+
+  for (i = 0; i < count; i++) {
+    ring->data[(tail + i) & ring->mask] = data[i];
+  }
+  SDL_AtomicAdd(&ring->tail, count);
+ return count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items without waking waiters
+  @param    ring      The ring
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+  The tail is only read again when the cached one says there is too little.
+
+\-----------------------------------------------------------------------------*/
+static int32_t ring_pop(Splash_ring *ring, void **data, int32_t count) {
+  uint32_t head = (uint32_t)SDL_AtomicGet(&ring->head);
+  uint32_t ready = ring->tail_cache - head;
+  int32_t i;
+
+  if (ready < (uint32_t)count) {
+    ring->tail_cache = (uint32_t)SDL_AtomicGet(&ring->tail);
+    ready = ring->tail_cache - head;
+  }
+  if (count > (int32_t)ready) {
+    count = ready;
+  }
+  if (count <= 0) {
+    return 0;
+  }
+
+  for (i = 0; i < count; i++) {
+    data[i] = ring->data[(head + i) & ring->mask];
+  }
+  SDL_AtomicAdd(&ring->head, count);
+ return count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items without waking waiters
+  @param    queue     The queue
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+  Counts the free cells from the tail, a cell is free when its sequence
+  is its position. Another producer moving the tail fails the compare
+  and swap and the count starts again.
+
+\-----------------------------------------------------------------------------*/
+static int32_t queue_push(Splash_queue *queue, void **data, int32_t count) {
+  uint32_t pos = (uint32_t)SDL_AtomicGet(&queue->tail);
+  int32_t claimed;
+  int32_t i;
+
+  if (count <= 0) {
+    return 0;
+  }
+
+  for (;;) {
+    claimed = 0;
+    while (claimed < count) {
+      Splash_queue_cell *cell = &queue->cells[(pos + claimed) & queue->mask];
+      if ((uint32_t)SDL_AtomicGet(&cell->sequence) != pos + claimed) {
+        break;
+      }
+      claimed++;
+    }
+
+    if (claimed == 0) {
+      Splash_queue_cell *cell = &queue->cells[pos & queue->mask];
+      if ((int32_t)((uint32_t)SDL_AtomicGet(&cell->sequence) - pos) < 0) {
+        return 0;
+      }
+    } else if (SDL_AtomicCAS(&queue->tail, (int)pos, (int)(pos + claimed))) {
+      break;
+    }
+    pos = (uint32_t)SDL_AtomicGet(&queue->tail);
+  }
+
+  for (i = 0; i < claimed; i++) {
+    Splash_queue_cell *cell = &queue->cells[(pos + i) & queue->mask];
+    cell->data = data[i];
+    SDL_AtomicAdd(&cell->sequence, 1);
+  }
+ return claimed;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items without waking waiters
+  @param    queue     The queue
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+  Counts the full cells from the head, a cell is full when its sequence
+  is its position + 1. Popping sets it to the position of the next lap.
+
+\-----------------------------------------------------------------------------*/
+static int32_t queue_pop(Splash_queue *queue, void **data, int32_t count) {
+  uint32_t pos = (uint32_t)SDL_AtomicGet(&queue->head);
+  int32_t claimed;
+  int32_t i;
+
+  if (count <= 0) {
+    return 0;
+  }
+
+  for (;;) {
+    claimed = 0;
+    while (claimed < count) {
+      Splash_queue_cell *cell = &queue->cells[(pos + claimed) & queue->mask];
+      if ((uint32_t)SDL_AtomicGet(&cell->sequence) != pos + claimed + 1) {
+        break;
+      }
+      claimed++;
+    }
+
+    if (claimed == 0) {
+      Splash_queue_cell *cell = &queue->cells[pos & queue->mask];
+      if ((int32_t)((uint32_t)SDL_AtomicGet(&cell->sequence) - (pos + 1)) < 0) {
+        return 0;
+      }
+    } else if (SDL_AtomicCAS(&queue->head, (int)pos, (int)(pos + claimed))) {
+      break;
+    }
+    pos = (uint32_t)SDL_AtomicGet(&queue->head);
+  }
+
+  for (i = 0; i < claimed; i++) {
+    Splash_queue_cell *cell = &queue->cells[(pos + i) & queue->mask];
+    data[i] = cell->data;
+    SDL_AtomicAdd(&cell->sequence, (int)queue->mask);
+  }
+ return claimed;
+}
+
+
+static int8_t ring_push_attempt(void *ring, void **data) {
+ return ring_push(ring, data, 1) == 1 ? 0 : -1;
+}
+
+
+static int8_t ring_pop_attempt(void *ring, void **data) {
+ return ring_pop(ring, data, 1) == 1 ? 0 : -1;
+}
+
+
+static int8_t queue_push_attempt(void *queue, void **data) {
+ return queue_push(queue, data, 1) == 1 ? 0 : -1;
+}
+
+
+static int8_t queue_pop_attempt(void *queue, void **data) {
+ return queue_pop(queue, data, 1) == 1 ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new ring
+  @param    capacity    Most items held, rounded up to a power of two
+  @return   New Splash_ring otherwise NULL.
+
+  Creates a new Splash_ring object destroy with splash_ring_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_ring *splash_ring_create(int32_t capacity) {
+  capacity = round_capacity(capacity);
+  if (capacity == 0) {
+    return NULL;
+  }
+
+  Splash_ring *ring = malloc(sizeof(Splash_ring));
+  if (!ring) {
+    return NULL;
+  }
+
+  ring->data = malloc((size_t)capacity * sizeof(void *));
+  int8_t waiting = wait_create(&ring->wait);
+  if (ring->data == NULL || waiting == -1) {
+    wait_destroy(&ring->wait);
+    free(ring->data);
+    free(ring);
+    return NULL;
+  }
+
+  ring->mask = (uint32_t)capacity - 1;
+  ring->capacity = capacity;
+  SDL_AtomicSet(&ring->tail, 0);
+  SDL_AtomicSet(&ring->head, 0);
+  ring->head_cache = 0;
+  ring->tail_cache = 0;
+ return ring;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item
+  @param    ring      The ring
+  @param    data      The item
+  @return   0 on success else -1 if the ring is full
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_ring_push(Splash_ring *ring, void *data) {
+ return splash_ring_push_batch(ring, &data, 1) == 1 ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item
+  @param    ring      The ring
+  @param    data      Set to the item
+  @return   0 on success else -1 if the ring is empty
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_ring_pop(Splash_ring *ring, void **data) {
+ return splash_ring_pop_batch(ring, data, 1) == 1 ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items
+  @param    ring      The ring
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_ring_push_batch(Splash_ring *ring, void **data, int32_t count) {
+  int32_t done = ring_push(ring, data, count);
+
+  if (done > 0) {
+    wait_notify(&ring->wait);
+  }
+ return done;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items
+  @param    ring      The ring
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_ring_pop_batch(Splash_ring *ring, void **data, int32_t count) {
+  int32_t done = ring_pop(ring, data, count);
+
+  if (done > 0) {
+    wait_notify(&ring->wait);
+  }
+ return done;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item, waiting while the ring is full
+  @param    ring      The ring
+  @param    data      The item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_ring_push_wait(Splash_ring *ring, void *data, int32_t timeout) {
+ return wait_for(&ring->wait, ring_push_attempt, ring, &data, timeout);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item, waiting while the ring is empty
+  @param    ring      The ring
+  @param    data      Set to the item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_ring_pop_wait(Splash_ring *ring, void **data, int32_t timeout) {
+ return wait_for(&ring->wait, ring_pop_attempt, ring, data, timeout);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of items
+  @param    ring      The ring
+  @return   Number of items, only a hint while other threads use the ring
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_ring_get_size(Splash_ring *ring) {
+  uint32_t head = (uint32_t)SDL_AtomicGet(&ring->head);
+  uint32_t tail = (uint32_t)SDL_AtomicGet(&ring->tail);
+ return (int32_t)(tail - head);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity
+  @param    ring      The ring
+  @return   Most items held
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_ring_get_capacity(Splash_ring *ring) {
+ return ring->capacity;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the ring
+  @param    ring      The ring
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_ring_destroy(Splash_ring *ring) {
+  wait_destroy(&ring->wait);
+  free(ring->data);
+  free(ring);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new queue
+  @param    capacity    Most items held, rounded up to a power of two
+  @return   New Splash_queue otherwise NULL.
+
+  Creates a new Splash_queue object destroy with splash_queue_destroy();
+  Every cell starts ready to be pushed at its own position.
+
+\-----------------------------------------------------------------------------*/
+Splash_queue *splash_queue_create(int32_t capacity) {
+  int32_t i;
+
+  capacity = round_capacity(capacity);
+  if (capacity == 0) {
+    return NULL;
+  }
+
+  Splash_queue *queue = malloc(sizeof(Splash_queue));
+  if (!queue) {
+    return NULL;
+  }
+
+  queue->cells = malloc((size_t)capacity * sizeof(Splash_queue_cell));
+  int8_t waiting = wait_create(&queue->wait);
+  if (queue->cells == NULL || waiting == -1) {
+    wait_destroy(&queue->wait);
+    free(queue->cells);
+    free(queue);
+    return NULL;
+  }
+
+  for (i = 0; i < capacity; i++) {
+    SDL_AtomicSet(&queue->cells[i].sequence, i);
+  }
+
+  queue->mask = (uint32_t)capacity - 1;
+  queue->capacity = capacity;
+  SDL_AtomicSet(&queue->tail, 0);
+  SDL_AtomicSet(&queue->head, 0);
+ return queue;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item
+  @param    queue     The queue
+  @param    data      The item
+  @return   0 on success else -1 if the queue is full
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_queue_push(Splash_queue *queue, void *data) {
+ return splash_queue_push_batch(queue, &data, 1) == 1 ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item
+  @param    queue     The queue
+  @param    data      Set to the item
+  @return   0 on success else -1 if the queue is empty
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_queue_pop(Splash_queue *queue, void **data) {
+ return splash_queue_pop_batch(queue, data, 1) == 1 ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes many items
+  @param    queue     The queue
+  @param    data      The items
+  @param    count     Number of items
+  @return   Number of items pushed
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_queue_push_batch(Splash_queue *queue, void **data, int32_t count) {
+  int32_t done = queue_push(queue, data, count);
+
+  if (done > 0) {
+    wait_notify(&queue->wait);
+  }
+ return done;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops many items
+  @param    queue     The queue
+  @param    data      Filled with the items
+  @param    count     Most items to pop
+  @return   Number of items popped
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_queue_pop_batch(Splash_queue *queue, void **data, int32_t count) {
+  int32_t done = queue_pop(queue, data, count);
+
+  if (done > 0) {
+    wait_notify(&queue->wait);
+  }
+ return done;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an item, waiting while the queue is full
+  @param    queue     The queue
+  @param    data      The item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_queue_push_wait(Splash_queue *queue, void *data, int32_t timeout) {
+ return wait_for(&queue->wait, queue_push_attempt, queue, &data, timeout);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pops an item, waiting while the queue is empty
+  @param    queue     The queue
+  @param    data      Set to the item
+  @param    timeout   Most milliseconds to wait, SPLASH_QUEUE_WAIT_FOREVER to not give up
+  @return   0 on success else -1 if timed out
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_queue_pop_wait(Splash_queue *queue, void **data, int32_t timeout) {
+ return wait_for(&queue->wait, queue_pop_attempt, queue, data, timeout);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of items
+  @param    queue     The queue
+  @return   Number of items, only a hint while other threads use the queue
+
+  Claimed positions count, so it can be off by the pushes and pops in
+  flight.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_queue_get_size(Splash_queue *queue) {
+  uint32_t head = (uint32_t)SDL_AtomicGet(&queue->head);
+  uint32_t tail = (uint32_t)SDL_AtomicGet(&queue->tail);
+  int32_t size = (int32_t)(tail - head);
+
+  if (size < 0) {
+    return 0;
+  }
+  if (size > queue->capacity) {
+    return queue->capacity;
+  }
+ return size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the capacity
+  @param    queue     The queue
+  @return   Most items held
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_queue_get_capacity(Splash_queue *queue) {
+ return queue->capacity;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the queue
+  @param    queue     The queue
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_queue_destroy(Splash_queue *queue) {
+  wait_destroy(&queue->wait);
+  free(queue->cells);
+  free(queue);
+}
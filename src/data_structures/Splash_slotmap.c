@@ -0,0 +1,274 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_slotmap.c
+   @author  P. Batty
+   @brief   The slot map structs
+
+   This module implements slot maps. Elements are stored packed together
+   for iteration and reached through handles of a slot index and a
+   generation, a handle to a removed element is detected instead of
+   reaching whatever took its place.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_slotmap.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define INITIAL_CAPACITY 16   /**< elements of the first block */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Grows the packed elements and slots
+  @param    slotmap   The slot map
+  @return   0 on success else -1
+
+  Doubles the capacity, there is a slot for every element that fits.
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow(Splash_slotmap *slotmap) {
+  if (slotmap->capacity > INT32_MAX / 2) {
+    return -1;
+  }
+
+  int32_t capacity = slotmap->capacity ? slotmap->capacity << 1 : INITIAL_CAPACITY;
+
+  char *data = realloc(slotmap->data, (size_t)capacity * slotmap->element_size);
+  if (data == NULL) {
+    return -1;
+  }
+  slotmap->data = data;
+
+  uint32_t *dense_slot = realloc(slotmap->dense_slot, (size_t)capacity * sizeof(uint32_t));
+  if (dense_slot == NULL) {
+    return -1;
+  }
+  slotmap->dense_slot = dense_slot;
+
+  Splash_slotmap_slot *slots = realloc(slotmap->slots, (size_t)capacity * sizeof(Splash_slotmap_slot));
+  if (slots == NULL) {
+    return -1;
+  }
+  slotmap->slots = slots;
+
+  slotmap->capacity = capacity;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the slot of a live handle
+  @param    slotmap   The slot map
+  @param    handle    The handle
+  @return   The slot else NULL if the handle is stale
+
+  A handle is live when its slot was made and the slot generation still
+  matches the generation in the handle.
+
+\-----------------------------------------------------------------------------*/
+static Splash_slotmap_slot *find(Splash_slotmap *slotmap, Splash_handle handle) {
+  uint32_t index = SPLASH_HANDLE_INDEX(handle);
+
+  if (index >= (uint32_t)slotmap->slot_count || slotmap->slots[index].generation != SPLASH_HANDLE_GENERATION(handle)) {
+    return NULL;
+  }
+ return &slotmap->slots[index];
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new slot map
+  @param    element_size  Bytes in an element
+  @return   New Splash_slotmap otherwise NULL.
+
+  Creates a new Splash_slotmap object destroy with splash_slotmap_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_slotmap *splash_slotmap_create(int32_t element_size) {
+  if (element_size <= 0) {
+    return NULL;
+  }
+
+  Splash_slotmap *slotmap = malloc(sizeof(Splash_slotmap));
+  if (!slotmap) {
+    return NULL;
+  }
+
+  slotmap->element_size = element_size;
+  slotmap->data = NULL;
+  slotmap->dense_slot = NULL;
+  slotmap->slots = NULL;
+  slotmap->size = 0;
+  slotmap->capacity = 0;
+  slotmap->slot_count = 0;
+  slotmap->free_slot = -1;
+ return slotmap;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Inserts an element
+  @param    slotmap   The slot map
+  @param    value     The element to copy in, NULL for a zeroed one
+  @return   The handle of the element else SPLASH_HANDLE_NULL
+
+  O(1) amortized, freed slots are reused with a new generation.
+
+\-----------------------------------------------------------------------------*/
+Splash_handle splash_slotmap_insert(Splash_slotmap *slotmap, const void *value) {
+  int32_t index;
+
+  if (slotmap->size == slotmap->capacity && grow(slotmap) == -1) {
+    return SPLASH_HANDLE_NULL;
+  }
+
+  if (slotmap->free_slot != -1) {
+    index = slotmap->free_slot;
+    slotmap->free_slot = slotmap->slots[index].dense;
+  } else {
+    index = slotmap->slot_count++;
+    slotmap->slots[index].generation = 1;
+  }
+
+  Splash_slotmap_slot *slot = &slotmap->slots[index];
+  char *element = slotmap->data + (size_t)slotmap->size * slotmap->element_size;
+  if (value != NULL) {
+    memcpy(element, value, slotmap->element_size);
+  } else {
+    memset(element, 0, slotmap->element_size);
+  }
+
+  slot->dense = slotmap->size;
+  slotmap->dense_slot[slotmap->size] = index;
+  slotmap->size++;
+ return ((Splash_handle)slot->generation << 32) | (uint32_t)index;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets an element
+  @param    slotmap   The slot map
+  @param    handle    The handle
+  @return   The element else NULL if the handle is stale
+
+  The pointer is valid until the next insert or remove.
+
+\-----------------------------------------------------------------------------*/
+void *splash_slotmap_get(Splash_slotmap *slotmap, Splash_handle handle) {
+  Splash_slotmap_slot *slot = find(slotmap, handle);
+
+  if (slot == NULL) {
+    return NULL;
+  }
+ return slotmap->data + (size_t)slot->dense * slotmap->element_size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes an element
+  @param    slotmap   The slot map
+  @param    handle    The handle
+  @return   1 if removed else 0 if the handle is stale
+
+  The slot generation is bumped, skipping 0 so no handle is ever NULL.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_slotmap_remove(Splash_slotmap *slotmap, Splash_handle handle) {
+  Splash_slotmap_slot *slot = find(slotmap, handle);
+
+  if (slot == NULL) {
+    return 0;
+  }
+
+  int32_t hole = slot->dense;
+  int32_t last = --slotmap->size;
+  if (hole != last) {
+    memcpy(slotmap->data + (size_t)hole * slotmap->element_size, slotmap->data + (size_t)last * slotmap->element_size, slotmap->element_size);
+    slotmap->dense_slot[hole] = slotmap->dense_slot[last];
+    slotmap->slots[slotmap->dense_slot[hole]].dense = hole;
+  }
+
+  if (++slot->generation == 0) {
+    slot->generation = 1;
+  }
+  slot->dense = slotmap->free_slot;
+  slotmap->free_slot = SPLASH_HANDLE_INDEX(handle);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of elements
+  @param    slotmap   The slot map
+  @return   Number of elements
+
+  Gets the number of live elements, the packed elements run from 0 to it.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_slotmap_get_size(Splash_slotmap *slotmap) {
+ return slotmap->size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the packed elements
+  @param    slotmap   The slot map
+  @return   The first element
+
+  Gets the elements packed together for iteration, the order changes
+  when an element is removed.
+
+\-----------------------------------------------------------------------------*/
+void *splash_slotmap_get_data(Splash_slotmap *slotmap) {
+ return slotmap->data;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the handle of a packed element
+  @param    slotmap   The slot map
+  @param    pos       Position in the packed elements
+  @return   The handle else SPLASH_HANDLE_NULL
+
+  Gets the handle of an element found by walking the packed elements so
+  it can be removed or kept.
+
+\-----------------------------------------------------------------------------*/
+Splash_handle splash_slotmap_get_handle(Splash_slotmap *slotmap, int32_t pos) {
+  if (pos < 0 || pos >= slotmap->size) {
+    return SPLASH_HANDLE_NULL;
+  }
+
+  uint32_t index = slotmap->dense_slot[pos];
+ return ((Splash_handle)slotmap->slots[index].generation << 32) | index;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the slot map
+  @param    slotmap   The slot map
+  @return   Void
+
+  Frees the elements and the slots, every handle of the slot map is
+  stale after.
+
+\-----------------------------------------------------------------------------*/
+void splash_slotmap_destroy(Splash_slotmap *slotmap) {
+  free(slotmap->data);
+  free(slotmap->dense_slot);
+  free(slotmap->slots);
+  free(slotmap);
+}
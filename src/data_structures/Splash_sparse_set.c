@@ -0,0 +1,239 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_sparse_set.c
+   @author  P. Batty
+   @brief   The sparse set structs
+
+   This module implements sets of integer ids. A sparse array indexed by
+   id points into a dense array of the members, so inserting, removing
+   and membership checks are O(1) and the members can be walked packed.
+
+   An id is a member when its sparse entry is inside the dense array and
+   the dense entry there points back at it, so stale sparse entries left
+   by removes never need clearing.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_sparse_set.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define INITIAL_CAPACITY 64   /**< entries of the first blocks */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Grows the sparse array to hold an id
+  @param    set     The set
+  @param    id      The id
+  @return   0 on success else -1
+
+  New entries are zeroed so they are never read uninitialised.
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow_sparse(Splash_sparse_set *set, uint32_t id) {
+  uint64_t capacity = set->sparse_capacity ? set->sparse_capacity : INITIAL_CAPACITY;
+
+  while (capacity <= id) {
+    capacity <<= 1;
+  }
+  if (capacity > UINT32_MAX) {
+    capacity = UINT32_MAX;
+  }
+
+  uint32_t *sparse = realloc(set->sparse, (size_t)capacity * sizeof(uint32_t));
+  if (sparse == NULL) {
+    return -1;
+  }
+
+  memset(sparse + set->sparse_capacity, 0, (size_t)(capacity - set->sparse_capacity) * sizeof(uint32_t));
+  set->sparse = sparse;
+  set->sparse_capacity = (uint32_t)capacity;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Doubles the dense array
+  @param    set     The set
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow_dense(Splash_sparse_set *set) {
+  if (set->dense_capacity > INT32_MAX / 2) {
+    return -1;
+  }
+
+  int32_t capacity = set->dense_capacity ? set->dense_capacity << 1 : INITIAL_CAPACITY;
+
+  uint32_t *dense = realloc(set->dense, (size_t)capacity * sizeof(uint32_t));
+  if (dense == NULL) {
+    return -1;
+  }
+
+  set->dense = dense;
+  set->dense_capacity = capacity;
+ return 0;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new sparse set
+  @return   New Splash_sparse_set otherwise NULL.
+
+  Creates a new Splash_sparse_set object destroy with splash_sparse_set_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_sparse_set *splash_sparse_set_create() {
+  Splash_sparse_set *set = malloc(sizeof(Splash_sparse_set));
+
+  if (!set) {
+    return NULL;
+  }
+
+  set->dense = NULL;
+  set->sparse = NULL;
+  set->size = 0;
+  set->dense_capacity = 0;
+  set->sparse_capacity = 0;
+ return set;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Inserts an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if inserted, 0 if already a member else -1
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_sparse_set_insert(Splash_sparse_set *set, uint32_t id) {
+  if (splash_sparse_set_contains(set, id)) {
+    return 0;
+  }
+
+  if (id == UINT32_MAX) {
+    return -1;
+  }
+  if (id >= set->sparse_capacity && grow_sparse(set, id) == -1) {
+    return -1;
+  }
+  if (set->size == set->dense_capacity && grow_dense(set) == -1) {
+    return -1;
+  }
+
+  set->sparse[id] = set->size;
+  set->dense[set->size++] = id;
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if removed else 0 if it was not a member
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_sparse_set_remove(Splash_sparse_set *set, uint32_t id) {
+  if (!splash_sparse_set_contains(set, id)) {
+    return 0;
+  }
+
+  uint32_t pos = set->sparse[id];
+  uint32_t last = set->dense[--set->size];
+
+  set->dense[pos] = last;
+  set->sparse[last] = pos;
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks for an id
+  @param    set     The set
+  @param    id      The id
+  @return   1 if a member else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_sparse_set_contains(Splash_sparse_set *set, uint32_t id) {
+  if (id >= set->sparse_capacity) {
+    return 0;
+  }
+
+  uint32_t pos = set->sparse[id];
+ return pos < (uint32_t)set->size && set->dense[pos] == id;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the position of an id
+  @param    set     The set
+  @param    id      The id
+  @return   Position in splash_sparse_set_get_data(); else -1
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_sparse_set_get_position(Splash_sparse_set *set, uint32_t id) {
+  if (!splash_sparse_set_contains(set, id)) {
+    return -1;
+  }
+ return (int32_t)set->sparse[id];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the members
+  @param    set     The set
+  @return   The first member
+
+\-----------------------------------------------------------------------------*/
+uint32_t *splash_sparse_set_get_data(Splash_sparse_set *set) {
+ return set->dense;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of members
+  @param    set     The set
+  @return   Number of members
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_sparse_set_get_size(Splash_sparse_set *set) {
+ return set->size;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes every member
+  @param    set     The set
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_sparse_set_remove_all(Splash_sparse_set *set) {
+  set->size = 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys the sparse set
+  @param    set     The set
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_sparse_set_destroy(Splash_sparse_set *set) {
+  free(set->dense);
+  free(set->sparse);
+  free(set);
+}
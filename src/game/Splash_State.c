@@ -15,33 +15,260 @@
  ---------------------------------------------------------------------------*/
 
 #include "Splash/Splash_state.h"
-#include "Splash/Splash_hashmap.h"
+#include "Splash/Splash_handle.h"
+#include "Splash/Splash_replay.h"
+#include "Splash/Splash_timer.h"
+#include "Splash/Splash_lua_wrapper.h"
+#include "Splash/Splash_lua_memory.h"
+#include "Splash/Splash_lua_profiler.h"
+#include "Splash/Splash_lua_reload.h"
 #include "lua/lua.h"
 #include "../wrapper/lua_wrapper/game/l_splash_state.h"
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 /*---------------------------------------------------------------------------
                             Private functions
  ---------------------------------------------------------------------------*/
 
-static Splash_hashmap *states;        /**< hashmap if states */
+static Splash_state **states;         /**< states indexed by handle */
+static char **state_names;            /**< interned state names indexed by handle */
+static int32_t state_count;           /**< number of handles given out */
+static int32_t state_capacity;        /**< size of the state arrays */
+static Splash_state_handle *name_index; /**< open addressed name to handle lookup */
+static int32_t name_index_size;       /**< size of the name lookup, power of two */
 static Splash_state *current_state;   /**< the current state */
 
 static int8_t state_running;          /**< is the state machine running */
 static int32_t max_ticks;             /**< number of ticks per second */
 static double ns;                     /**< nanoseconds */
+static double state_clock;            /**< state machine time in milliseconds */
 
 static int32_t uptime;                /**< how long has it been running*/
 static int32_t state_uptime;          /**< how long have we been in this state */
 static int32_t frames;                /**< our fps */
 
+static Splash_replay *recorder;       /**< the log being recorded to */
+static Splash_replay *player;         /**< the log being replayed */
+static uint32_t replay_elapsed;       /**< length of the last replayed frame */
+static uint32_t replay_timer;         /**< replayed milliseconds since the last second */
+static int32_t replay_fps;            /**< frames replayed since the last second */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes a state name
+  @param    name  The name to hash
+  @return   Hash
+
+  FNV-1a hash of the state name
+
+\-----------------------------------------------------------------------------*/
+static uint32_t hash_name(const char *name) {
+  uint32_t hash = 2166136261u;
+
+  while (*name) {
+    hash ^= (uint8_t)*name++;
+    hash *= 16777619u;
+  }
+
+ return hash;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the handle for a name
+  @param    name  The name to search for
+  @return   The handle else SPLASH_STATE_INVALID_HANDLE
+
+  Probes the name index, comparing the interned names by content.
+
+\-----------------------------------------------------------------------------*/
+static Splash_state_handle find_handle(const char *name) {
+  if (name == NULL || name_index == NULL) {
+    return SPLASH_STATE_INVALID_HANDLE;
+  }
+
+  int32_t mask = name_index_size - 1;
+  int32_t i = hash_name(name) & mask;
+  Splash_state_handle handle;
+
+  while ((handle = name_index[i]) != SPLASH_STATE_INVALID_HANDLE) {
+    if (state_names[handle] == name || strcmp(state_names[handle], name) == 0) {
+      return handle;
+    }
+    i = (i + 1) & mask;
+  }
+
+ return SPLASH_STATE_INVALID_HANDLE;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Inserts a handle into the name index
+  @param    handle  The handle to insert
+  @return   Void
+
+  Inserts a handle into the name index, the index must have a free slot.
+
+\-----------------------------------------------------------------------------*/
+static void index_handle(Splash_state_handle handle) {
+  int32_t mask = name_index_size - 1;
+  int32_t i = hash_name(state_names[handle]) & mask;
+
+  while (name_index[i] != SPLASH_STATE_INVALID_HANDLE) {
+    i = (i + 1) & mask;
+  }
+  name_index[i] = handle;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Grows the state tables
+  @param    capacity  The new capacity
+  @return   0 on success else -1
+
+  Grows the state arrays and rebuilds the name index so it stays at most
+  half full. The tables are only replaced once every allocation succeeds,
+  on failure the old tables are kept as they were.
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow_tables(int32_t capacity) {
+  Splash_state **new_states = malloc(capacity * sizeof(Splash_state *));
+  char **new_names = malloc(capacity * sizeof(char *));
+  Splash_state_handle *new_index = malloc(capacity * 2 * sizeof(Splash_state_handle));
+
+  if (!new_states || !new_names || !new_index) {
+    free(new_states);
+    free(new_names);
+    free(new_index);
+    return -1;
+  }
+
+  if (state_count > 0) {
+    memcpy(new_states, states, state_count * sizeof(Splash_state *));
+    memcpy(new_names, state_names, state_count * sizeof(char *));
+  }
+
+  free(states);
+  free(state_names);
+  states = new_states;
+  state_names = new_names;
+
+  free(name_index);
+  name_index = new_index;
+  name_index_size = capacity * 2;
+  memset(name_index, 0xff, name_index_size * sizeof(Splash_state_handle));
+  state_capacity = capacity;
+
+  Splash_state_handle i;
+  for (i = 0; i < state_count; i++) {
+    index_handle(i);
+  }
+
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Updates the current state
+  @param    delta   The delta time
+  @return   Void
+
+  Advances the clock by a tick, fires the timers that are due and calls
+  the update function of the current state
+
+\-----------------------------------------------------------------------------*/
+static void state_update(float delta) {
+    Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_UPDATE);
+    state_clock += ns;
+    splash_timer_advance((uint32_t)state_clock);
+
+    if (current_state->lua) {
+        l_splash_state_call_update(current_state, delta);
+    } else {
+        current_state->update(delta);
+    }
+    splash_lua_profiler_phase(phase);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Passes an event to the current state
+  @param    event   The event
+  @return   Void
+
+  Stops the machine on quit and calls the event function of the current state
+
+\-----------------------------------------------------------------------------*/
+static void state_event(SDL_Event event) {
+    if (event.type == SDL_QUIT) {
+      splash_state_stop();
+    }
+
+    Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_EVENT);
+    if (current_state->lua) {
+        l_splash_state_call_event(current_state, event);
+    } else {
+        current_state->event(event);
+    }
+    splash_lua_profiler_phase(phase);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Renders the current state
+  @return   Void
+
+  Calls the render function of the current state
+
+\-----------------------------------------------------------------------------*/
+static void state_render() {
+    Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_RENDER);
+    if (current_state->lua) {
+        l_splash_state_call_render(current_state);
+    } else {
+        current_state->render();
+    }
+    splash_lua_profiler_phase(phase);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Enters the first state
+  @param    handle  The state handle to start with
+  @param    data    Any data to pass in to the init
+  @return   0 on success else -1
+
+  Makes the state current and calls its init function
+
+\-----------------------------------------------------------------------------*/
+static int8_t state_enter(Splash_state_handle handle, void *data) {
+    Splash_state *state = splash_state_get_state_handle(handle);
+
+    if (state == NULL) {
+      return -1;
+    }
+
+    current_state = state;
+    state_clock = splash_timer_get_time();
+    Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_INIT);
+    if (current_state->lua) {
+        l_splash_state_call_init(current_state, state->name, data);
+    } else {
+        current_state->init(state->name, data);
+    }
+    splash_lua_profiler_phase(phase);
+  return 0;
+}
+
 
 /*!--------------------------------------------------------------------------
   @brief    The state machine
   @return   Void
 
-  The state machine 
+  The state machine, when recording every update, event and frame is
+  written to the log.
 
 \-----------------------------------------------------------------------------*/
 static void splash_state_run() {
@@ -50,6 +277,7 @@ static void splash_state_run() {
     long lastTime = SDL_GetTicks();
     ns = 1000.0 / max_ticks;
     Uint32 timer = SDL_GetTicks();
+    Uint32 frame_time = timer;
     float delta = 0;
     double fps = 0;
     double tick = 0;
@@ -63,23 +291,16 @@ static void splash_state_run() {
         lastTime = now;
 
         while (delta >= 1) {
-
-            if (current_state->lua) {
-                l_splash_state_call_update(current_state, delta);
-            } else {
-              current_state->update(delta);
+            if (recorder) {
+              splash_replay_write_update(recorder, delta);
             }
+            state_update(delta);
 
             while(SDL_PollEvent(&event)) {
-              if (event.type == SDL_QUIT) {
-                splash_state_stop();
-              }
-
-              if (current_state->lua) {
-                  l_splash_state_call_event(current_state, event);
-              } else {
-                  current_state->event(event);
+              if (recorder) {
+                splash_replay_write_event(recorder, &event);
               }
+              state_event(event);
             }
 
           tick++;
@@ -87,12 +308,19 @@ static void splash_state_run() {
         }
         fps++;
 
-        if (current_state->lua) {
-            l_splash_state_call_render(current_state);
-        } else {
-           current_state->render();
+        state_render();
+
+        if (recorder) {
+          splash_replay_write_frame(recorder, now - frame_time);
+          frame_time = now;
         }
 
+        // collect in the time left before the next tick
+        splash_lua_end_frame(splash_lua_state, (1 - delta) * ns - (SDL_GetTicks() - lastTime));
+
+        // swap in changed scripts between frames
+        splash_lua_reload_changed(splash_lua_state);
+
         if (SDL_GetTicks() - timer > 1000) {
           timer += 1000;
           uptime++;
@@ -102,6 +330,8 @@ static void splash_state_run() {
           tick = 0;
         }
     }
+
+    splash_state_record_stop();
 }
 
 
@@ -118,8 +348,14 @@ static void splash_state_run() {
 
 \-----------------------------------------------------------------------------*/
 int8_t splash_state_init() {
-  states = splash_hashmap_create();
-  if (states == NULL) {
+  states = NULL;
+  state_names = NULL;
+  name_index = NULL;
+  state_count = 0;
+  state_capacity = 0;
+  current_state = NULL;
+
+  if (grow_tables(16) == -1) {
     return -1;
   }
 
@@ -131,7 +367,11 @@ int8_t splash_state_init() {
   frames = 0;
   ns = 0;
 
- return 0;
+  recorder = NULL;
+  player = NULL;
+  state_clock = 0;
+
+ return splash_timer_init();
 }
 
 
@@ -143,7 +383,27 @@ int8_t splash_state_init() {
 
 \-----------------------------------------------------------------------------*/
 void splash_state_quit() {
-  splash_hashmap_destory(states);
+  splash_state_record_stop();
+  if (player) {
+    splash_replay_close(player);
+    player = NULL;
+  }
+  splash_timer_quit();
+
+  Splash_state_handle i;
+  for (i = 0; i < state_count; i++) {
+    free(state_names[i]);
+  }
+
+  free(states);
+  free(state_names);
+  free(name_index);
+  states = NULL;
+  state_names = NULL;
+  name_index = NULL;
+  state_count = 0;
+  state_capacity = 0;
+  current_state = NULL;
   state_running = 0;
   max_ticks = 60;
 
@@ -151,6 +411,7 @@ void splash_state_quit() {
   state_uptime = 0;
   frames = 0;
   ns = 0;
+  state_clock = 0;
 }
 
 
@@ -191,27 +452,67 @@ Splash_state *splash_state_create(char *name, void (* init)(char *, void *), voi
     }
 
     state->name = name;
+    state->handle = SPLASH_STATE_INVALID_HANDLE;
     state->lua = 0;
     state->init = init;
     state->update = update;
     state->event = event;
     state->render = render;
     state->cleanup = cleanup;
+    state->id = splash_handle_create(state);
 
   return state;
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a state
+  @param    state       The state to destroy
+  @return   Void
+
+  Drops the handle of the state and frees it.
+
+\-----------------------------------------------------------------------------*/
+void splash_state_destroy(Splash_state *state) {
+  splash_handle_destroy(state->id);
+  free(state);
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Adds a state to the machine
   @param    state       The state to add
-  @return   Void
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
 
-  Adds a state to the machine
+  Adds a state to the machine. The name is interned by the machine, adding
+  a state with a name that was used before gives back the same handle.
 
 \-----------------------------------------------------------------------------*/
-void splash_state_add(Splash_state *state) {
-    splash_hashmap_add(states, state->name, state);
+Splash_state_handle splash_state_add(Splash_state *state) {
+    Splash_state_handle handle = find_handle(state->name);
+
+    if (handle == SPLASH_STATE_INVALID_HANDLE) {
+      if (state_count == state_capacity && grow_tables(state_capacity * 2) == -1) {
+        return SPLASH_STATE_INVALID_HANDLE;
+      }
+
+      size_t length = strlen(state->name) + 1;
+      char *name = malloc(length);
+      if (!name) {
+        return SPLASH_STATE_INVALID_HANDLE;
+      }
+      memcpy(name, state->name, length);
+
+      handle = state_count++;
+      state_names[handle] = name;
+      index_handle(handle);
+    }
+
+    states[handle] = state;
+    state->name = state_names[handle];
+    state->handle = handle;
+
+  return handle;
 }
 
 
@@ -224,7 +525,11 @@ void splash_state_add(Splash_state *state) {
 
 \-----------------------------------------------------------------------------*/
 void splash_state_remove(char *state_name) {
-  splash_hashmap_remove(states, state_name);
+  Splash_state_handle handle = find_handle(state_name);
+
+  if (handle != SPLASH_STATE_INVALID_HANDLE) {
+    states[handle] = NULL;
+  }
 }
 
 
@@ -238,17 +543,22 @@ void splash_state_remove(char *state_name) {
 
 \-----------------------------------------------------------------------------*/
 void splash_state_start(char *state_name, void *data) {
+    splash_state_start_handle(find_handle(state_name), data);
+}
 
-    current_state = splash_hashmap_get(states, state_name);
 
-    if (current_state == (void *)-1) {
-      return;
-    }
+/*!--------------------------------------------------------------------------
+  @brief    Starts the splash state
+  @param    handle      The state handle to start with
+  @param    data        Any data to pass in to the init
+  @return   Void
 
-    if (current_state->lua) {
-        l_splash_state_call_init(current_state, state_name, data);
-    } else {
-        current_state->init(state_name, data);
+  Starts the splash state machine without looking up the state name
+
+\-----------------------------------------------------------------------------*/
+void splash_state_start_handle(Splash_state_handle handle, void *data) {
+    if (state_enter(handle, data) == -1) {
+      return;
     }
     splash_state_run();
 }
@@ -264,25 +574,50 @@ void splash_state_start(char *state_name, void *data) {
 
 \-----------------------------------------------------------------------------*/
 void splash_state_switch(char *state_name, void *data) {
-    Splash_state *next = splash_hashmap_get(states, state_name);
+    splash_state_switch_handle(find_handle(state_name), data);
+}
 
-    if (next == (void *)-1) {
+
+/*!--------------------------------------------------------------------------
+  @brief    Switchs the current state
+  @param    handle      The state handle to switch to
+  @param    data        Any data to pass in to the init
+  @return   Void
+
+  Switches the state machine without looking up the state name
+
+\-----------------------------------------------------------------------------*/
+void splash_state_switch_handle(Splash_state_handle handle, void *data) {
+    Splash_state *next = splash_state_get_state_handle(handle);
+
+    if (next == NULL) {
       return;
     }
 
+    Splash_state *previous = current_state;
+    current_state = next;
+    if (previous == next) {
+      splash_timer_clear_state(previous->handle);
+    }
+
+    Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_INIT);
     if (next->lua) {
-        l_splash_state_call_init(next, state_name, data);
+        l_splash_state_call_init(next, next->name, data);
     } else {
-        next->init(state_name, data);
+        next->init(next->name, data);
     }
 
-    if (current_state->lua) {
-        l_splash_state_call_cleanup(current_state, state_name);
+    splash_lua_profiler_phase(SPLASH_PROFILER_CLEANUP);
+    if (previous->lua) {
+        l_splash_state_call_cleanup(previous, next->name);
     } else {
-        current_state->cleanup(state_name);
+        previous->cleanup(next->name);
     }
+    splash_lua_profiler_phase(phase);
 
-    current_state = next;
+    if (previous != next) {
+      splash_timer_clear_state(previous->handle);
+    }
     state_uptime = 0;
 }
 
@@ -295,11 +630,14 @@ void splash_state_switch(char *state_name, void *data) {
 
 \-----------------------------------------------------------------------------*/
 void splash_state_stop() {
+  Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_CLEANUP);
   if (current_state->lua) {
     l_splash_state_call_cleanup(current_state, "");
   } else {
     current_state->cleanup("");
   }
+  splash_lua_profiler_phase(phase);
+  splash_timer_clear_state(current_state->handle);
   state_running = 0;
 }
 
@@ -325,7 +663,207 @@ void splash_state_set_ticks(int32_t ticks) {
 
 \-----------------------------------------------------------------------------*/
 Splash_state *splash_state_get_state(char *state_name) {
-  return splash_hashmap_get(states, state_name);
+  return splash_state_get_state_handle(find_handle(state_name));
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a state
+  @param    handle      The state handle
+  @return   Splash_state object else NULL
+
+  Gets the splash state tied to the handle else returns NULL
+
+\-----------------------------------------------------------------------------*/
+Splash_state *splash_state_get_state_handle(Splash_state_handle handle) {
+  if (handle < 0 || handle >= state_count) {
+    return NULL;
+  }
+  return states[handle];
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a state handle
+  @param    state_name  The state name
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Looks up the handle for the state name, names are compared by content.
+
+\-----------------------------------------------------------------------------*/
+Splash_state_handle splash_state_get_handle(char *state_name) {
+  return find_handle(state_name);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Records the state machine
+  @param    path    Path to the log file
+  @return   0 on success else -1
+
+  Records every update, event and frame of the next run to the log. The
+  recording stops when the state machine stops.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_state_record(const char *path) {
+  splash_state_record_stop();
+  recorder = splash_replay_record(path, max_ticks);
+ return recorder ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops recording
+  @return   Void
+
+  Stops recording and closes the log
+
+\-----------------------------------------------------------------------------*/
+void splash_state_record_stop() {
+  if (recorder) {
+    splash_replay_close(recorder);
+    recorder = NULL;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Replays a log
+  @param    path        Path to the log file
+  @param    state_name  The state name to start with
+  @param    data        Any data to pass in to the init
+  @param    speed       Replay speed, 1 is real time, 0 or less is as fast as possible
+  @return   0 on success else -1
+
+  Drives the states from a recorded log without a window, render is not
+  called.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_state_replay(const char *path, char *state_name, void *data, float speed) {
+  if (splash_state_replay_begin(path, state_name, data) == -1) {
+    return -1;
+  }
+
+  Uint32 start = SDL_GetTicks();
+  double played = 0;
+
+  while (splash_state_replay_step()) {
+    if (speed > 0) {
+      played += replay_elapsed / speed;
+      int32_t wait = (int32_t)(start + played - SDL_GetTicks());
+      if (wait > 0) {
+        SDL_Delay(wait);
+      }
+    }
+  }
+
+  splash_state_replay_end();
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Begins a frame stepped replay
+  @param    path        Path to the log file
+  @param    state_name  The state name to start with
+  @param    data        Any data to pass in to the init
+  @return   0 on success else -1
+
+  Opens the log and enters the first state, step through the log with
+  splash_state_replay_step(); and finish with splash_state_replay_end();
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_state_replay_begin(const char *path, char *state_name, void *data) {
+  if (player) {
+    splash_state_replay_end();
+  }
+
+  player = splash_replay_open(path);
+  if (player == NULL) {
+    return -1;
+  }
+
+  splash_state_set_ticks(player->ticks);
+  uptime = 0;
+  state_uptime = 0;
+  replay_elapsed = 0;
+  replay_timer = 0;
+  replay_fps = 0;
+
+  if (state_enter(splash_state_get_handle(state_name), data) == -1) {
+    splash_replay_close(player);
+    player = NULL;
+    return -1;
+  }
+
+  state_running = 1;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Replays one frame
+  @return   1 if a frame was replayed else 0
+
+  Replays the updates and events of the next recorded frame, returns 0
+  once the log ends or the state machine stops.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_state_replay_step() {
+  Splash_replay_record record;
+
+  if (player == NULL) {
+    return 0;
+  }
+
+  while (splash_replay_read(player, &record) != SPLASH_REPLAY_END) {
+    switch (record.type) {
+      case SPLASH_REPLAY_UPDATE:
+        state_update(record.delta);
+        break;
+
+      case SPLASH_REPLAY_EVENT:
+        state_event(record.event);
+        break;
+
+      case SPLASH_REPLAY_FRAME:
+        splash_lua_end_frame(splash_lua_state, 0);
+        replay_elapsed = record.elapsed;
+        replay_timer += record.elapsed;
+        replay_fps++;
+        if (replay_timer > 1000) {
+          replay_timer -= 1000;
+          uptime++;
+          state_uptime++;
+          frames = replay_fps;
+          replay_fps = 0;
+        }
+        return state_running;
+    }
+  }
+
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Ends a replay
+  @return   Void
+
+  Stops the state machine if the log did not and closes the log
+
+\-----------------------------------------------------------------------------*/
+void splash_state_replay_end() {
+  if (player == NULL) {
+    return;
+  }
+
+  if (state_running) {
+    splash_state_stop();
+  }
+
+  splash_replay_close(player);
+  player = NULL;
 }
 
 
@@ -374,4 +912,42 @@ int32_t splash_state_get_fps() {
 \-----------------------------------------------------------------------------*/
 int32_t splash_state_get_ticks() {
   return max_ticks;
-}
\ No newline at end of file
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the state machine clock
+  @return   State machine time in milliseconds
+
+  The clock advances by one tick every update, so it follows the recorded
+  updates during a replay.
+
+\-----------------------------------------------------------------------------*/
+uint32_t splash_state_get_clock() {
+  return (uint32_t)state_clock;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the current state handle
+  @return   The current state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Gets the handle of the current state
+
+\-----------------------------------------------------------------------------*/
+Splash_state_handle splash_state_get_current_handle() {
+  return current_state ? current_state->handle : SPLASH_STATE_INVALID_HANDLE;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the current state
+  @return   The current state else NULL
+
+  Gets the current state, it is still current after being removed until
+  the machine switches away from it
+
+\-----------------------------------------------------------------------------*/
+Splash_state *splash_state_get_current() {
+  return current_state;
+}
@@ -0,0 +1,174 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_batch.c
+   @author  P. Batty
+   @brief   Batch updates
+
+   This module implements float buffers and the loops that update whole
+   buffers of positions at once. The loops are kept free of calls and
+   aliasing so the compiler vectorizes them.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_batch.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a Splash_buffer
+  @param    length  Number of values
+  @return   New Splash_buffer otherwise NULL.
+
+  Creates a buffer with every value 0, destroy with splash_buffer_destroy();
+
+\-----------------------------------------------------------------------------*/
+Splash_buffer *splash_buffer_create(int32_t length) {
+  if (length < 0) {
+    return NULL;
+  }
+
+  Splash_buffer *buffer = malloc(sizeof(Splash_buffer));
+  if (buffer == NULL) {
+    return NULL;
+  }
+
+  buffer->data = calloc(length ? length : 1, sizeof(float));
+  if (buffer->data == NULL) {
+    free(buffer);
+    return NULL;
+  }
+  buffer->length = length;
+ return buffer;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a Splash_buffer
+  @param    buffer  The buffer
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_buffer_destroy(Splash_buffer *buffer) {
+  if (buffer == NULL) {
+    return;
+  }
+
+  free(buffer->data);
+  free(buffer);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves values by their velocities
+  @param    positions   The values to move
+  @param    velocities  The velocity of each value
+  @param    count       Number of values
+  @param    delta       The delta time
+  @return   Void
+
+  positions[i] += velocities[i] * delta, the buffers must not overlap.
+
+\-----------------------------------------------------------------------------*/
+void splash_batch_integrate(float *restrict positions, const float *restrict velocities, int32_t count, float delta) {
+  int32_t i;
+  for (i = 0; i < count; i++) {
+    positions[i] += velocities[i] * delta;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Translates positions
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    x           Amount to move along x
+  @param    y           Amount to move along y
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_batch_translate(float *restrict positions, int32_t count, float x, float y) {
+  int32_t i;
+  for (i = 0; i < count; i++) {
+    positions[i * 2] += x;
+    positions[i * 2 + 1] += y;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clamps positions to a rectangle
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    min_x       Left of the rectangle
+  @param    min_y       Top of the rectangle
+  @param    max_x       Right of the rectangle
+  @param    max_y       Bottom of the rectangle
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_batch_clamp(float *restrict positions, int32_t count, float min_x, float min_y, float max_x, float max_y) {
+  int32_t i;
+  for (i = 0; i < count; i++) {
+    float x = positions[i * 2];
+    float y = positions[i * 2 + 1];
+    x = x < min_x ? min_x : x;
+    x = x > max_x ? max_x : x;
+    y = y < min_y ? min_y : y;
+    y = y > max_y ? max_y : y;
+    positions[i * 2] = x;
+    positions[i * 2 + 1] = y;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the positions in a rectangle
+  @param    positions   The x, y pairs
+  @param    count       Number of positions
+  @param    min_x       Left of the rectangle
+  @param    min_y       Top of the rectangle
+  @param    max_x       Right of the rectangle
+  @param    max_y       Bottom of the rectangle
+  @param    visible     Receives the index of each position inside, may be NULL
+  @return   Number of positions inside
+
+  visible must hold count indices, they are written in order. The index
+  is always stored and only kept when inside so the loop does not branch.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_batch_cull(const float *restrict positions, int32_t count, float min_x, float min_y, float max_x, float max_y, int32_t *restrict visible) {
+  int32_t inside = 0;
+  int32_t i;
+
+  if (visible == NULL) {
+    for (i = 0; i < count; i++) {
+      float x = positions[i * 2];
+      float y = positions[i * 2 + 1];
+      inside += (x >= min_x) & (x <= max_x) & (y >= min_y) & (y <= max_y);
+    }
+    return inside;
+  }
+
+  for (i = 0; i < count; i++) {
+    float x = positions[i * 2];
+    float y = positions[i * 2 + 1];
+    visible[inside] = i;
+    inside += (x >= min_x) & (x <= max_x) & (y >= min_y) & (y <= max_y);
+  }
+ return inside;
+}
@@ -0,0 +1,379 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_replay.c
+   @author  P. Batty
+   @brief   The replay log
+
+   This module implements the reading and writing of the binary input
+   logs used to record and replay the state machine.
+
+   A log is the magic "SPLR", a version byte and the tick rate, followed
+   by records that each start with a type byte. Frame lengths are stored
+   as variable length integers and events only store the bytes their
+   type uses, so a typical frame costs a handful of bytes.
+
+   Events never store pointers. Drop events store their path after the
+   event as a length and the bytes, user events store their code with
+   the data pointers cleared and window manager events are skipped.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_replay.h"
+#include "SDL2/SDL.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+static const char magic[4] = {'S', 'P', 'L', 'R'}; /**< log file magic */
+#define REPLAY_VERSION 2                            /**< log file version */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks for a drop event
+  @param    type    The event type
+  @return   1 if the event carries a drop path else 0
+
+\-----------------------------------------------------------------------------*/
+static int8_t is_drop(Uint32 type) {
+  switch (type) {
+    case SDL_DROPFILE:
+#if SDL_VERSION_ATLEAST(2, 0, 5)
+    case SDL_DROPTEXT:
+    case SDL_DROPBEGIN:
+    case SDL_DROPCOMPLETE:
+#endif
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the stored size of an event
+  @param    event   The event
+  @return   Number of bytes of the event to store, 0 to skip it
+
+  Gets the size of the part of the event union used by the event type,
+  window manager events only hold a pointer to platform data so are skipped
+
+\-----------------------------------------------------------------------------*/
+static uint8_t event_size(SDL_Event *event) {
+  if (is_drop(event->type)) {
+    return sizeof(event->drop);
+  }
+  if (event->type >= SDL_USEREVENT && event->type < SDL_LASTEVENT) {
+    return sizeof(event->user);
+  }
+
+  switch (event->type) {
+    case SDL_QUIT:
+      return sizeof(event->type);
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      return sizeof(event->key);
+    case SDL_MOUSEMOTION:
+      return sizeof(event->motion);
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      return sizeof(event->button);
+    case SDL_MOUSEWHEEL:
+      return sizeof(event->wheel);
+    case SDL_WINDOWEVENT:
+      return sizeof(event->window);
+    case SDL_SYSWMEVENT:
+      return 0;
+    default:
+      return sizeof(SDL_Event);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes a variable length integer
+  @param    file    The file to write to
+  @param    value   The value to write
+  @return   Void
+
+  Writes seven bits per byte, the top bit marks that more bytes follow
+
+\-----------------------------------------------------------------------------*/
+static void write_varint(FILE *file, uint32_t value) {
+  while (value >= 0x80) {
+    fputc((value & 0x7f) | 0x80, file);
+    value >>= 7;
+  }
+  fputc(value, file);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reads a variable length integer
+  @param    file    The file to read from
+  @param    value   The value read
+  @return   0 on success else -1
+
+  Reads a value written by write_varint
+
+\-----------------------------------------------------------------------------*/
+static int8_t read_varint(FILE *file, uint32_t *value) {
+  uint32_t result = 0;
+  int shift = 0;
+  int byte;
+
+  do {
+    byte = fgetc(file);
+    if (byte == EOF || shift > 28) {
+      return -1;
+    }
+    result |= (uint32_t)(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+
+  *value = result;
+ return 0;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a new log to record to
+  @param    path    Path to the log file
+  @param    ticks   The ticks per second of the state machine
+  @return   New Splash_replay otherwise NULL.
+
+  Creates a new Splash_replay for writing close with splash_replay_close();
+  return a new object else null if unsuccessful
+
+\-----------------------------------------------------------------------------*/
+Splash_replay *splash_replay_record(const char *path, int32_t ticks) {
+  Splash_replay *replay = malloc(sizeof(Splash_replay));
+
+  if (!replay) {
+    return NULL;
+  }
+
+  replay->file = fopen(path, "wb");
+  if (!replay->file) {
+    free(replay);
+    return NULL;
+  }
+
+  replay->recording = 1;
+  replay->ticks = ticks;
+  replay->frames = 0;
+  replay->skipped = 0;
+
+  fwrite(magic, 1, sizeof(magic), replay->file);
+  fputc(REPLAY_VERSION, replay->file);
+  fwrite(&ticks, sizeof(ticks), 1, replay->file);
+
+ return replay;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Opens a log to replay
+  @param    path    Path to the log file
+  @return   New Splash_replay otherwise NULL.
+
+  Opens a Splash_replay for reading close with splash_replay_close();
+  return a new object else null if the file is missing or not a log
+
+\-----------------------------------------------------------------------------*/
+Splash_replay *splash_replay_open(const char *path) {
+  Splash_replay *replay = malloc(sizeof(Splash_replay));
+
+  if (!replay) {
+    return NULL;
+  }
+
+  replay->file = fopen(path, "rb");
+  if (!replay->file) {
+    free(replay);
+    return NULL;
+  }
+
+  char header[4];
+  if (fread(header, 1, sizeof(header), replay->file) != sizeof(header)
+      || memcmp(header, magic, sizeof(magic)) != 0
+      || fgetc(replay->file) != REPLAY_VERSION
+      || fread(&replay->ticks, sizeof(replay->ticks), 1, replay->file) != 1) {
+    fclose(replay->file);
+    free(replay);
+    return NULL;
+  }
+
+  replay->recording = 0;
+  replay->frames = 0;
+  replay->skipped = 0;
+
+ return replay;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an update
+  @param    replay  The log to write to
+  @param    delta   The update delta
+  @return   Void
+
+  Writes an update record to the log
+
+\-----------------------------------------------------------------------------*/
+void splash_replay_write_update(Splash_replay *replay, float delta) {
+  fputc(SPLASH_REPLAY_UPDATE, replay->file);
+  fwrite(&delta, sizeof(delta), 1, replay->file);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an event
+  @param    replay  The log to write to
+  @param    event   The event
+  @return   Void
+
+  Writes an event record to the log, only the part of the event union
+  used by the event type is stored. Pointers are cleared before writing,
+  a drop path is written after the event, window manager events are
+  skipped and counted.
+
+\-----------------------------------------------------------------------------*/
+void splash_replay_write_event(Splash_replay *replay, SDL_Event *event) {
+  uint8_t size = event_size(event);
+  SDL_Event stored = *event;
+
+  if (size == 0) {
+    replay->skipped++;
+    return;
+  }
+
+  if (is_drop(event->type)) {
+    stored.drop.file = NULL;
+  } else if (event->type >= SDL_USEREVENT && event->type < SDL_LASTEVENT) {
+    stored.user.data1 = NULL;
+    stored.user.data2 = NULL;
+  }
+
+  fputc(SPLASH_REPLAY_EVENT, replay->file);
+  fputc(size, replay->file);
+  fwrite(&stored, 1, size, replay->file);
+
+  if (is_drop(event->type)) {
+    uint32_t length = event->drop.file ? strlen(event->drop.file) + 1 : 0;
+    write_varint(replay->file, length);
+    fwrite(event->drop.file, 1, length, replay->file);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes a frame
+  @param    replay  The log to write to
+  @param    elapsed The frame length in milliseconds
+  @return   Void
+
+  Writes a frame record to the log
+
+\-----------------------------------------------------------------------------*/
+void splash_replay_write_frame(Splash_replay *replay, uint32_t elapsed) {
+  fputc(SPLASH_REPLAY_FRAME, replay->file);
+  write_varint(replay->file, elapsed);
+  replay->frames++;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reads the next record
+  @param    replay  The log to read from
+  @param    record  The record to fill
+  @return   The record type, SPLASH_REPLAY_END at the end of the log
+
+  Reads the next record from the log, a drop event path is allocated
+  with SDL_malloc as SDL does for live events, free it with SDL_free.
+
+\-----------------------------------------------------------------------------*/
+uint8_t splash_replay_read(Splash_replay *replay, Splash_replay_record *record) {
+  int type = fgetc(replay->file);
+  uint32_t length;
+  int size;
+
+  switch (type) {
+    case SPLASH_REPLAY_UPDATE:
+      if (fread(&record->delta, sizeof(record->delta), 1, replay->file) != 1) {
+        type = SPLASH_REPLAY_END;
+      }
+      break;
+
+    case SPLASH_REPLAY_EVENT:
+      size = fgetc(replay->file);
+      memset(&record->event, 0, sizeof(SDL_Event));
+      if (size == EOF || size > sizeof(SDL_Event)
+          || fread(&record->event, 1, size, replay->file) != (size_t)size) {
+        type = SPLASH_REPLAY_END;
+        break;
+      }
+
+      if (is_drop(record->event.type)) {
+        record->event.drop.file = NULL;
+        if (read_varint(replay->file, &length) == -1) {
+          type = SPLASH_REPLAY_END;
+          break;
+        }
+        if (length > 0) {
+          record->event.drop.file = SDL_malloc(length);
+          if (record->event.drop.file == NULL
+              || fread(record->event.drop.file, 1, length, replay->file) != length) {
+            SDL_free(record->event.drop.file);
+            record->event.drop.file = NULL;
+            type = SPLASH_REPLAY_END;
+            break;
+          }
+          record->event.drop.file[length - 1] = '\0';
+        }
+      }
+      break;
+
+    case SPLASH_REPLAY_FRAME:
+      if (read_varint(replay->file, &record->elapsed) == -1) {
+        type = SPLASH_REPLAY_END;
+      } else {
+        replay->frames++;
+      }
+      break;
+
+    default:
+      type = SPLASH_REPLAY_END;
+      break;
+  }
+
+  record->type = type;
+ return type;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Closes the log
+  @param    replay  The log to close
+  @return   Void
+
+  Flushes and closes the log
+
+\-----------------------------------------------------------------------------*/
+void splash_replay_close(Splash_replay *replay) {
+  fclose(replay->file);
+  free(replay);
+}
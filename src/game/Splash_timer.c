@@ -0,0 +1,641 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    Splash_timer.c
+   @author  P. Batty
+   @brief   The timers
+
+   This module implements the delayed and repeating timers driven by the
+   state machine clock.
+
+   Timers live in a hierarchical timing wheel. The root wheel has a slot
+   per millisecond for the next 256 milliseconds, the four outer wheels
+   each have 64 slots covering 64 times the span of the wheel inside them.
+   Adding and cancelling a timer is a list insert or unlink, and a timer
+   moves down a wheel at most four times before it fires, so the cost per
+   timer does not depend on how many timers are active.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_timer.h"
+#include "Splash/Splash_state.h"
+#include "../wrapper/lua_wrapper/game/l_splash_timer.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define ROOT_BITS   8                                 /**< bits in the root wheel */
+#define ROOT_SIZE   (1 << ROOT_BITS)                  /**< slots in the root wheel */
+#define LEVEL_BITS  6                                 /**< bits in an outer wheel */
+#define LEVEL_SIZE  (1 << LEVEL_BITS)                 /**< slots in an outer wheel */
+#define LEVELS      4                                 /**< number of outer wheels */
+#define SLOT_COUNT  (ROOT_SIZE + LEVELS * LEVEL_SIZE) /**< slots in all the wheels */
+#define FIRING_SLOT SLOT_COUNT                        /**< list of timers about to fire */
+#define NO_SLOT     -1                                /**< timer is not in a list */
+#define NIL         -1                                /**< end of a list */
+
+#define INDEX_BITS  20                                /**< handle bits for the index */
+#define INDEX_MASK  ((1 << INDEX_BITS) - 1)           /**< mask of the handle index */
+#define MAX_TIMERS  (INDEX_MASK - 1)                  /**< most timers at once */
+#define MAX_DELAY   0x7fffffff                        /**< longest delay */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    timer_node
+
+  A timer, linked in to a wheel slot and the list of its state.
+\----------------------------------------------------------------------------*/
+typedef struct timer_node {
+  uint32_t expires;             /**< clock time the timer fires at */
+  uint32_t interval;            /**< repeat interval, 0 for one shot */
+  uint32_t generation;          /**< bumped every time the node is freed */
+  int32_t slot;                 /**< the list the node is in */
+  int32_t next;                 /**< next node in the slot */
+  int32_t prev;                 /**< previous node in the slot */
+  int32_t state_next;           /**< next node of the state */
+  int32_t state_prev;           /**< previous node of the state */
+  Splash_state_handle state;    /**< the state the timer belongs to */
+  Splash_timer_callback callback; /**< the callback */
+  void *data;                   /**< the callback data */
+  int lua;                      /**< is it a lua callback? */
+  int l_callback;               /**< lua callback refrance */
+  int8_t active;                /**< is the timer waiting to fire */
+} timer_node;
+
+
+static timer_node *nodes;             /**< all the timer nodes */
+static int32_t node_capacity;         /**< size of the node array */
+static int32_t node_used;             /**< nodes handed out at least once */
+static int32_t free_head;             /**< list of free nodes */
+static int32_t active_count;          /**< number of active timers */
+
+static int32_t heads[SLOT_COUNT + 1]; /**< the wheel slots and the firing list */
+static int32_t *state_heads;          /**< timer list of each state */
+static int32_t state_heads_size;      /**< size of the state lists */
+
+static uint32_t base;                 /**< the next clock time to process */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes a handle
+  @param    i   The node index
+  @return   The node handle
+
+  Packs the node index and generation in to a handle
+
+\-----------------------------------------------------------------------------*/
+static Splash_timer_handle make_handle(int32_t i) {
+  return (nodes[i].generation << INDEX_BITS) | (uint32_t)(i + 1);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the node of a handle
+  @param    handle  The handle
+  @return   The node index else NIL
+
+  Finds the node of an active timer, stale handles return NIL
+
+\-----------------------------------------------------------------------------*/
+static int32_t find_node(Splash_timer_handle handle) {
+  int32_t i = (int32_t)(handle & INDEX_MASK) - 1;
+
+  if (i < 0 || i >= node_used || !nodes[i].active || make_handle(i) != handle) {
+    return NIL;
+  }
+ return i;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Links a node in to a slot
+  @param    slot    The slot
+  @param    i       The node index
+  @return   Void
+
+  Pushes the node on to the front of the slot list
+
+\-----------------------------------------------------------------------------*/
+static void link_slot(int32_t slot, int32_t i) {
+  nodes[i].slot = slot;
+  nodes[i].prev = NIL;
+  nodes[i].next = heads[slot];
+  if (heads[slot] != NIL) {
+    nodes[heads[slot]].prev = i;
+  }
+  heads[slot] = i;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Unlinks a node from its slot
+  @param    i       The node index
+  @return   Void
+
+  Removes the node from the slot list it is in
+
+\-----------------------------------------------------------------------------*/
+static void unlink_slot(int32_t i) {
+  if (nodes[i].prev != NIL) {
+    nodes[nodes[i].prev].next = nodes[i].next;
+  } else {
+    heads[nodes[i].slot] = nodes[i].next;
+  }
+  if (nodes[i].next != NIL) {
+    nodes[nodes[i].next].prev = nodes[i].prev;
+  }
+  nodes[i].slot = NO_SLOT;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Links a node to its state
+  @param    i       The node index
+  @return   0 on success else -1
+
+  Pushes the node on to the timer list of its state
+
+\-----------------------------------------------------------------------------*/
+static int8_t link_state(int32_t i) {
+  Splash_state_handle state = nodes[i].state;
+
+  if (state == SPLASH_STATE_INVALID_HANDLE) {
+    return 0;
+  }
+
+  if (state >= state_heads_size) {
+    int32_t size = state_heads_size ? state_heads_size : 16;
+    while (size <= state) {
+      size *= 2;
+    }
+
+    int32_t *new_heads = realloc(state_heads, size * sizeof(int32_t));
+    if (!new_heads) {
+      return -1;
+    }
+    memset(new_heads + state_heads_size, 0xff, (size - state_heads_size) * sizeof(int32_t));
+    state_heads = new_heads;
+    state_heads_size = size;
+  }
+
+  nodes[i].state_prev = NIL;
+  nodes[i].state_next = state_heads[state];
+  if (state_heads[state] != NIL) {
+    nodes[state_heads[state]].state_prev = i;
+  }
+  state_heads[state] = i;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Unlinks a node from its state
+  @param    i       The node index
+  @return   Void
+
+  Removes the node from the timer list of its state
+
+\-----------------------------------------------------------------------------*/
+static void unlink_state(int32_t i) {
+  if (nodes[i].state == SPLASH_STATE_INVALID_HANDLE) {
+    return;
+  }
+
+  if (nodes[i].state_prev != NIL) {
+    nodes[nodes[i].state_prev].state_next = nodes[i].state_next;
+  } else {
+    state_heads[nodes[i].state] = nodes[i].state_next;
+  }
+  if (nodes[i].state_next != NIL) {
+    nodes[nodes[i].state_next].state_prev = nodes[i].state_prev;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Schedules a node
+  @param    i       The node index
+  @return   Void
+
+  Puts the node in the wheel slot that covers its expiry time, timers that
+  are already due go in to the next slot to process.
+
+\-----------------------------------------------------------------------------*/
+static void schedule(int32_t i) {
+  uint32_t expires = nodes[i].expires;
+  int32_t delta = (int32_t)(expires - base);
+  int32_t level;
+
+  if (delta < 0) {
+    expires = base;
+    delta = 0;
+  }
+
+  if (delta < ROOT_SIZE) {
+    link_slot(expires & (ROOT_SIZE - 1), i);
+    return;
+  }
+
+  for (level = 0; level < LEVELS - 1; level++) {
+    if ((uint32_t)delta < (1u << (ROOT_BITS + (level + 1) * LEVEL_BITS))) {
+      break;
+    }
+  }
+  link_slot(ROOT_SIZE + level * LEVEL_SIZE + ((expires >> (ROOT_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1)), i);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Allocates a node
+  @return   The node index else NIL
+
+  Takes a node from the free list or grows the node array
+
+\-----------------------------------------------------------------------------*/
+static int32_t alloc_node() {
+  int32_t i;
+
+  if (free_head != NIL) {
+    i = free_head;
+    free_head = nodes[i].next;
+    return i;
+  }
+
+  if (node_used == node_capacity) {
+    int32_t capacity = node_capacity ? node_capacity * 2 : 64;
+    if (capacity > MAX_TIMERS) {
+      capacity = MAX_TIMERS;
+    }
+    if (capacity == node_capacity) {
+      return NIL;
+    }
+
+    timer_node *new_nodes = realloc(nodes, capacity * sizeof(timer_node));
+    if (!new_nodes) {
+      return NIL;
+    }
+    nodes = new_nodes;
+    node_capacity = capacity;
+  }
+
+  i = node_used++;
+  nodes[i].generation = 1;
+ return i;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees a node
+  @param    i       The node index
+  @return   Void
+
+  Unlinks the node from its state, releases the lua callback and puts the
+  node on the free list. The node must not be in a slot.
+
+\-----------------------------------------------------------------------------*/
+static void free_node(int32_t i) {
+  unlink_state(i);
+
+  if (nodes[i].lua) {
+    l_splash_timer_release(nodes[i].l_callback);
+  }
+
+  nodes[i].active = 0;
+  nodes[i].generation = (nodes[i].generation + 1) & ((1 << (32 - INDEX_BITS)) - 1);
+  nodes[i].next = free_head;
+  free_head = i;
+  active_count--;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a timer
+  @param    delay       Milliseconds before it first fires
+  @param    interval    Milliseconds between calls, 0 for a one shot
+  @param    callback    The C callback
+  @param    data        The callback data
+  @param    lua         Is it a lua callback
+  @param    l_callback  lua callback refrance
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer owned by the current state
+
+\-----------------------------------------------------------------------------*/
+static Splash_timer_handle timer_create(uint32_t delay, uint32_t interval, Splash_timer_callback callback, void *data, int lua, int l_callback) {
+  int32_t i = alloc_node();
+
+  if (i == NIL) {
+    return SPLASH_TIMER_INVALID_HANDLE;
+  }
+
+  if (delay > MAX_DELAY) {
+    delay = MAX_DELAY;
+  }
+  if (interval > MAX_DELAY) {
+    interval = MAX_DELAY;
+  }
+
+  timer_node *node = &nodes[i];
+  node->expires = base - 1 + delay;
+  node->interval = interval;
+  node->callback = callback;
+  node->data = data;
+  node->lua = lua;
+  node->l_callback = l_callback;
+  node->state = splash_state_get_current_handle();
+  node->active = 1;
+  active_count++;
+
+  if (link_state(i) == -1) {
+    node->state = SPLASH_STATE_INVALID_HANDLE;
+    free_node(i);
+    return SPLASH_TIMER_INVALID_HANDLE;
+  }
+
+  schedule(i);
+ return make_handle(i);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves a slot down the wheels
+  @param    slot    The outer wheel slot
+  @return   Void
+
+  Reschedules every timer in the slot, they land in an inner wheel
+
+\-----------------------------------------------------------------------------*/
+static void cascade(int32_t slot) {
+  int32_t i;
+
+  while ((i = heads[slot]) != NIL) {
+    unlink_slot(i);
+    schedule(i);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Fires a timer
+  @param    i       The node index
+  @return   Void
+
+  Calls the timer callback then reschedules or frees the timer, the
+  callback may cancel or create timers.
+
+\-----------------------------------------------------------------------------*/
+static void fire(int32_t i) {
+  Splash_timer_handle handle = make_handle(i);
+
+  unlink_slot(i);
+
+  if (nodes[i].lua) {
+    l_splash_timer_call(nodes[i].l_callback, handle);
+  } else {
+    nodes[i].callback(handle, nodes[i].data);
+  }
+
+  if (find_node(handle) != i) {
+    return;
+  }
+
+  if (nodes[i].interval) {
+    nodes[i].expires += nodes[i].interval;
+    schedule(i);
+  } else {
+    free_node(i);
+  }
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Inits Splash timer
+  @return   0 on success else -1
+
+  Inits the splash timers
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_timer_init() {
+  nodes = NULL;
+  node_capacity = 0;
+  node_used = 0;
+  free_head = NIL;
+  active_count = 0;
+  state_heads = NULL;
+  state_heads_size = 0;
+  base = 1;
+
+  memset(heads, 0xff, sizeof(heads));
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Quits Splash timer
+  @return   Void
+
+  Cancels every timer and quits the splash timers
+
+\-----------------------------------------------------------------------------*/
+void splash_timer_quit() {
+  int32_t i;
+
+  for (i = 0; i < node_used; i++) {
+    if (nodes[i].active && nodes[i].lua) {
+      l_splash_timer_release(nodes[i].l_callback);
+    }
+  }
+
+  free(nodes);
+  free(state_heads);
+  splash_timer_init();
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a one shot timer
+  @param    delay     Milliseconds of state machine time before it fires
+  @param    callback  The function to call
+  @param    data      Any data to pass to the callback
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that fires once. Timers belong to the current state and
+  are cancelled when that state is cleaned up.
+
+\-----------------------------------------------------------------------------*/
+Splash_timer_handle splash_timer_after(uint32_t delay, Splash_timer_callback callback, void *data) {
+  return timer_create(delay, 0, callback, data, 0, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a repeating timer
+  @param    interval  Milliseconds of state machine time between calls
+  @param    callback  The function to call
+  @param    data      Any data to pass to the callback
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that fires every interval until cancelled. Timers belong
+  to the current state and are cancelled when that state is cleaned up.
+
+\-----------------------------------------------------------------------------*/
+Splash_timer_handle splash_timer_every(uint32_t interval, Splash_timer_callback callback, void *data) {
+  if (interval == 0) {
+    interval = 1;
+  }
+  return timer_create(interval, interval, callback, data, 0, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a lua timer
+  @param    delay       Milliseconds before it first fires
+  @param    interval    Milliseconds between calls, 0 for a one shot
+  @param    l_callback  lua callback refrance, released with the timer
+  @return   The timer handle else SPLASH_TIMER_INVALID_HANDLE
+
+  Creates a timer that calls back in to lua
+
+\-----------------------------------------------------------------------------*/
+Splash_timer_handle splash_timer_lua_create(uint32_t delay, uint32_t interval, int l_callback) {
+  return timer_create(delay, interval, NULL, NULL, 1, l_callback);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels a timer
+  @param    handle    The timer to cancel
+  @return   1 if the timer was cancelled else 0
+
+  Cancels a timer, stale handles are ignored
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_timer_cancel(Splash_timer_handle handle) {
+  int32_t i = find_node(handle);
+
+  if (i == NIL) {
+    return 0;
+  }
+
+  if (nodes[i].slot != NO_SLOT) {
+    unlink_slot(i);
+  }
+  free_node(i);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a timer is active
+  @param    handle    The timer to check
+  @return   1 if the timer has not fired or been cancelled else 0
+
+  Checks if a timer is still waiting to fire
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_timer_active(Splash_timer_handle handle) {
+  return find_node(handle) != NIL;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels the timers of a state
+  @param    state     The state handle
+  @return   Void
+
+  Cancels every timer that belongs to the state
+
+\-----------------------------------------------------------------------------*/
+void splash_timer_clear_state(Splash_state_handle state) {
+  int32_t i;
+
+  if (state < 0 || state >= state_heads_size) {
+    return;
+  }
+
+  while ((i = state_heads[state]) != NIL) {
+    splash_timer_cancel(make_handle(i));
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Advances the timers
+  @param    now       The state machine clock in milliseconds
+  @return   Void
+
+  Fires every timer that expires up to and including now, called by the
+  state machine every tick.
+
+\-----------------------------------------------------------------------------*/
+void splash_timer_advance(uint32_t now) {
+  int32_t i;
+  int32_t level;
+
+  if (active_count == 0) {
+    if ((int32_t)(now - base) >= 0) {
+      base = now + 1;
+    }
+    return;
+  }
+
+  while ((int32_t)(now - base) >= 0) {
+    uint32_t index = base & (ROOT_SIZE - 1);
+
+    if (index == 0) {
+      for (level = 0; level < LEVELS; level++) {
+        uint32_t slot = (base >> (ROOT_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+        cascade(ROOT_SIZE + level * LEVEL_SIZE + slot);
+        if (slot != 0) {
+          break;
+        }
+      }
+    }
+
+    while ((i = heads[index]) != NIL) {
+      unlink_slot(i);
+      link_slot(FIRING_SLOT, i);
+    }
+    base++;
+
+    while ((i = heads[FIRING_SLOT]) != NIL) {
+      fire(i);
+    }
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the timer clock
+  @return   The last clock time the timers were advanced to
+
+  Gets the last clock time the timers were advanced to
+
+\-----------------------------------------------------------------------------*/
+uint32_t splash_timer_get_time() {
+  return base - 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of active timers
+  @return   Number of active timers
+
+  Gets the number of active timers
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_timer_get_count() {
+  return active_count;
+}
@@ -16,6 +16,7 @@
 
 #include "Splash/Splash_camera.h"
 #include "Splash/Splash_vector.h"
+#include "Splash/Splash_handle.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -49,6 +50,7 @@ Splash_camera *splash_camera_ortho_create() {
     camera->position = splash_vector3_create(0, 0, 0);
     camera->rotation = splash_vector3_create(0, 0, 0);
     camera->size = splash_vector3_create(1, 1, 1);
+    camera->id = splash_handle_create(camera);
 
   return camera;
 }
@@ -231,5 +233,6 @@ double splash_camera_get_zoom(Splash_camera *camera) {
 
 \-----------------------------------------------------------------------------*/
 void splash_camera_destroy(Splash_camera *camera) {
+  splash_handle_destroy(camera->id);
   free(camera);
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
  ---------------------------------------------------------------------------*/
 
 #include "Splash/Splash_texture.h"
+#include "Splash/Splash_handle.h"
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_image.h"
 #include <stdint.h>
@@ -85,10 +86,25 @@ Splash_texture *splash_texture_create(char *path) {
     return NULL;
   }
 
+  texture->id = splash_handle_create(texture);
   return texture;
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets the texture size
+  @param  texture      The texture to get
+  @return  The texture size inside a point
+
+  Gets the texture size
+
+\-----------------------------------------------------------------------------*/
+SDL_Point splash_texture_get_size(Splash_texture *texture) {
+  SDL_Point size = {texture->texture_width, texture->texture_height};
+  return size;
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Destroy's the texture
   @param  texture      The texture to destroy
@@ -98,5 +114,6 @@ Splash_texture *splash_texture_create(char *path) {
 
 \-----------------------------------------------------------------------------*/
 void splash_texture_destroy(Splash_texture *texture) {
+  splash_handle_destroy(texture->id);
   free(texture);
 }
\ No newline at end of file
@@ -0,0 +1,441 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_batch.c
+   @author  P. Batty
+   @brief   Batch updates
+
+   This module implements the lua bindings of the batch updates.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_batch.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "../l_splash_object.h"
+#include "l_splash_batch.h"
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+typedef struct batch_floats {
+  float *data;                          /**< the values */
+  int32_t length;                       /**< number of values */
+  int table;                            /**< stack index of the table the values came from, 0 for a buffer */
+} batch_floats;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the values of a buffer or flat array argument
+  @param    l       The lua state
+  @param    index   The argument
+  @param    name    The argument name
+  @param    floats  Receives the values
+  @return   Void
+
+  Buffers are used in place, arrays are copied to a userdata left on the
+  stack so the state owns the copy.
+
+\-----------------------------------------------------------------------------*/
+static void check_floats(lua_State *l, int index, const char *name, batch_floats *floats) {
+  if (!lua_istable(l, index)) {
+    Splash_buffer *buffer = l_splash_object_check(l, index, L_SPLASH_BUFFER_TYPE, name);
+    floats->data = buffer->data;
+    floats->length = buffer->length;
+    floats->table = 0;
+    return;
+  }
+
+  int32_t length = lua_rawlen(l, index);
+  float *data = lua_newuserdata(l, (length ? length : 1) * sizeof(float));
+  int32_t i;
+  for (i = 0; i < length; i++) {
+    lua_rawgeti(l, index, i + 1);
+    data[i] = lua_tonumber(l, -1);
+    lua_pop(l, 1);
+  }
+
+  floats->data = data;
+  floats->length = length;
+  floats->table = index;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes updated values back to their array
+  @param    l       The lua state
+  @param    floats  The values
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void store_floats(lua_State *l, batch_floats *floats) {
+  if (!floats->table) {
+    return;
+  }
+
+  int32_t i;
+  for (i = 0; i < floats->length; i++) {
+    lua_pushnumber(l, floats->data[i]);
+    lua_rawseti(l, floats->table, i + 1);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks a buffer index argument
+  @param    l       The lua state
+  @param    buffer  The buffer
+  @param    index   The argument
+  @return   The zero based index
+
+\-----------------------------------------------------------------------------*/
+static int32_t check_index(lua_State *l, Splash_buffer *buffer, int index) {
+  lua_Integer i = luaL_checkinteger(l, index);
+  luaL_argcheck(l, i >= 1 && i <= buffer->length, index, "index out of range");
+ return i - 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a buffer
+  @param    length  The number of values or an array of the values
+  @return   The buffer
+
+  Creates a float buffer, values start at 0 when only a length is given
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_buffer(lua_State *l) {
+  if (lua_istable(l, 1)) {
+    int32_t length = lua_rawlen(l, 1);
+    Splash_buffer *buffer = splash_buffer_create(length);
+    l_splash_object_push(l, L_SPLASH_BUFFER_TYPE, buffer, 1);
+
+    int32_t i;
+    for (i = 0; buffer != NULL && i < length; i++) {
+      lua_rawgeti(l, 1, i + 1);
+      buffer->data[i] = lua_tonumber(l, -1);
+      lua_pop(l, 1);
+    }
+    return 1;
+  }
+
+  lua_Integer length = luaL_checkinteger(l, 1);
+  luaL_argcheck(l, length >= 0 && length <= INT32_MAX, 1, "invalid length");
+  l_splash_object_push(l, L_SPLASH_BUFFER_TYPE, splash_buffer_create(length), 1);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves values by their velocities
+  @param    positions   Buffer or array of values
+  @param    velocities  Buffer or array of velocities
+  @param    delta       The delta time
+  @return   Void
+
+  Updates every value in one call, arrays are updated in place
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_integrate(lua_State *l) {
+  batch_floats positions;
+  batch_floats velocities;
+
+  float delta = luaL_checknumber(l, 3);
+  check_floats(l, 1, "positions", &positions);
+  check_floats(l, 2, "velocities", &velocities);
+  luaL_argcheck(l, positions.data != velocities.data, 2, "velocities are the positions");
+
+  int32_t count = positions.length < velocities.length ? positions.length : velocities.length;
+  splash_batch_integrate(positions.data, velocities.data, count, delta);
+  store_floats(l, &positions);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Translates positions
+  @param    positions   Buffer or array of x, y pairs
+  @param    x           Amount to move along x
+  @param    y           Amount to move along y
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_translate(lua_State *l) {
+  batch_floats positions;
+
+  float x = luaL_checknumber(l, 2);
+  float y = luaL_checknumber(l, 3);
+  check_floats(l, 1, "positions", &positions);
+
+  splash_batch_translate(positions.data, positions.length / 2, x, y);
+  store_floats(l, &positions);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clamps positions to a rectangle
+  @param    positions   Buffer or array of x, y pairs
+  @param    minX        Left of the rectangle
+  @param    minY        Top of the rectangle
+  @param    maxX        Right of the rectangle
+  @param    maxY        Bottom of the rectangle
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_clamp(lua_State *l) {
+  batch_floats positions;
+
+  float min_x = luaL_checknumber(l, 2);
+  float min_y = luaL_checknumber(l, 3);
+  float max_x = luaL_checknumber(l, 4);
+  float max_y = luaL_checknumber(l, 5);
+  check_floats(l, 1, "positions", &positions);
+
+  splash_batch_clamp(positions.data, positions.length / 2, min_x, min_y, max_x, max_y);
+  store_floats(l, &positions);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the positions in a rectangle
+  @param    positions   Buffer or array of x, y pairs
+  @param    minX        Left of the rectangle
+  @param    minY        Top of the rectangle
+  @param    maxX        Right of the rectangle
+  @param    maxY        Bottom of the rectangle
+  @param    visible     Optional buffer or array receiving the positions inside
+  @return   Number of positions inside
+
+  The one based numbers of the positions inside are written to visible in
+  order, a buffer must be long enough to hold them
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_cull(lua_State *l) {
+  batch_floats positions;
+
+  float min_x = luaL_checknumber(l, 2);
+  float min_y = luaL_checknumber(l, 3);
+  float max_x = luaL_checknumber(l, 4);
+  float max_y = luaL_checknumber(l, 5);
+  int has_visible = !lua_isnoneornil(l, 6);
+  Splash_buffer *buffer = NULL;
+  if (has_visible && !lua_istable(l, 6)) {
+    buffer = l_splash_object_check(l, 6, L_SPLASH_BUFFER_TYPE, "visible");
+  }
+  check_floats(l, 1, "positions", &positions);
+
+  int32_t count = positions.length / 2;
+  if (!has_visible) {
+    lua_pushinteger(l, splash_batch_cull(positions.data, count, min_x, min_y, max_x, max_y, NULL));
+    return 1;
+  }
+
+  int32_t *visible = lua_newuserdata(l, (count ? count : 1) * sizeof(int32_t));
+  int32_t inside = splash_batch_cull(positions.data, count, min_x, min_y, max_x, max_y, visible);
+  int32_t i;
+
+  if (buffer != NULL) {
+    luaL_argcheck(l, buffer->length >= inside, 6, "buffer too short");
+    for (i = 0; i < inside; i++) {
+      buffer->data[i] = visible[i] + 1;
+    }
+  } else {
+    int32_t previous = lua_rawlen(l, 6);
+    for (i = 0; i < inside; i++) {
+      lua_pushinteger(l, visible[i] + 1);
+      lua_rawseti(l, 6, i + 1);
+    }
+    for (i = inside; i < previous; i++) {
+      lua_pushnil(l);
+      lua_rawseti(l, 6, i + 1);
+    }
+  }
+
+  lua_pushinteger(l, inside);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a value
+  @param    buffer  The buffer
+  @param    index   One based index of the value
+  @return   The value
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_get(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  lua_pushnumber(l, buffer->data[check_index(l, buffer, 2)]);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets a value
+  @param    buffer  The buffer
+  @param    index   One based index of the value
+  @param    value   The value
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_set(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  int32_t i = check_index(l, buffer, 2);
+  buffer->data[i] = luaL_checknumber(l, 3);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the length of a buffer
+  @param    buffer  The buffer
+  @return   Number of values
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_length(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  lua_pushinteger(l, buffer->length);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets every value
+  @param    buffer  The buffer
+  @param    value   The value
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_fill(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  float value = luaL_checknumber(l, 2);
+
+  int32_t i;
+  for (i = 0; i < buffer->length; i++) {
+    buffer->data[i] = value;
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Copies an array into a buffer
+  @param    buffer  The buffer
+  @param    values  The array
+  @param    offset  Optional one based index of the first value written
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_load(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  luaL_checktype(l, 2, LUA_TTABLE);
+  lua_Integer offset = luaL_optinteger(l, 3, 1);
+  int32_t length = lua_rawlen(l, 2);
+  luaL_argcheck(l, offset >= 1 && offset - 1 + length <= buffer->length, 3, "values do not fit");
+
+  int32_t i;
+  for (i = 0; i < length; i++) {
+    lua_rawgeti(l, 2, i + 1);
+    buffer->data[offset - 1 + i] = lua_tonumber(l, -1);
+    lua_pop(l, 1);
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Copies a buffer into a new array
+  @param    buffer  The buffer
+  @return   The array
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_to_table(lua_State *l) {
+  Splash_buffer *buffer = l_splash_object_check(l, 1, L_SPLASH_BUFFER_TYPE, "buffer");
+  lua_createtable(l, buffer->length, 0);
+
+  int32_t i;
+  for (i = 0; i < buffer->length; i++) {
+    lua_pushnumber(l, buffer->data[i]);
+    lua_rawseti(l, -2, i + 1);
+  }
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a buffer
+  @param    buffer  The buffer
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_destroy(lua_State *l) {
+  splash_buffer_destroy(l_splash_object_release(l, 1, L_SPLASH_BUFFER_TYPE, "buffer"));
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Collects a buffer
+  @param    buffer  The buffer userdata
+  @return   Void
+
+  __gc of the buffers
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_batch_gc(lua_State *l) {
+  splash_buffer_destroy(l_splash_object_collect(l));
+ return 0;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the batch functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the batch functions and the buffer object type to lua
+
+\-----------------------------------------------------------------------------*/
+void l_splash_batch_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"buffer", l_splash_batch_buffer},
+    {"integrate", l_splash_batch_integrate},
+    {"translate", l_splash_batch_translate},
+    {"clamp", l_splash_batch_clamp},
+    {"cull", l_splash_batch_cull},
+    {"destroy", l_splash_batch_destroy},
+    {NULL, NULL}
+  };
+  const struct luaL_Reg methods[] = {
+    {"get", l_splash_batch_get},
+    {"set", l_splash_batch_set},
+    {"length", l_splash_batch_length},
+    {"fill", l_splash_batch_fill},
+    {"load", l_splash_batch_load},
+    {"toTable", l_splash_batch_to_table},
+    {"integrate", l_splash_batch_integrate},
+    {"translate", l_splash_batch_translate},
+    {"clamp", l_splash_batch_clamp},
+    {"cull", l_splash_batch_cull},
+    {"destroy", l_splash_batch_destroy},
+    {NULL, NULL}
+  };
+  l_splash_object_register(l, L_SPLASH_BUFFER_TYPE, methods, l_splash_batch_gc);
+
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_batch");
+}
@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_batch.h
+   @author  P. Batty
+   @brief   Batch updates
+
+   This module implements the lua bindings of the batch updates.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_BATCH_H_
+#define L_SPLASH_BATCH_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_batch.h"
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define L_SPLASH_BUFFER_TYPE "splash.buffer"  /**< metatable name of the buffers */
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the batch functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the batch functions and the buffer object type to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_batch_register(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,343 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_event.c
+   @author  P. Batty
+   @brief   The lua events
+
+   This module implements the typed SDL events passed to lua.
+
+   Events are full userdata holding a copy of the SDL_Event, so lua can
+   never see a dangling pointer. The userdata come from a fixed pool that
+   is filled once and reused round robin, so passing an event to lua
+   creates no garbage. Fields are read through an __index function that
+   maps the field name to an id with one table lookup.
+
+   A pooled event expires once the call it was passed to returns, reading
+   it after that raises an error rather than showing a later event that
+   reused the userdata. event:copy() makes an event that never expires.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "SDL2/SDL.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "l_splash_event.h"
+#include <string.h>
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define EVENT_META  "splash.event"  /**< metatable name of the events */
+#define POOL_SIZE   8               /**< number of pooled events */
+
+#define FIELD_TYPE        1         /**< event type */
+#define FIELD_TIMESTAMP   2         /**< event time in milliseconds */
+#define FIELD_WINDOW      3         /**< window id */
+#define FIELD_KEY         4         /**< key code */
+#define FIELD_SCANCODE    5         /**< key scan code */
+#define FIELD_MOD         6         /**< key modifiers */
+#define FIELD_REPEAT      7         /**< is the key repeating */
+#define FIELD_X           8         /**< mouse x or wheel x */
+#define FIELD_Y           9         /**< mouse y or wheel y */
+#define FIELD_XREL        10        /**< mouse x motion */
+#define FIELD_YREL        11        /**< mouse y motion */
+#define FIELD_BUTTON      12        /**< mouse button */
+#define FIELD_BUTTONS     13        /**< mouse button mask */
+#define FIELD_CLICKS      14        /**< mouse clicks */
+#define FIELD_TEXT        15        /**< text input */
+#define FIELD_WINDOW_EVENT 16       /**< window event id */
+#define FIELD_COPY        17        /**< the copy method */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    event_field
+
+  A field name and its id.
+\----------------------------------------------------------------------------*/
+typedef struct event_field {
+  const char *name;     /**< the field name */
+  int id;               /**< the field id */
+} event_field;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    event_type
+
+  An event type constant.
+\----------------------------------------------------------------------------*/
+typedef struct event_type {
+  const char *name;     /**< the constant name */
+  Uint32 type;          /**< the SDL event type */
+} event_type;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    lua_event
+
+  The event userdata.
+\----------------------------------------------------------------------------*/
+typedef struct lua_event {
+  SDL_Event event;      /**< the event */
+  int8_t pooled;        /**< 1 when the userdata is reused by the pool */
+  int8_t expired;       /**< 1 once the call it was passed to returned */
+} lua_event;
+
+
+static const event_field fields[] = {
+  {"type", FIELD_TYPE},
+  {"timestamp", FIELD_TIMESTAMP},
+  {"window", FIELD_WINDOW},
+  {"key", FIELD_KEY},
+  {"scancode", FIELD_SCANCODE},
+  {"mod", FIELD_MOD},
+  {"repeat", FIELD_REPEAT},
+  {"x", FIELD_X},
+  {"y", FIELD_Y},
+  {"xrel", FIELD_XREL},
+  {"yrel", FIELD_YREL},
+  {"button", FIELD_BUTTON},
+  {"buttons", FIELD_BUTTONS},
+  {"clicks", FIELD_CLICKS},
+  {"text", FIELD_TEXT},
+  {"windowEvent", FIELD_WINDOW_EVENT},
+  {"copy", FIELD_COPY},
+  {NULL, 0}
+};
+
+static const event_type types[] = {
+  {"QUIT", SDL_QUIT},
+  {"KEYDOWN", SDL_KEYDOWN},
+  {"KEYUP", SDL_KEYUP},
+  {"TEXTINPUT", SDL_TEXTINPUT},
+  {"MOUSEMOTION", SDL_MOUSEMOTION},
+  {"MOUSEBUTTONDOWN", SDL_MOUSEBUTTONDOWN},
+  {"MOUSEBUTTONUP", SDL_MOUSEBUTTONUP},
+  {"MOUSEWHEEL", SDL_MOUSEWHEEL},
+  {"WINDOWEVENT", SDL_WINDOWEVENT},
+  {NULL, 0}
+};
+
+static int pool_refs[POOL_SIZE];          /**< refrances keeping the pool alive */
+static lua_event *pool_events[POOL_SIZE]; /**< the pooled event memory */
+static int32_t pool_next;                 /**< next pooled event to use */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks an event
+  @param    l       The lua state
+  @param    index   Stack index of the event
+  @return   The event
+
+  Raises an error when the value is not an event or has expired
+
+\-----------------------------------------------------------------------------*/
+static lua_event *check_event(lua_State *l, int index) {
+  lua_event *event = luaL_checkudata(l, index, EVENT_META);
+
+  if (event->expired) {
+    luaL_error(l, "event has expired, use event:copy() to keep an event");
+  }
+ return event;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Copies an event
+  @param    event   The event
+  @return   A new event that never expires
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_event_copy(lua_State *l) {
+  lua_event *event = check_event(l, 1);
+  lua_event *copy = lua_newuserdata(l, sizeof(lua_event));
+
+  copy->event = event->event;
+  copy->pooled = 0;
+  copy->expired = 0;
+  luaL_setmetatable(l, EVENT_META);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets an event field
+  @param    event   The event
+  @param    field   The field name
+  @return   The field value, nil when the event type has no such field
+
+  __index of the events, the field id table is the first upvalue
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_event_index(lua_State *l) {
+  SDL_Event *event = &check_event(l, 1)->event;
+
+  lua_pushvalue(l, 2);
+  lua_rawget(l, lua_upvalueindex(1));
+  int field = lua_tointeger(l, -1);
+  lua_pop(l, 1);
+
+  if (field == FIELD_COPY) {
+    lua_pushcfunction(l, l_splash_event_copy);
+    return 1;
+  }
+
+  switch (event->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      switch (field) {
+        case FIELD_WINDOW:    lua_pushinteger(l, event->key.windowID); return 1;
+        case FIELD_KEY:       lua_pushinteger(l, event->key.keysym.sym); return 1;
+        case FIELD_SCANCODE:  lua_pushinteger(l, event->key.keysym.scancode); return 1;
+        case FIELD_MOD:       lua_pushinteger(l, event->key.keysym.mod); return 1;
+        case FIELD_REPEAT:    lua_pushboolean(l, event->key.repeat); return 1;
+      }
+      break;
+
+    case SDL_TEXTINPUT:
+      switch (field) {
+        case FIELD_WINDOW:    lua_pushinteger(l, event->text.windowID); return 1;
+        case FIELD_TEXT:      lua_pushstring(l, event->text.text); return 1;
+      }
+      break;
+
+    case SDL_MOUSEMOTION:
+      switch (field) {
+        case FIELD_WINDOW:    lua_pushinteger(l, event->motion.windowID); return 1;
+        case FIELD_X:         lua_pushinteger(l, event->motion.x); return 1;
+        case FIELD_Y:         lua_pushinteger(l, event->motion.y); return 1;
+        case FIELD_XREL:      lua_pushinteger(l, event->motion.xrel); return 1;
+        case FIELD_YREL:      lua_pushinteger(l, event->motion.yrel); return 1;
+        case FIELD_BUTTONS:   lua_pushinteger(l, event->motion.state); return 1;
+      }
+      break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      switch (field) {
+        case FIELD_WINDOW:    lua_pushinteger(l, event->button.windowID); return 1;
+        case FIELD_X:         lua_pushinteger(l, event->button.x); return 1;
+        case FIELD_Y:         lua_pushinteger(l, event->button.y); return 1;
+        case FIELD_BUTTON:    lua_pushinteger(l, event->button.button); return 1;
+        case FIELD_CLICKS:    lua_pushinteger(l, event->button.clicks); return 1;
+      }
+      break;
+
+    case SDL_MOUSEWHEEL:
+      switch (field) {
+        case FIELD_WINDOW:    lua_pushinteger(l, event->wheel.windowID); return 1;
+        case FIELD_X:         lua_pushinteger(l, event->wheel.x); return 1;
+        case FIELD_Y:         lua_pushinteger(l, event->wheel.y); return 1;
+      }
+      break;
+
+    case SDL_WINDOWEVENT:
+      switch (field) {
+        case FIELD_WINDOW:        lua_pushinteger(l, event->window.windowID); return 1;
+        case FIELD_WINDOW_EVENT:  lua_pushinteger(l, event->window.event); return 1;
+        case FIELD_X:             lua_pushinteger(l, event->window.data1); return 1;
+        case FIELD_Y:             lua_pushinteger(l, event->window.data2); return 1;
+      }
+      break;
+  }
+
+  switch (field) {
+    case FIELD_TYPE:      lua_pushinteger(l, event->type); return 1;
+    case FIELD_TIMESTAMP: lua_pushinteger(l, event->common.timestamp); return 1;
+  }
+
+  lua_pushnil(l);
+ return 1;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the event functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the event type constants and the event metatable to lua, and
+  fills the event pool.
+
+\-----------------------------------------------------------------------------*/
+void l_splash_event_register(lua_State *l) {
+  int i;
+
+  luaL_newmetatable(l, EVENT_META);
+  lua_newtable(l);
+  for (i = 0; fields[i].name; i++) {
+    lua_pushinteger(l, fields[i].id);
+    lua_setfield(l, -2, fields[i].name);
+  }
+  lua_pushcclosure(l, l_splash_event_index, 1);
+  lua_setfield(l, -2, "__index");
+  lua_pushliteral(l, EVENT_META);
+  lua_setfield(l, -2, "__metatable");
+
+  for (i = 0; i < POOL_SIZE; i++) {
+    pool_events[i] = lua_newuserdata(l, sizeof(lua_event));
+    memset(pool_events[i], 0, sizeof(lua_event));
+    pool_events[i]->pooled = 1;
+    pool_events[i]->expired = 1;
+    lua_pushvalue(l, -2);
+    lua_setmetatable(l, -2);
+    pool_refs[i] = luaL_ref(l, LUA_REGISTRYINDEX);
+  }
+  lua_pop(l, 1);
+  pool_next = 0;
+
+  lua_newtable(l);
+  for (i = 0; types[i].name; i++) {
+    lua_pushinteger(l, types[i].type);
+    lua_setfield(l, -2, types[i].name);
+  }
+  lua_setglobal(l, "splash_event");
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an event
+  @param    l       The lua state to push on to
+  @param    event   The event
+  @return   The pool slot, pass to l_splash_event_expire(); after the call
+
+  Copies the event in to the next userdata of the pool and pushes it. The
+  pool is reused so pushing an event allocates nothing, lua code should
+  read the fields it needs or keep event:copy() rather than the event.
+
+\-----------------------------------------------------------------------------*/
+int32_t l_splash_event_push(lua_State *l, SDL_Event *event) {
+  int32_t slot = pool_next;
+
+  pool_events[slot]->event = *event;
+  pool_events[slot]->expired = 0;
+  lua_rawgeti(l, LUA_REGISTRYINDEX, pool_refs[slot]);
+  pool_next = (pool_next + 1) % POOL_SIZE;
+ return slot;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Expires a pushed event
+  @param    slot    The pool slot returned by l_splash_event_push();
+  @return   Void
+
+  Call once the lua call the event was passed to returns, reading the
+  event after this raises an error.
+
+\-----------------------------------------------------------------------------*/
+void l_splash_event_expire(int32_t slot) {
+  pool_events[slot]->expired = 1;
+}
@@ -0,0 +1,80 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_event.h
+   @author  P. Batty
+   @brief   The lua events
+
+   This module implements the typed SDL events passed to lua.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_EVENT_H_
+#define L_SPLASH_EVENT_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "SDL2/SDL.h"
+#include "lua/lua.h"
+#include <stdint.h>
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the event functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the event type constants and the event metatable to lua, and
+  fills the event pool.
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_event_register(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an event
+  @param    l       The lua state to push on to
+  @param    event   The event
+  @return   The pool slot, pass to l_splash_event_expire(); after the call
+
+  Copies the event in to the next userdata of the pool and pushes it. The
+  pool is reused so pushing an event allocates nothing, lua code should
+  read the fields it needs or keep event:copy() rather than the event.
+
+\-----------------------------------------------------------------------------*/
+extern int32_t l_splash_event_push(lua_State *l, SDL_Event *event);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Expires a pushed event
+  @param    slot    The pool slot returned by l_splash_event_push();
+  @return   Void
+
+  Call once the lua call the event was passed to returns, reading the
+  event after this raises an error.
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_event_expire(int32_t slot);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,136 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_profiler.c
+   @author  P. Batty
+   @brief   The lua profiler
+
+   This module implements the lua bindings of the profiler.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_profiler.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "l_splash_profiler.h"
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Starts profiling
+  @param    interval  Optional lua instructions between samples
+  @return   Void
+
+  Starts sampling the main state and the calling thread
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_start(lua_State *l) {
+  lua_Integer interval = luaL_optinteger(l, 1, SPLASH_PROFILER_INTERVAL);
+
+  splash_lua_profiler_start(splash_lua_state, interval);
+  splash_lua_profiler_attach(l);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops profiling
+  @return   Void
+
+  Stops taking samples
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_stop(lua_State *l) {
+  splash_lua_profiler_stop();
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if the profiler is running
+  @return   true if running else false
+
+  Checks if samples are being taken
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_running(lua_State *l) {
+  lua_pushboolean(l, splash_lua_profiler_running());
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of samples
+  @return   Samples taken since the last clear
+
+  Gets the number of samples
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_get_samples(lua_State *l) {
+  lua_pushinteger(l, splash_lua_profiler_get_samples());
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes the samples
+  @param    path    Path to the output file
+  @return   true on success else false
+
+  Writes the samples as folded flamegraph stacks
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_write(lua_State *l) {
+  const char *path = luaL_checkstring(l, 1);
+  lua_pushboolean(l, splash_lua_profiler_write(path) == 0);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears the samples
+  @return   Void
+
+  Clears the samples
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_profiler_clear(lua_State *l) {
+  splash_lua_profiler_clear();
+ return 0;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the profiler functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the profiler functions to lua
+
+\-----------------------------------------------------------------------------*/
+void l_splash_profiler_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"start", l_splash_profiler_start},
+    {"stop", l_splash_profiler_stop},
+    {"running", l_splash_profiler_running},
+    {"getSamples", l_splash_profiler_get_samples},
+    {"write", l_splash_profiler_write},
+    {"clear", l_splash_profiler_clear},
+    {NULL, NULL}
+  };
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_profiler");
+}
@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_profiler.h
+   @author  P. Batty
+   @brief   The lua profiler
+
+   This module implements the lua bindings of the profiler.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_PROFILER_H_
+#define L_SPLASH_PROFILER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_profiler.h"
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the profiler functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the profiler functions to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_profiler_register(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
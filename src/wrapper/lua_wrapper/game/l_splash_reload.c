@@ -0,0 +1,137 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_reload.c
+   @author  P. Batty
+   @brief   The lua hot reload
+
+   This module implements the lua bindings of the hot reload.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_reload.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "l_splash_reload.h"
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define PERSIST_KEY "splash.reload.persist"   /**< registry table of the persisted values */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a persisted value
+  @param    key       The value name
+  @param    default   Optional value stored when there is none, a new table if nil
+  @return   The stored value
+
+  Values are kept across reloads, a script keeps its data with
+  local data = splash_reload.persist("name", {})
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_reload_persist(lua_State *l) {
+  luaL_checkstring(l, 1);
+  lua_settop(l, 2);
+
+  lua_getfield(l, LUA_REGISTRYINDEX, PERSIST_KEY);
+  if (lua_isnil(l, -1)) {
+    lua_pop(l, 1);
+    lua_newtable(l);
+    lua_pushvalue(l, -1);
+    lua_setfield(l, LUA_REGISTRYINDEX, PERSIST_KEY);
+  }
+
+  lua_pushvalue(l, 1);
+  lua_rawget(l, 3);
+  if (!lua_isnil(l, -1)) {
+    return 1;
+  }
+  lua_pop(l, 1);
+
+  if (lua_isnil(l, 2)) {
+    lua_newtable(l);
+    lua_replace(l, 2);
+  }
+  lua_pushvalue(l, 1);
+  lua_pushvalue(l, 2);
+  lua_rawset(l, 3);
+  lua_pushvalue(l, 2);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs and watches a script
+  @param    path    Path to the script
+  @return   true on success else false
+
+  Reruns the script when it changes
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_reload_watch(lua_State *l) {
+  const char *path = luaL_checkstring(l, 1);
+  lua_pushboolean(l, splash_lua_watch(l, path) == 0);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reloads a script
+  @param    path    Path to the script
+  @return   true on success else false
+
+  Reruns the script now rather than waiting for it to change
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_reload_reload(lua_State *l) {
+  const char *path = luaL_checkstring(l, 1);
+  lua_pushboolean(l, splash_lua_reload(l, path) == 0);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a script is being reloaded
+  @return   true while reloading else false
+
+  Lets a script skip its one time setup when rerun
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_reload_is_reloading(lua_State *l) {
+  lua_pushboolean(l, splash_lua_reloading());
+ return 1;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the reload functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the reload functions to lua
+
+\-----------------------------------------------------------------------------*/
+void l_splash_reload_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"persist", l_splash_reload_persist},
+    {"watch", l_splash_reload_watch},
+    {"reload", l_splash_reload_reload},
+    {"isReloading", l_splash_reload_is_reloading},
+    {NULL, NULL}
+  };
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_reload");
+}
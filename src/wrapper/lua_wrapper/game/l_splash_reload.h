@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_reload.h
+   @author  P. Batty
+   @brief   The lua hot reload
+
+   This module implements the lua bindings of the hot reload.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_RELOAD_H_
+#define L_SPLASH_RELOAD_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_reload.h"
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the reload functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the reload functions to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_reload_register(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
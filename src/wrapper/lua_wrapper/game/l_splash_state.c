@@ -20,7 +20,13 @@
 #include "lua/lauxlib.h"
 #include "lua/lualib.h"
 #include "splash/splash_lua_wrapper.h"
+#include "splash/Splash_lua_profiler.h"
+#include "splash/Splash_lua_reload.h"
+#include "../l_splash_object.h"
 #include "l_splash_state.h"
+#include "l_splash_task.h"
+#include "l_splash_event.h"
+#include <stdio.h>
 #include <stdlib.h>
 
 
@@ -28,6 +34,141 @@
                             Private functions
  ---------------------------------------------------------------------------*/
 
+#define PIN_HANDLER 1   /**< dispatch stack slot of the message handler */
+#define PIN_UPDATE  2   /**< dispatch stack slot of the update function */
+#define PIN_EVENT   3   /**< dispatch stack slot of the event function */
+#define PIN_RENDER  4   /**< dispatch stack slot of the render function */
+
+static lua_State *dispatch;       /**< thread the per tick callbacks are called on */
+static Splash_state *pinned;      /**< state whose callbacks are on the dispatch stack */
+static int32_t dispatch_depth;    /**< calls running on the dispatch thread */
+static Splash_state *released;    /**< removed current state to let go once not current */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases the anchor of a state
+  @param    l       The lua state
+  @param    state   the state
+  @return   Void
+
+  Lets lua collect a state object once the machine no longer holds it. The
+  current state is kept alive as the machine may still call it, it is let
+  go by release_pending(); once the machine moves on.
+
+\-----------------------------------------------------------------------------*/
+static void unanchor(lua_State *l, Splash_state *state) {
+  if (!state->lua || state->l_object == LUA_NOREF) {
+    return;
+  }
+  if (state == splash_state_get_current()) {
+    released = state;
+    return;
+  }
+
+  luaL_unref(l, LUA_REGISTRYINDEX, state->l_object);
+  state->l_object = LUA_NOREF;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases a removed state once it is not current
+  @return   Void
+
+  Checked on every dispatch, releases the anchor of a state that was
+  removed while current once the machine has switched away from it.
+
+\-----------------------------------------------------------------------------*/
+static void release_pending() {
+  if (released == NULL || released == splash_state_get_current()) {
+    return;
+  }
+
+  Splash_state *state = released;
+  released = NULL;
+  unanchor(splash_lua_state, state);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pins the callbacks of a state
+  @param    state     the state to pin
+  @return   The dispatch thread else NULL when already dispatching
+
+  Keeps the update, event and render functions of the state on the
+  dispatch stack so a call is a stack copy rather than a registry lookup.
+  The stack is only repinned when the state changes. Pending releases are
+  checked first.
+
+\-----------------------------------------------------------------------------*/
+static lua_State *pin(Splash_state *state) {
+  release_pending();
+  if (dispatch_depth) {
+    return NULL;
+  }
+
+  if (pinned != state) {
+    lua_settop(dispatch, PIN_HANDLER);
+    lua_rawgeti(dispatch, LUA_REGISTRYINDEX, state->l_update);
+    lua_rawgeti(dispatch, LUA_REGISTRYINDEX, state->l_event);
+    lua_rawgeti(dispatch, LUA_REGISTRYINDEX, state->l_render);
+    pinned = state;
+  }
+ return dispatch;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Calls a pinned callback
+  @param    nargs   Number of arguments pushed after the function
+  @return   Void
+
+  Calls the function on the dispatch stack with the traceback handler and
+  prints any error.
+
+\-----------------------------------------------------------------------------*/
+static void dispatch_call(int nargs) {
+  splash_lua_profiler_attach(dispatch);
+  dispatch_depth++;
+  int status = lua_pcall(dispatch, nargs, 0, PIN_HANDLER);
+  dispatch_depth--;
+
+  if (status != LUA_OK) {
+    printf("Lua error: %s\n", lua_tostring(dispatch, -1));
+    lua_pop(dispatch, 1);
+  }
+}
+
+/*!--------------------------------------------------------------------------
+  @brief    Rebinds the callbacks of a state
+  @param    old     the added state
+  @param    state   the reloaded state
+  @return   Void
+
+  Swaps the callbacks so the added state keeps its handle and runs the
+  reloaded functions, the old functions go with the reloaded object.
+
+\-----------------------------------------------------------------------------*/
+static void rebind(Splash_state *old, Splash_state *state) {
+  Splash_state callbacks = *old;
+
+  old->l_init = state->l_init;
+  old->l_update = state->l_update;
+  old->l_event = state->l_event;
+  old->l_render = state->l_render;
+  old->l_cleanup = state->l_cleanup;
+
+  state->l_init = callbacks.l_init;
+  state->l_update = callbacks.l_update;
+  state->l_event = callbacks.l_event;
+  state->l_render = callbacks.l_render;
+  state->l_cleanup = callbacks.l_cleanup;
+
+  if (pinned == old) {
+    pinned = NULL;
+  }
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Creates a new Splash state
   @param  name    The state name
@@ -38,8 +179,8 @@
   @param  cleanup function that takes a char *
   @return   New Splash_state otherwise NULL.
 
-  Creates a new Splash_window object destroy with splash_state_destroy();
-  return a new object else null if unsuccessful
+  Creates a new Splash_state object, the state is freed when lua collects
+  it. Once added the machine keeps the state alive until it is removed.
 
   init
     @param char *    The state that we are switiching to
@@ -89,13 +230,21 @@ static int l_splash_state_create(lua_State *l) {
   }
 
   state->name = luaL_checklstring(l, 1, NULL);
-  state->l_init = luaL_ref(l,LUA_REGISTRYINDEX);
-  state->l_update = luaL_ref(l,LUA_REGISTRYINDEX);
-  state->l_event = luaL_ref(l,LUA_REGISTRYINDEX);
-  state->l_render = luaL_ref(l,LUA_REGISTRYINDEX);
+  state->handle = SPLASH_STATE_INVALID_HANDLE;
+  state->lua = 1;
   state->l_cleanup = luaL_ref(l,LUA_REGISTRYINDEX);
-
-  lua_pushlightuserdata(l, state);
+  state->l_render = luaL_ref(l,LUA_REGISTRYINDEX);
+  state->l_event = luaL_ref(l,LUA_REGISTRYINDEX);
+  state->l_update = luaL_ref(l,LUA_REGISTRYINDEX);
+  state->l_init = luaL_ref(l,LUA_REGISTRYINDEX);
+  state->l_object = LUA_NOREF;
+  state->id = splash_handle_create(state);
+
+  l_splash_object_push(l, L_SPLASH_STATE_TYPE, state, 1);
+  lua_createtable(l, 1, 0);
+  lua_pushvalue(l, 1);
+  lua_rawseti(l, -2, 1);
+  lua_setuservalue(l, -2);
  return 1;
 }
 
@@ -103,9 +252,11 @@ static int l_splash_state_create(lua_State *l) {
 /*!--------------------------------------------------------------------------
   @brief    Adds a state to the machine
   @param    state       The state to add
-  @return   Void
+  @return   The state handle
 
-  Adds a state to the machine
+  Adds a state to the machine, the machine keeps the state alive and lets
+  go of any state it replaces. While a script is reloaded the callbacks
+  of an added lua state with the same name are rebound instead.
 
 \-----------------------------------------------------------------------------*/
 static int l_splash_state_add(lua_State *l) {
@@ -114,14 +265,30 @@ static int l_splash_state_add(lua_State *l) {
    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
  } 
 
- if (!lua_isuserdata(l, 1)) {
-   luaL_error (l, "Invalid argument 'state' should be a user data of type splash_state\n");
+ Splash_state *state = l_splash_object_check(l, 1, L_SPLASH_STATE_TYPE, "state");
+
+ Splash_state *old = splash_state_get_state(state->name);
+ if (old != NULL && old != state && old->lua && state->lua && splash_lua_reloading()) {
+   rebind(old, state);
+   lua_pushinteger(l, old->handle);
+   return 1;
+ }
+ if (old != NULL && old != state) {
+   unanchor(l, old);
  }
- 
- Splash_state *state = lua_touserdata(l, 1);
- splash_state_add(state);
 
- return 0;
+ if (released == state) {
+   released = NULL;
+ }
+
+ Splash_state_handle handle = splash_state_add(state);
+ if (handle != SPLASH_STATE_INVALID_HANDLE && state->lua && state->l_object == LUA_NOREF) {
+   lua_pushvalue(l, 1);
+   state->l_object = luaL_ref(l, LUA_REGISTRYINDEX);
+ }
+
+ lua_pushinteger(l, handle);
+ return 1;
 }
 
 
@@ -130,7 +297,8 @@ static int l_splash_state_add(lua_State *l) {
   @param    state_name  The state name
   @return   Void
 
-  Removes a state from the machine
+  Removes a state from the machine, lua may collect the state once it is
+  no longer used
 
 \-----------------------------------------------------------------------------*/
 static int l_splash_state_remove(lua_State *l) {
@@ -144,6 +312,10 @@ static int l_splash_state_remove(lua_State *l) {
  }
  
  char *state_name = luaL_checklstring(l, 1, NULL);
+ Splash_state *state = splash_state_get_state(state_name);
+ if (state != NULL) {
+   unanchor(l, state);
+ }
  splash_state_remove(state_name);
 
  return 0;
@@ -156,7 +328,7 @@ static int l_splash_state_remove(lua_State *l) {
   @param    data        Any data to pass in to the init
   @return   Void
 
-  Starts the splash state machine
+  Starts the splash state machine, ignored while a script is reloaded
 
 \-----------------------------------------------------------------------------*/
 static int l_splash_state_start(lua_State *l) {
@@ -172,7 +344,36 @@ static int l_splash_state_start(lua_State *l) {
    char *state_name = luaL_checklstring(l, 1, NULL);
    void *data = lua_topointer(l , 2);
 
-   splash_state_start(state_name, data);
+   if (!splash_lua_reloading()) {
+     splash_state_start(state_name, data);
+   }
+
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Starts the splash state
+  @param    handle      The state handle to start with
+  @param    data        Any data to pass in to the init
+  @return   Void
+
+  Starts the splash state machine without looking up the state name,
+  ignored while a script is reloaded
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_start_handle(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 2) {
+     luaL_error (l, "Invalid argument count got %d expected 2\n", argc);
+   } 
+
+   Splash_state_handle handle = luaL_checkinteger(l, 1);
+   void *data = lua_topointer(l , 2);
+
+   if (!splash_lua_reloading()) {
+     splash_state_start_handle(handle, data);
+   }
 
  return 0;
 }
@@ -206,6 +407,30 @@ static int l_splash_state_switch(lua_State *l) {
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Switchs the current state
+  @param    handle      The state handle to switch to
+  @param    data        Any data to pass in to the init
+  @return   Void
+
+  Switches the state machine without looking up the state name
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_switch_handle(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 2) {
+     luaL_error (l, "Invalid argument count got %d expected 2\n", argc);
+   } 
+
+   Splash_state_handle handle = luaL_checkinteger(l, 1);
+   void *data = lua_topointer(l , 2);
+
+   splash_state_switch_handle(handle, data);
+
+ return 0;
+}
+
+
 /*!--------------------------------------------------------------------------
   @brief    Stops the splash state
   @return   Void
@@ -232,7 +457,7 @@ static int l_splash_state_set_ticks(lua_State *l) {
      luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
    } 
 
-   if (!lua_isstring(l, 1)) {
+   if (!lua_isnumber(l, 1)) {
      luaL_error (l, "Invalid argument 'ticks' should be a number\n");
    }
 
@@ -248,7 +473,8 @@ static int l_splash_state_set_ticks(lua_State *l) {
   @brief    Gets a state
   @return   Splash_state object else NULL
 
-  Gets the splash state else returns NULL
+  Gets the splash state else returns nil, states created in C are not
+  owned by lua
 
 \-----------------------------------------------------------------------------*/
 static int l_splash_state_get_state(lua_State *l) {
@@ -264,7 +490,91 @@ static int l_splash_state_get_state(lua_State *l) {
    char *state_name = luaL_checklstring(l, 1, NULL);
    Splash_state *state = splash_state_get_state(state_name);
 
-   lua_pushlightuserdata(l, state);
+   if (state != NULL && state->lua) {
+     lua_rawgeti(l, LUA_REGISTRYINDEX, state->l_object);
+   } else {
+     l_splash_object_push(l, L_SPLASH_STATE_TYPE, state, 0);
+   }
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets a state handle
+  @param    state_name  The state name
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Looks up the handle for the state name
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_get_handle(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 1) {
+     luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+   } 
+
+   char *state_name = luaL_checklstring(l, 1, NULL);
+   lua_pushinteger(l, splash_state_get_handle(state_name));
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Records the state machine
+  @param    path    Path to the log file
+  @return   true on success else false
+
+  Records every update, event and frame of the next run to the log
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_record(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 1) {
+     luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+   } 
+
+   const char *path = luaL_checklstring(l, 1, NULL);
+   lua_pushboolean(l, splash_state_record(path) == 0);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops recording
+  @return   Void
+
+  Stops recording and closes the log
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_record_stop(lua_State *l) {
+   splash_state_record_stop();
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Replays a log
+  @param    path        Path to the log file
+  @param    state_name  The state name to start with
+  @param    data        Any data to pass in to the init
+  @param    speed       Replay speed, 1 is real time, 0 is as fast as possible
+  @return   true on success else false
+
+  Drives the states from a recorded log without a window
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_replay(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 4) {
+     luaL_error (l, "Invalid argument count got %d expected 4\n", argc);
+   } 
+
+   const char *path = luaL_checklstring(l, 1, NULL);
+   char *state_name = luaL_checklstring(l, 2, NULL);
+   void *data = lua_topointer(l , 3);
+   float speed = luaL_checknumber(l, 4);
+
+   lua_pushboolean(l, splash_state_replay(path, state_name, data, speed) == 0);
  return 1;
 }
 
@@ -325,6 +635,77 @@ static int l_splash_state_get_ticks(lua_State *l) {
 }
 
 
+/*!--------------------------------------------------------------------------
+  @brief    Gets the state name
+  @param    state   The state
+  @return   The state name
+
+  Gets the name of the state object
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_object_get_name(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 1) {
+     luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+   } 
+
+   Splash_state *state = l_splash_object_check(l, 1, L_SPLASH_STATE_TYPE, "state");
+   lua_pushstring(l, state->name);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the state handle
+  @param    state   The state
+  @return   The state handle else SPLASH_STATE_INVALID_HANDLE
+
+  Gets the handle given to the state object when it was added
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_object_get_handle(lua_State *l) {
+   int argc = lua_gettop(l);
+   if (argc != 1) {
+     luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+   } 
+
+   Splash_state *state = l_splash_object_check(l, 1, L_SPLASH_STATE_TYPE, "state");
+   lua_pushinteger(l, state->handle);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Collects a state
+  @param    state   The state userdata
+  @return   Void
+
+  __gc of the states, releases the callbacks and frees the state
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_state_gc(lua_State *l) {
+   Splash_state *state = l_splash_object_collect(l);
+
+   if (state == NULL) {
+     return 0;
+   }
+
+   if (pinned == state) {
+     pinned = NULL;
+   }
+   if (released == state) {
+     released = NULL;
+   }
+   luaL_unref(l, LUA_REGISTRYINDEX, state->l_init);
+   luaL_unref(l, LUA_REGISTRYINDEX, state->l_update);
+   luaL_unref(l, LUA_REGISTRYINDEX, state->l_event);
+   luaL_unref(l, LUA_REGISTRYINDEX, state->l_render);
+   luaL_unref(l, LUA_REGISTRYINDEX, state->l_cleanup);
+   splash_state_destroy(state);
+ return 0;
+}
+
+
 /*---------------------------------------------------------------------------
                             Function codes
  ---------------------------------------------------------------------------*/
@@ -334,7 +715,7 @@ static int l_splash_state_get_ticks(lua_State *l) {
   @param    the state to register to
   @return   Void
 
-  Registers the state functions to lua
+  Registers the state functions and the state object type to lua
 
 \-----------------------------------------------------------------------------*/
 void l_splash_state_register(lua_State *l) {
@@ -343,18 +724,38 @@ void l_splash_state_register(lua_State *l) {
     {"add", l_splash_state_add},
     {"remove", l_splash_state_remove},
     {"start", l_splash_state_start},
+    {"startHandle", l_splash_state_start_handle},
     {"switch", l_splash_state_switch},
+    {"switchHandle", l_splash_state_switch_handle},
     {"stop", l_splash_state_stop},
     {"setTicks", l_splash_state_set_ticks},
     {"getState", l_splash_state_get_state},
+    {"getHandle", l_splash_state_get_handle},
+    {"record", l_splash_state_record},
+    {"recordStop", l_splash_state_record_stop},
+    {"replay", l_splash_state_replay},
     {"getUptime", l_splash_state_get_uptime},
     {"getStateUptime", l_splash_state_get_state_uptime},
     {"getFps", l_splash_state_get_fps},
     {"getTicks", l_splash_state_get_ticks},
     {NULL, NULL}
   };
+  const struct luaL_Reg methods[] = {
+    {"add", l_splash_state_add},
+    {"getName", l_splash_state_object_get_name},
+    {"getHandle", l_splash_state_object_get_handle},
+    {NULL, NULL}
+  };
+  l_splash_object_register(l, L_SPLASH_STATE_TYPE, methods, l_splash_state_gc);
+
   luaL_newlib(l, module);
   lua_setglobal(l, "splash_state");
+
+  dispatch = lua_newthread(l);
+  luaL_ref(l, LUA_REGISTRYINDEX);
+  lua_pushcfunction(dispatch, splash_lua_traceback);
+  pinned = NULL;
+  dispatch_depth = 0;
 }
 
 
@@ -372,7 +773,7 @@ void l_splash_state_call_init(Splash_state *state, char *new_state, void *data)
 	lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_init);
 	lua_pushstring(splash_lua_state, new_state);
 	lua_pushlightuserdata(splash_lua_state, data);
-	lua_pcall(splash_lua_state, 2, 0, 0);
+	splash_lua_call(splash_lua_state, 2, 0);
 }
 
 
@@ -382,13 +783,24 @@ void l_splash_state_call_init(Splash_state *state, char *new_state, void *data)
   @param    delta     delta time
   @return   Void
 
-  Calls the update function ties to the state
+  Resumes the tasks that are due and calls the update function ties to
+  the state
 
 \-----------------------------------------------------------------------------*/
 void l_splash_state_call_update(Splash_state *state, float delta) {
-	lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_update);
-	lua_pushnumber(splash_lua_state, delta);
-	lua_pcall(splash_lua_state, 1, 0, 0);
+	l_splash_task_update();
+
+	lua_State *l = pin(state);
+	if (l == NULL) {
+		lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_update);
+		lua_pushnumber(splash_lua_state, delta);
+		splash_lua_call(splash_lua_state, 1, 0);
+		return;
+	}
+
+	lua_pushvalue(l, PIN_UPDATE);
+	lua_pushnumber(l, delta);
+	dispatch_call(1);
 }
 
 
@@ -398,13 +810,25 @@ void l_splash_state_call_update(Splash_state *state, float delta) {
   @param    event     the event
   @return   Void
 
-  Calls the event function tied to the state
+  Calls the event function tied to the state, the event is passed as a
+  pooled event userdata that expires when the call returns
 
 \-----------------------------------------------------------------------------*/
 void l_splash_state_call_event(Splash_state *state, SDL_Event event) {
-	lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_event);
-	lua_pushlightuserdata(splash_lua_state, &event);
-	lua_pcall(splash_lua_state, 1, 0, 0);
+	int32_t slot;
+	lua_State *l = pin(state);
+	if (l == NULL) {
+		lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_event);
+		slot = l_splash_event_push(splash_lua_state, &event);
+		splash_lua_call(splash_lua_state, 1, 0);
+		l_splash_event_expire(slot);
+		return;
+	}
+
+	lua_pushvalue(l, PIN_EVENT);
+	slot = l_splash_event_push(l, &event);
+	dispatch_call(1);
+	l_splash_event_expire(slot);
 }
 
 
@@ -417,8 +841,15 @@ void l_splash_state_call_event(Splash_state *state, SDL_Event event) {
 
 \-----------------------------------------------------------------------------*/
 void l_splash_state_call_render(Splash_state *state) {
-	lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_render);
-	lua_pcall(splash_lua_state, 0, 0, 0);
+	lua_State *l = pin(state);
+	if (l == NULL) {
+		lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_render);
+		splash_lua_call(splash_lua_state, 0, 0);
+		return;
+	}
+
+	lua_pushvalue(l, PIN_RENDER);
+	dispatch_call(0);
 }
 
 
@@ -434,5 +865,6 @@ void l_splash_state_call_render(Splash_state *state) {
 void l_splash_state_call_cleanup(Splash_state *state, char *new_state) {
 	lua_rawgeti(splash_lua_state ,LUA_REGISTRYINDEX, state->l_cleanup);
 	lua_pushstring(splash_lua_state, new_state);
-	lua_pcall(splash_lua_state, 1, 0, 0);
+	splash_lua_call(splash_lua_state, 1, 0);
+	release_pending();
 }
\ No newline at end of file
@@ -28,6 +28,7 @@ extern "C" {
                                 New types
  ---------------------------------------------------------------------------*/
 
+#define L_SPLASH_STATE_TYPE "splash.state"  /**< metatable name of the states */
 
 
 /*---------------------------------------------------------------------------
@@ -0,0 +1,717 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_task.c
+   @author  P. Batty
+   @brief   The lua tasks
+
+   This module implements the lua coroutine tasks resumed by the state
+   machine.
+
+   A task is a coroutine that runs until it waits. Tasks waiting on time
+   sit in a heap ordered by wake time and tasks waiting on frames in a
+   heap ordered by wake frame, so each tick only looks at the top of each
+   heap and sleeping tasks cost nothing until they are due. Tasks waiting
+   on a condition are polled every tick.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_state.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "splash/Splash_lua_profiler.h"
+#include "l_splash_task.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define TASK_FREE     0   /**< node is on the free list */
+#define TASK_RUNNING  1   /**< task is being resumed */
+#define TASK_SLEEP    2   /**< task waits for a clock time */
+#define TASK_FRAMES   3   /**< task waits for a frame */
+#define TASK_UNTIL    4   /**< task waits for a condition */
+#define TASK_DUE      5   /**< task is about to be resumed */
+
+#define NIL           -1                        /**< no task */
+#define INDEX_BITS    20                        /**< handle bits for the index */
+#define INDEX_MASK    ((1 << INDEX_BITS) - 1)   /**< mask of the handle index */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    task_node
+
+  A coroutine and what it is waiting for.
+\----------------------------------------------------------------------------*/
+typedef struct task_node {
+  lua_State *thread;      /**< the coroutine */
+  int ref;                /**< refrance keeping the coroutine alive */
+  int until;              /**< refrance of the wait condition */
+  uint32_t wake;          /**< clock time or frame to wake at */
+  uint32_t generation;    /**< bumped every time the node is freed */
+  int32_t pos;            /**< position in its heap or the poll list */
+  int32_t next_free;      /**< next node on the free list */
+  int8_t wait;            /**< what the task is waiting for */
+  int8_t cancelled;       /**< cancelled while running */
+} task_node;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    task_list
+
+  A list of task indices, kept as a heap on wake for the sleeping tasks.
+\----------------------------------------------------------------------------*/
+typedef struct task_list {
+  int32_t *items;         /**< the task indices */
+  int32_t count;          /**< number of items */
+  int32_t capacity;       /**< size of the items */
+} task_list;
+
+
+static task_node *tasks;        /**< all the task nodes */
+static int32_t task_capacity;   /**< size of the task array */
+static int32_t task_used;       /**< nodes handed out at least once */
+static int32_t free_head;       /**< list of free nodes */
+static int32_t task_count;      /**< number of live tasks */
+static int32_t running;         /**< task being resumed */
+static uint32_t task_frame;     /**< frames since the tasks started */
+
+static task_list sleeping;      /**< tasks waiting on time */
+static task_list framing;       /**< tasks waiting on frames */
+static task_list polling;       /**< tasks waiting on a condition */
+static uint32_t *due;           /**< handles of the tasks to resume this tick */
+static int32_t due_count;       /**< number of due handles */
+static int32_t due_capacity;    /**< size of the due handles */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes a handle
+  @param    i   The task index
+  @return   The task handle
+
+  Packs the task index and generation in to a handle
+
+\-----------------------------------------------------------------------------*/
+static uint32_t make_handle(int32_t i) {
+  return (tasks[i].generation << INDEX_BITS) | (uint32_t)(i + 1);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds the task of a handle
+  @param    handle  The handle
+  @return   The task index else NIL
+
+  Finds a live task, stale handles return NIL
+
+\-----------------------------------------------------------------------------*/
+static int32_t find_task(uint32_t handle) {
+  int32_t i = (int32_t)(handle & INDEX_MASK) - 1;
+
+  if (i < 0 || i >= task_used || tasks[i].wait == TASK_FREE || make_handle(i) != handle) {
+    return NIL;
+  }
+ return i;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reserves space in a list
+  @param    list    The list
+  @return   0 on success else -1
+
+  Grows the list so one more item fits
+
+\-----------------------------------------------------------------------------*/
+static int8_t list_reserve(task_list *list) {
+  if (list->count == list->capacity) {
+    int32_t capacity = list->capacity ? list->capacity * 2 : 64;
+    int32_t *items = realloc(list->items, capacity * sizeof(int32_t));
+    if (!items) {
+      return -1;
+    }
+    list->items = items;
+    list->capacity = capacity;
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves a heap item up
+  @param    heap    The heap
+  @param    pos     The item position
+  @return   Void
+
+  Moves the item up until its parent wakes no later than it
+
+\-----------------------------------------------------------------------------*/
+static void heap_up(task_list *heap, int32_t pos) {
+  int32_t i = heap->items[pos];
+
+  while (pos > 0) {
+    int32_t parent = (pos - 1) / 2;
+    if ((int32_t)(tasks[heap->items[parent]].wake - tasks[i].wake) <= 0) {
+      break;
+    }
+    heap->items[pos] = heap->items[parent];
+    tasks[heap->items[pos]].pos = pos;
+    pos = parent;
+  }
+  heap->items[pos] = i;
+  tasks[i].pos = pos;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Moves a heap item down
+  @param    heap    The heap
+  @param    pos     The item position
+  @return   Void
+
+  Moves the item down until its children wake no earlier than it
+
+\-----------------------------------------------------------------------------*/
+static void heap_down(task_list *heap, int32_t pos) {
+  int32_t i = heap->items[pos];
+
+  for (;;) {
+    int32_t child = pos * 2 + 1;
+    if (child >= heap->count) {
+      break;
+    }
+    if (child + 1 < heap->count
+        && (int32_t)(tasks[heap->items[child + 1]].wake - tasks[heap->items[child]].wake) < 0) {
+      child++;
+    }
+    if ((int32_t)(tasks[heap->items[child]].wake - tasks[i].wake) >= 0) {
+      break;
+    }
+    heap->items[pos] = heap->items[child];
+    tasks[heap->items[pos]].pos = pos;
+    pos = child;
+  }
+  heap->items[pos] = i;
+  tasks[i].pos = pos;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Removes a list item
+  @param    list    The list
+  @param    pos     The item position
+  @param    heap    Is the list a heap
+  @return   Void
+
+  Replaces the item with the last item and restores the heap order
+
+\-----------------------------------------------------------------------------*/
+static void list_remove(task_list *list, int32_t pos, int8_t heap) {
+  list->count--;
+  if (pos == list->count) {
+    return;
+  }
+
+  int32_t moved = list->items[list->count];
+  list->items[pos] = moved;
+  tasks[moved].pos = pos;
+  if (heap) {
+    heap_up(list, pos);
+    heap_down(list, tasks[moved].pos);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Unschedules a task
+  @param    i     The task index
+  @return   Void
+
+  Removes the task from the heap or list it waits in
+
+\-----------------------------------------------------------------------------*/
+static void unschedule(int32_t i) {
+  switch (tasks[i].wait) {
+    case TASK_SLEEP:
+      list_remove(&sleeping, tasks[i].pos, 1);
+      break;
+    case TASK_FRAMES:
+      list_remove(&framing, tasks[i].pos, 1);
+      break;
+    case TASK_UNTIL:
+      list_remove(&polling, tasks[i].pos, 0);
+      break;
+  }
+  if (tasks[i].until != LUA_NOREF) {
+    luaL_unref(splash_lua_state, LUA_REGISTRYINDEX, tasks[i].until);
+    tasks[i].until = LUA_NOREF;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees a task
+  @param    i     The task index
+  @return   Void
+
+  Releases the coroutine and puts the node on the free list, the task must
+  be unscheduled.
+
+\-----------------------------------------------------------------------------*/
+static void free_task(int32_t i) {
+  luaL_unref(splash_lua_state, LUA_REGISTRYINDEX, tasks[i].ref);
+  tasks[i].thread = NULL;
+  tasks[i].wait = TASK_FREE;
+  tasks[i].generation = (tasks[i].generation + 1) & ((1 << (32 - INDEX_BITS)) - 1);
+  tasks[i].next_free = free_head;
+  free_head = i;
+  task_count--;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Allocates a task
+  @return   The task index else NIL
+
+  Takes a node from the free list or grows the task array
+
+\-----------------------------------------------------------------------------*/
+static int32_t alloc_task() {
+  int32_t i;
+
+  if (free_head != NIL) {
+    i = free_head;
+    free_head = tasks[i].next_free;
+    return i;
+  }
+
+  if (task_used == INDEX_MASK - 1) {
+    return NIL;
+  }
+
+  if (task_used == task_capacity) {
+    int32_t capacity = task_capacity ? task_capacity * 2 : 64;
+    task_node *new_tasks = realloc(tasks, capacity * sizeof(task_node));
+    if (!new_tasks) {
+      return NIL;
+    }
+    tasks = new_tasks;
+    task_capacity = capacity;
+  }
+
+  i = task_used++;
+  tasks[i].generation = 1;
+ return i;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Puts a task in a wait list
+  @param    i       The task index
+  @param    list    The list to wait in
+  @param    wait    What the task waits for
+  @return   0 on success else -1
+
+  Adds the task to the list, the sleeping lists are kept in wake order
+
+\-----------------------------------------------------------------------------*/
+static int8_t task_wait(int32_t i, task_list *list, int8_t wait) {
+  if (list_reserve(list) == -1) {
+    return -1;
+  }
+
+  tasks[i].wait = wait;
+  list->items[list->count] = i;
+  tasks[i].pos = list->count++;
+  if (list != &polling) {
+    heap_up(list, tasks[i].pos);
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks the caller is a task
+  @param    l     The calling coroutine
+  @return   Void
+
+  Raises a lua error unless the caller is the running task
+
+\-----------------------------------------------------------------------------*/
+static void check_running(lua_State *l) {
+  if (running == NIL || tasks[running].thread != l) {
+    luaL_error (l, "Can only wait from inside a task\n");
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Resumes a task
+  @param    i       The task index
+  @param    from    The calling lua state
+  @param    nargs   Number of arguments on the task stack
+  @return   Void
+
+  Runs the task until it waits, ends or fails. A plain coroutine.yield
+  waits a frame.
+
+\-----------------------------------------------------------------------------*/
+static void resume(int32_t i, lua_State *from, int nargs) {
+  int32_t previous = running;
+  lua_State *thread = tasks[i].thread;
+
+  running = i;
+  tasks[i].wait = TASK_RUNNING;
+  splash_lua_profiler_attach(thread);
+  int status = lua_resume(thread, from, nargs);
+  running = previous;
+
+  if (status == LUA_YIELD && !tasks[i].cancelled) {
+    lua_settop(thread, 0);
+    if (tasks[i].wait != TASK_RUNNING) {
+      return;
+    }
+    tasks[i].wake = task_frame + 1;
+    if (task_wait(i, &framing, TASK_FRAMES) == 0) {
+      return;
+    }
+    printf("Task error: Out of memory\n");
+  }
+
+  if (status != LUA_OK && status != LUA_YIELD) {
+    luaL_traceback(thread, thread, lua_tostring(thread, -1), 0);
+    printf("Lua error: %s\n", lua_tostring(thread, -1));
+  }
+  unschedule(i);
+  free_task(i);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Marks a task due
+  @param    i     The task index
+  @return   0 on success else -1
+
+  Adds the task to the tasks resumed this tick
+
+\-----------------------------------------------------------------------------*/
+static int8_t mark_due(int32_t i) {
+  if (due_count == due_capacity) {
+    int32_t capacity = due_capacity ? due_capacity * 2 : 64;
+    uint32_t *new_due = realloc(due, capacity * sizeof(uint32_t));
+    if (!new_due) {
+      return -1;
+    }
+    due = new_due;
+    due_capacity = capacity;
+  }
+
+  tasks[i].wait = TASK_DUE;
+  due[due_count++] = make_handle(i);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Spawns a task
+  @param    function  The task function
+  @param    ...       Arguments passed to the function
+  @return   The task handle
+
+  Creates a coroutine and runs it until its first wait
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_spawn(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc < 1) {
+    luaL_error (l, "Invalid argument count got %d expected at least 1\n", argc);
+  }
+
+  if (!lua_isfunction(l, 1)) {
+    luaL_error (l, "Invalid argument 'function' should be a function\n");
+  }
+
+  int32_t i = alloc_task();
+  if (i == NIL) {
+    luaL_error (l, "Out of memory\n");
+  }
+
+  tasks[i].thread = lua_newthread(l);
+  tasks[i].ref = luaL_ref(l, LUA_REGISTRYINDEX);
+  tasks[i].until = LUA_NOREF;
+  tasks[i].pos = NIL;
+  tasks[i].cancelled = 0;
+  tasks[i].wait = TASK_RUNNING;
+  task_count++;
+
+  uint32_t handle = make_handle(i);
+  lua_xmove(l, tasks[i].thread, argc);
+  resume(i, l, argc - 1);
+
+  lua_pushinteger(l, handle);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Waits for a time
+  @param    seconds   Seconds of state machine time to wait
+  @return   Void
+
+  Suspends the task, it is resumed on the first tick at or after the time
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_wait(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  lua_Number seconds = luaL_checknumber(l, 1);
+  check_running(l);
+
+  tasks[running].wake = splash_state_get_clock() + (seconds > 0 ? (uint32_t)(seconds * 1000 + 0.5) : 0);
+  if (task_wait(running, &sleeping, TASK_SLEEP) == -1) {
+    luaL_error (l, "Out of memory\n");
+  }
+ return lua_yield(l, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Waits for frames
+  @param    frames    Number of frames to wait
+  @return   Void
+
+  Suspends the task for a number of ticks, at least one
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_wait_frames(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  lua_Integer frames = luaL_checkinteger(l, 1);
+  check_running(l);
+
+  tasks[running].wake = task_frame + (frames > 1 ? (uint32_t)frames : 1);
+  if (task_wait(running, &framing, TASK_FRAMES) == -1) {
+    luaL_error (l, "Out of memory\n");
+  }
+ return lua_yield(l, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Waits for a condition
+  @param    condition function that returns true to wake the task
+  @return   Void
+
+  Suspends the task until the condition is true, it is checked every tick
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_wait_until(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  if (!lua_isfunction(l, 1)) {
+    luaL_error (l, "Invalid argument 'condition' should be a function\n");
+  }
+  check_running(l);
+
+  if (task_wait(running, &polling, TASK_UNTIL) == -1) {
+    luaL_error (l, "Out of memory\n");
+  }
+  tasks[running].until = luaL_ref(l, LUA_REGISTRYINDEX);
+ return lua_yield(l, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels a task
+  @param    handle    The task to cancel
+  @return   true if the task was cancelled else false
+
+  Cancels a task, a task cancelling itself ends at its next wait
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_cancel(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  int32_t i = find_task(luaL_checkinteger(l, 1));
+  if (i == NIL || tasks[i].cancelled) {
+    lua_pushboolean(l, 0);
+    return 1;
+  }
+
+  if (tasks[i].wait == TASK_RUNNING) {
+    tasks[i].cancelled = 1;
+  } else {
+    unschedule(i);
+    free_task(i);
+  }
+
+  lua_pushboolean(l, 1);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a task is alive
+  @param    handle    The task to check
+  @return   true if the task has not ended
+
+  Checks if a task has not ended or been cancelled
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_active(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  int32_t i = find_task(luaL_checkinteger(l, 1));
+  lua_pushboolean(l, i != NIL && !tasks[i].cancelled);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of tasks
+  @return   Number of live tasks
+
+  Gets the number of live tasks
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_task_get_count(lua_State *l) {
+  lua_pushinteger(l, task_count);
+ return 1;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the task functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the task functions to lua, tasks of an older lua state are
+  dropped.
+
+\-----------------------------------------------------------------------------*/
+void l_splash_task_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"spawn", l_splash_task_spawn},
+    {"wait", l_splash_task_wait},
+    {"waitFrames", l_splash_task_wait_frames},
+    {"waitUntil", l_splash_task_wait_until},
+    {"cancel", l_splash_task_cancel},
+    {"active", l_splash_task_active},
+    {"getCount", l_splash_task_get_count},
+    {NULL, NULL}
+  };
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_task");
+
+  task_used = 0;
+  free_head = NIL;
+  task_count = 0;
+  running = NIL;
+  task_frame = 0;
+  sleeping.count = 0;
+  framing.count = 0;
+  polling.count = 0;
+  due_count = 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Resumes the tasks
+  @return   Void
+
+  Resumes every task whose wait is over, called once per tick before the
+  lua update.
+
+\-----------------------------------------------------------------------------*/
+void l_splash_task_update() {
+  uint32_t now = splash_state_get_clock();
+  int32_t i;
+  int32_t p;
+
+  task_frame++;
+  if (task_count == 0) {
+    return;
+  }
+
+  due_count = 0;
+  while (sleeping.count && (int32_t)(tasks[sleeping.items[0]].wake - now) <= 0) {
+    i = sleeping.items[0];
+    list_remove(&sleeping, 0, 1);
+    if (mark_due(i) == -1) {
+      free_task(i);
+    }
+  }
+
+  while (framing.count && (int32_t)(tasks[framing.items[0]].wake - task_frame) <= 0) {
+    i = framing.items[0];
+    list_remove(&framing, 0, 1);
+    if (mark_due(i) == -1) {
+      free_task(i);
+    }
+  }
+
+  for (p = 0; p < polling.count;) {
+    i = polling.items[p];
+    lua_rawgeti(splash_lua_state, LUA_REGISTRYINDEX, tasks[i].until);
+    int8_t status = splash_lua_call(splash_lua_state, 0, 1);
+    int ready = status == 0 && lua_toboolean(splash_lua_state, -1);
+    if (status == 0) {
+      lua_pop(splash_lua_state, 1);
+    }
+
+    if (p >= polling.count || polling.items[p] != i) {
+      continue;
+    }
+    if (status == -1) {
+      unschedule(i);
+      free_task(i);
+      continue;
+    }
+    if (!ready) {
+      p++;
+      continue;
+    }
+
+    unschedule(i);
+    if (mark_due(i) == -1) {
+      free_task(i);
+    }
+  }
+
+  int32_t count = due_count;
+  for (p = 0; p < count; p++) {
+    i = find_task(due[p]);
+    if (i != NIL && tasks[i].wait == TASK_DUE) {
+      resume(i, splash_lua_state, 0);
+    }
+  }
+}
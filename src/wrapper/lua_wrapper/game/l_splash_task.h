@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_task.h
+   @author  P. Batty
+   @brief   The lua tasks
+
+   This module implements the lua coroutine tasks resumed by the state
+   machine.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_TASK_H_
+#define L_SPLASH_TASK_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the task functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the task functions to lua, tasks of an older lua state are
+  dropped.
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_task_register(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Resumes the tasks
+  @return   Void
+
+  Resumes every task whose wait is over, called once per tick before the
+  lua update.
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_task_update();
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
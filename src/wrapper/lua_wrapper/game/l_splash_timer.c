@@ -0,0 +1,199 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_timer.c
+   @author  P. Batty
+   @brief   The lua timers
+
+   This module implements the lua bindings of the state machine timers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_timer.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "l_splash_timer.h"
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a one shot timer
+  @param    delay     Milliseconds of state machine time before it fires
+  @param    callback  function that takes the timer handle
+  @return   The timer handle
+
+  Creates a timer that fires once, owned by the current state
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_timer_after(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 2) {
+    luaL_error (l, "Invalid argument count got %d expected 2\n", argc);
+  }
+
+  lua_Integer delay = luaL_checkinteger(l, 1);
+  if (!lua_isfunction(l, 2)) {
+    luaL_error (l, "Invalid argument 'callback' should be a function\n");
+  }
+
+  int l_callback = luaL_ref(l, LUA_REGISTRYINDEX);
+  Splash_timer_handle handle = splash_timer_lua_create(delay < 0 ? 0 : delay, 0, l_callback);
+  if (handle == SPLASH_TIMER_INVALID_HANDLE) {
+    luaL_unref(l, LUA_REGISTRYINDEX, l_callback);
+  }
+
+  lua_pushinteger(l, handle);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a repeating timer
+  @param    interval  Milliseconds of state machine time between calls
+  @param    callback  function that takes the timer handle
+  @return   The timer handle
+
+  Creates a timer that fires every interval until cancelled, owned by the
+  current state
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_timer_every(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 2) {
+    luaL_error (l, "Invalid argument count got %d expected 2\n", argc);
+  }
+
+  lua_Integer interval = luaL_checkinteger(l, 1);
+  if (!lua_isfunction(l, 2)) {
+    luaL_error (l, "Invalid argument 'callback' should be a function\n");
+  }
+  if (interval < 1) {
+    interval = 1;
+  }
+
+  int l_callback = luaL_ref(l, LUA_REGISTRYINDEX);
+  Splash_timer_handle handle = splash_timer_lua_create(interval, interval, l_callback);
+  if (handle == SPLASH_TIMER_INVALID_HANDLE) {
+    luaL_unref(l, LUA_REGISTRYINDEX, l_callback);
+  }
+
+  lua_pushinteger(l, handle);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Cancels a timer
+  @param    handle    The timer to cancel
+  @return   true if the timer was cancelled else false
+
+  Cancels a timer, stale handles are ignored
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_timer_cancel(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  Splash_timer_handle handle = luaL_checkinteger(l, 1);
+  lua_pushboolean(l, splash_timer_cancel(handle));
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a timer is active
+  @param    handle    The timer to check
+  @return   true if the timer is still waiting to fire
+
+  Checks if a timer is still waiting to fire
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_timer_active(lua_State *l) {
+  int argc = lua_gettop(l);
+  if (argc != 1) {
+    luaL_error (l, "Invalid argument count got %d expected 1\n", argc);
+  }
+
+  Splash_timer_handle handle = luaL_checkinteger(l, 1);
+  lua_pushboolean(l, splash_timer_active(handle));
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of active timers
+  @return   Number of active timers
+
+  Gets the number of active timers
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_timer_get_count(lua_State *l) {
+  lua_pushinteger(l, splash_timer_get_count());
+ return 1;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the timer functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the timer functions to lua
+
+\-----------------------------------------------------------------------------*/
+void l_splash_timer_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"after", l_splash_timer_after},
+    {"every", l_splash_timer_every},
+    {"cancel", l_splash_timer_cancel},
+    {"active", l_splash_timer_active},
+    {"getCount", l_splash_timer_get_count},
+    {NULL, NULL}
+  };
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_timer");
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Calls a timer callback
+  @param    l_callback  lua callback refrance
+  @param    handle      The timer handle
+  @return   Void
+
+  Calls the lua function tied to the timer
+
+\-----------------------------------------------------------------------------*/
+void l_splash_timer_call(int l_callback, Splash_timer_handle handle) {
+  lua_rawgeti(splash_lua_state, LUA_REGISTRYINDEX, l_callback);
+  lua_pushinteger(splash_lua_state, handle);
+  splash_lua_call(splash_lua_state, 1, 0);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases a timer callback
+  @param    l_callback  lua callback refrance
+  @return   Void
+
+  Releases the lua function tied to the timer
+
+\-----------------------------------------------------------------------------*/
+void l_splash_timer_release(int l_callback) {
+  luaL_unref(splash_lua_state, LUA_REGISTRYINDEX, l_callback);
+}
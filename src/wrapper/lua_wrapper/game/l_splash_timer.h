@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_timer.h
+   @author  P. Batty
+   @brief   The lua timers
+
+   This module implements the lua bindings of the state machine timers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_TIMER_H_
+#define L_SPLASH_TIMER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_timer.h"
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the timer functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the timer functions to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_timer_register(lua_State *l);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Calls a timer callback
+  @param    l_callback  lua callback refrance
+  @param    handle      The timer handle
+  @return   Void
+
+  Calls the lua function tied to the timer
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_timer_call(int l_callback, Splash_timer_handle handle);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases a timer callback
+  @param    l_callback  lua callback refrance
+  @return   Void
+
+  Releases the lua function tied to the timer
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_timer_release(int l_callback);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
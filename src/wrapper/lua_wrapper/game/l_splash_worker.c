@@ -0,0 +1,170 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_worker.c
+   @author  P. Batty
+   @brief   The lua workers
+
+   This module implements the lua bindings of the lua workers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_worker.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include "splash/splash_lua_wrapper.h"
+#include "../l_splash_object.h"
+#include "l_splash_worker.h"
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a worker
+  @param    path    Path to the worker script
+  @return   The worker, nil if the script failed
+
+  Starts a worker running the script, the script returns the job function
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_create(lua_State *l) {
+  const char *path = luaL_checkstring(l, 1);
+  l_splash_object_push(l, L_SPLASH_WORKER_TYPE, splash_lua_worker_create(path), 1);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Posts a job
+  @param    worker  The worker
+  @param    ...     The job arguments
+  @return   Void
+
+  Copies the arguments to the worker, raises an error for values that can
+  not be copied
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_post(lua_State *l) {
+  Splash_lua_worker *worker = l_splash_object_check(l, 1, L_SPLASH_WORKER_TYPE, "worker");
+
+  if (splash_lua_worker_post(worker, l, lua_gettop(l) - 1) == -1) {
+    return lua_error(l);
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a result if one is ready
+  @param    worker  The worker
+  @return   true and the results, false and the error, or nothing
+
+  Takes the result of the oldest job without waiting
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_poll(lua_State *l) {
+  Splash_lua_worker *worker = l_splash_object_check(l, 1, L_SPLASH_WORKER_TYPE, "worker");
+  int count = splash_lua_worker_result(worker, l, 0);
+ return count == -1 ? 0 : count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Waits for a result
+  @param    worker  The worker
+  @return   true and the results, false and the error, or nothing
+
+  Takes the result of the oldest job, returns nothing if no jobs are
+  pending
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_wait(lua_State *l) {
+  Splash_lua_worker *worker = l_splash_object_check(l, 1, L_SPLASH_WORKER_TYPE, "worker");
+  int count = splash_lua_worker_result(worker, l, 1);
+ return count == -1 ? 0 : count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of pending jobs
+  @param    worker  The worker
+  @return   Jobs posted whose results have not been taken
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_pending(lua_State *l) {
+  Splash_lua_worker *worker = l_splash_object_check(l, 1, L_SPLASH_WORKER_TYPE, "worker");
+  lua_pushinteger(l, splash_lua_worker_pending(worker));
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a worker
+  @param    worker  The worker
+  @return   Void
+
+  Stops the worker thread
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_destroy(lua_State *l) {
+  splash_lua_worker_destroy(l_splash_object_release(l, 1, L_SPLASH_WORKER_TYPE, "worker"));
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Collects a worker
+  @param    worker  The worker userdata
+  @return   Void
+
+  __gc of the workers, stops the worker thread
+
+\-----------------------------------------------------------------------------*/
+static int l_splash_worker_gc(lua_State *l) {
+  splash_lua_worker_destroy(l_splash_object_collect(l));
+ return 0;
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the worker functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the worker functions and the worker object type to lua
+
+\-----------------------------------------------------------------------------*/
+void l_splash_worker_register(lua_State *l) {
+  const struct luaL_Reg module[] = {
+    {"create", l_splash_worker_create},
+    {"post", l_splash_worker_post},
+    {"poll", l_splash_worker_poll},
+    {"wait", l_splash_worker_wait},
+    {"pending", l_splash_worker_pending},
+    {"destroy", l_splash_worker_destroy},
+    {NULL, NULL}
+  };
+  const struct luaL_Reg methods[] = {
+    {"post", l_splash_worker_post},
+    {"poll", l_splash_worker_poll},
+    {"wait", l_splash_worker_wait},
+    {"pending", l_splash_worker_pending},
+    {"destroy", l_splash_worker_destroy},
+    {NULL, NULL}
+  };
+  l_splash_object_register(l, L_SPLASH_WORKER_TYPE, methods, l_splash_worker_gc);
+
+  luaL_newlib(l, module);
+  lua_setglobal(l, "splash_worker");
+}
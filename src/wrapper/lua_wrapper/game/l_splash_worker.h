@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_worker.h
+   @author  P. Batty
+   @brief   The lua workers
+
+   This module implements the lua bindings of the lua workers.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_WORKER_H_
+#define L_SPLASH_WORKER_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_lua_worker.h"
+#include "lua/lua.h"
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define L_SPLASH_WORKER_TYPE "splash.worker"  /**< metatable name of the workers */
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the worker functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the worker functions and the worker object type to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_worker_register(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -6,6 +6,9 @@
 
    This module implements the camera lua bindings
 
+   The bindings are generated from Splash_camera.h by splash_bindgen
+   when building.
+
 */
 /*--------------------------------------------------------------------------*/
 
@@ -26,6 +29,7 @@ extern "C" {
                                 New types
  ---------------------------------------------------------------------------*/
 
+#define L_SPLASH_CAMERA_TYPE "splash.camera"  /**< metatable name of the cameras */
 
 
 /*---------------------------------------------------------------------------
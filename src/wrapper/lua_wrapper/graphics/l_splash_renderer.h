@@ -6,6 +6,9 @@
 
    This module implements the renderer lua bindings
 
+   The bindings are generated from Splash_renderer.h by splash_bindgen
+   when building.
+
 */
 /*--------------------------------------------------------------------------*/
 
@@ -0,0 +1,55 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_texture.h
+   @author  P. Batty
+   @brief   The lua textures
+
+   This module implements the creation and manipulations of the
+   lua texture structure in the framework.
+
+   The bindings are generated from Splash_texture.h by splash_bindgen
+   when building.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_TEXTURE_H_
+#define L_SPLASH_TEXTURE_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash_texture.h"
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+#define L_SPLASH_TEXTURE_TYPE "splash.texture"  /**< metatable name of the textures */
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    registers the texture functions to lua
+  @param    the state to register to
+  @return   Void
+
+  Registers the texture functions and the texture object type to lua
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_texture_register(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -7,6 +7,9 @@
    This module implements the creation and manipulations of the 
    lua window structure in the framework.
 
+   The bindings are generated from Splash_window.h by splash_bindgen
+   when building.
+
 */
 /*--------------------------------------------------------------------------*/
 
@@ -27,6 +30,7 @@ extern "C" {
                                 New types
  ---------------------------------------------------------------------------*/
 
+#define L_SPLASH_WINDOW_TYPE "splash.window"  /**< metatable name of the windows */
 
 
 /*---------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_object.c
+   @author  P. Batty
+   @brief   The lua objects
+
+   This module implements the typed userdata used to hand Splash objects
+   to lua.
+
+   Each type has a metatable named after it holding the methods as
+   __index and a __gc finalizer, so objects support method calls, are
+   type checked and are destroyed when lua no longer refers to them.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "l_splash_object.h"
+#include "Splash/Splash_handle.h"
+#include <stdint.h>
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Registers an object type
+  @param    l         The lua state
+  @param    type      The type and metatable name
+  @param    methods   The methods of the type
+  @param    gc        The finalizer of the type
+  @return   Void
+
+  Creates the metatable of the type with the methods as __index
+
+\-----------------------------------------------------------------------------*/
+void l_splash_object_register(lua_State *l, const char *type, const luaL_Reg *methods, lua_CFunction gc) {
+  luaL_newmetatable(l, type);
+
+  lua_newtable(l);
+  luaL_setfuncs(l, methods, 0);
+  lua_setfield(l, -2, "__index");
+
+  lua_pushcfunction(l, gc);
+  lua_setfield(l, -2, "__gc");
+
+  lua_pushstring(l, type);
+  lua_setfield(l, -2, "__metatable");
+
+  lua_pop(l, 1);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an object
+  @param    l         The lua state
+  @param    type      The object type
+  @param    ptr       The object, pushes nil when NULL
+  @param    owned     Destroy the object when the userdata is collected
+  @return   Void
+
+  Pushes a new userdata of the type holding the object
+
+\-----------------------------------------------------------------------------*/
+void l_splash_object_push(lua_State *l, const char *type, void *ptr, int8_t owned) {
+  if (ptr == NULL) {
+    lua_pushnil(l);
+    return;
+  }
+
+  l_splash_object *object = lua_newuserdata(l, sizeof(l_splash_object));
+  object->ptr = ptr;
+  object->handle = splash_handle_find(ptr);
+  object->owned = owned;
+  luaL_setmetatable(l, type);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks an object argument
+  @param    l         The lua state
+  @param    index     The argument index
+  @param    type      The object type
+  @param    name      The argument name used in errors
+  @return   The object
+
+  Gets the object of the argument, raises a lua error if the argument is
+  not of the type or has been destroyed. Objects with a handle are looked
+  up through it so one destroyed elsewhere is not reached, the lookup
+  gives the object so it is the only one.
+
+\-----------------------------------------------------------------------------*/
+void *l_splash_object_check(lua_State *l, int index, const char *type, const char *name) {
+  l_splash_object *object = luaL_testudata(l, index, type);
+
+  if (object == NULL) {
+    luaL_error (l, "Invalid argument '%s' should be a user data of type %s\n", name, type);
+  }
+  if (object->ptr != NULL && object->handle != SPLASH_HANDLE_NULL) {
+    object->ptr = splash_handle_get(object->handle);
+  }
+  if (object->ptr == NULL) {
+    luaL_error (l, "Invalid argument '%s' has been destroyed\n", name);
+  }
+ return object->ptr;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases an object argument
+  @param    l         The lua state
+  @param    index     The argument index
+  @param    type      The object type
+  @param    name      The argument name used in errors
+  @return   The object to destroy
+
+  Checks the argument and clears its pointer, used by destroy
+
+\-----------------------------------------------------------------------------*/
+void *l_splash_object_release(lua_State *l, int index, const char *type, const char *name) {
+  void *ptr = l_splash_object_check(l, index, type, name);
+  l_splash_object *object = lua_touserdata(l, index);
+
+  object->ptr = NULL;
+ return ptr;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Collects an object
+  @param    l         The lua state
+  @return   The object to destroy else NULL
+
+  Used by __gc, gets the object if it is owned and was not destroyed
+
+\-----------------------------------------------------------------------------*/
+void *l_splash_object_collect(lua_State *l) {
+  l_splash_object *object = lua_touserdata(l, 1);
+  void *ptr = object->owned ? object->ptr : NULL;
+
+  if (ptr != NULL && object->handle != SPLASH_HANDLE_NULL) {
+    ptr = splash_handle_get(object->handle);
+  }
+  object->ptr = NULL;
+ return ptr;
+}
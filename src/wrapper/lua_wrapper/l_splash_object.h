@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    l_splash_object.h
+   @author  P. Batty
+   @brief   The lua objects
+
+   This module implements the typed userdata used to hand Splash objects
+   to lua.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef L_SPLASH_OBJECT_H_
+#define L_SPLASH_OBJECT_H_
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "Splash/Splash_handle.h"
+#include <stdint.h>
+
+/* Set up for C definitions */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------
+                                New types
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    l_splash_object
+
+  The userdata of a Splash object. The pointer is cleared when the object
+  is destroyed so a destroyed object can not be used, objects with a
+  handle are also caught when destroyed outside of lua.
+\----------------------------------------------------------------------------*/
+typedef struct l_splash_object {
+  void *ptr;              /**< The object, NULL once destroyed */
+  Splash_handle handle;   /**< The object handle else SPLASH_HANDLE_NULL */
+  int8_t owned;           /**< Is the object destroyed with the userdata */
+} l_splash_object;
+
+
+/*---------------------------------------------------------------------------
+                            Function prototypes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Registers an object type
+  @param    l         The lua state
+  @param    type      The type and metatable name
+  @param    methods   The methods of the type
+  @param    gc        The finalizer of the type
+  @return   Void
+
+  Creates the metatable of the type with the methods as __index
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_object_register(lua_State *l, const char *type, const luaL_Reg *methods, lua_CFunction gc);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes an object
+  @param    l         The lua state
+  @param    type      The object type
+  @param    ptr       The object, pushes nil when NULL
+  @param    owned     Destroy the object when the userdata is collected
+  @return   Void
+
+  Pushes a new userdata of the type holding the object
+
+\-----------------------------------------------------------------------------*/
+extern void l_splash_object_push(lua_State *l, const char *type, void *ptr, int8_t owned);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks an object argument
+  @param    l         The lua state
+  @param    index     The argument index
+  @param    type      The object type
+  @param    name      The argument name used in errors
+  @return   The object
+
+  Gets the object of the argument, raises a lua error if the argument is
+  not of the type or has been destroyed
+
+\-----------------------------------------------------------------------------*/
+extern void *l_splash_object_check(lua_State *l, int index, const char *type, const char *name);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Releases an object argument
+  @param    l         The lua state
+  @param    index     The argument index
+  @param    type      The object type
+  @param    name      The argument name used in errors
+  @return   The object to destroy
+
+  Checks the argument and clears its pointer, used by destroy
+
+\-----------------------------------------------------------------------------*/
+extern void *l_splash_object_release(lua_State *l, int index, const char *type, const char *name);
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Collects an object
+  @param    l         The lua state
+  @return   The object to destroy else NULL
+
+  Used by __gc, gets the object if it is owned and was not destroyed
+
+\-----------------------------------------------------------------------------*/
+extern void *l_splash_object_collect(lua_State *l);
+
+
+/* end C definitions */
+#ifdef __cplusplus
+}
+#endif
+#endif
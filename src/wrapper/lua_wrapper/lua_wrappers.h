@@ -16,4 +16,12 @@
 #include "graphics/l_splash_window.h"
 #include "graphics/l_splash_renderer.h"
 #include "graphics/l_splash_camera.h"
-#include "game/l_splash_state.h"
\ No newline at end of file
+#include "graphics/l_splash_texture.h"
+#include "game/l_splash_state.h"
+#include "game/l_splash_timer.h"
+#include "game/l_splash_task.h"
+#include "game/l_splash_event.h"
+#include "game/l_splash_profiler.h"
+#include "game/l_splash_worker.h"
+#include "game/l_splash_reload.h"
+#include "game/l_splash_batch.h"
\ No newline at end of file
@@ -0,0 +1,379 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_lua_memory.c
+   @author  P. Batty
+   @brief   Lua memory management
+
+   This module implements the pooled allocator the lua states run on and
+   the frame budgeted garbage collection driven by the state machine.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_lua_memory.h"
+#include "SDL2/SDL.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define POOL_GRANULE 16                                   /**< class spacing, keeps blocks aligned */
+#define POOL_MAX_BLOCK 256                                /**< larger blocks go to realloc */
+#define POOL_PAGE_SIZE (16 * 1024)                        /**< bytes carved per page */
+#define POOL_CLASSES (POOL_MAX_BLOCK / POOL_GRANULE)      /**< number of size classes */
+#define GC_FALLBACK_PAUSE 400                             /**< heap growth in percent of the live size before lua collects by itself */
+
+typedef union Pool_page {
+  union Pool_page *next;                /**< next page of the pool */
+  char align[POOL_GRANULE];             /**< keeps the blocks after the header aligned */
+} Pool_page;
+
+typedef struct Pool_block {
+  struct Pool_block *next;              /**< next free block of the class */
+} Pool_block;
+
+typedef struct Pool {
+  Pool_block *free[POOL_CLASSES];       /**< free lists by size class */
+  Pool_page *pages;                     /**< every page, freed with the pool */
+  Splash_lua_memory frame;              /**< counters of the frame in progress */
+  Splash_lua_memory last;               /**< counters of the last finished frame */
+  double gc_budget;                     /**< milliseconds of collection per frame, 0 is automatic */
+  int gc_pause;                         /**< pause of the automatic collector to restore */
+} Pool;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the size class of a block
+  @param    size  Block size, 1 to POOL_MAX_BLOCK
+  @return   The class index
+
+\-----------------------------------------------------------------------------*/
+static int size_class(size_t size) {
+ return (int)((size - 1) / POOL_GRANULE);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a block from the pool
+  @param    pool    The pool
+  @param    size_index  The size class
+  @return   The block else NULL
+
+  Carves a new page into the class free list when it is empty.
+
+\-----------------------------------------------------------------------------*/
+static void *pool_take(Pool *pool, int size_index) {
+  Pool_block *block = pool->free[size_index];
+
+  if (block == NULL) {
+    size_t size = (size_index + 1) * POOL_GRANULE;
+    size_t count = (POOL_PAGE_SIZE - sizeof(Pool_page)) / size;
+    Pool_page *page = malloc(sizeof(Pool_page) + count * size);
+    if (page == NULL) {
+      return NULL;
+    }
+    page->next = pool->pages;
+    pool->pages = page;
+    pool->frame.pooled += sizeof(Pool_page) + count * size;
+
+    char *blocks = (char *)(page + 1);
+    size_t i;
+    for (i = count; i > 0; i--) {
+      block = (Pool_block *)(blocks + (i - 1) * size);
+      block->next = pool->free[size_index];
+      pool->free[size_index] = block;
+    }
+    block = pool->free[size_index];
+  }
+
+  pool->free[size_index] = block->next;
+ return block;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gives a block back to the pool
+  @param    pool    The pool
+  @param    size_index  The size class
+  @param    ptr     The block
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void pool_give(Pool *pool, int size_index, void *ptr) {
+  Pool_block *block = ptr;
+  block->next = pool->free[size_index];
+  pool->free[size_index] = block;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    The lua allocator
+  @param    ud      The pool
+  @param    ptr     The block, NULL for a new one
+  @param    osize   Size of the block, or the object type for a new one
+  @param    nsize   New size, 0 to free
+  @return   The block else NULL
+
+  lua_Alloc passes the old size back in, so blocks need no header to find
+  their class. Lua expects shrinking to never fail, a block that can not
+  move to a smaller class stays where it is.
+
+\-----------------------------------------------------------------------------*/
+static void *pool_alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  Pool *pool = ud;
+  void *block;
+
+  if (ptr == NULL) {
+    osize = 0;
+  }
+
+  if (nsize == 0) {
+    if (ptr != NULL) {
+      if (osize <= POOL_MAX_BLOCK) {
+        pool_give(pool, size_class(osize), ptr);
+      } else {
+        free(ptr);
+      }
+      pool->frame.frees++;
+      pool->frame.in_use -= osize;
+    }
+    return NULL;
+  }
+
+  if (osize > POOL_MAX_BLOCK && nsize > POOL_MAX_BLOCK) {
+    block = realloc(ptr, nsize);
+  } else if (ptr != NULL && osize <= POOL_MAX_BLOCK && nsize <= POOL_MAX_BLOCK && size_class(osize) == size_class(nsize)) {
+    block = ptr;
+  } else {
+    block = nsize > POOL_MAX_BLOCK ? malloc(nsize) : pool_take(pool, size_class(nsize));
+    if (block != NULL && ptr != NULL) {
+      memcpy(block, ptr, osize < nsize ? osize : nsize);
+      if (osize <= POOL_MAX_BLOCK) {
+        pool_give(pool, size_class(osize), ptr);
+      } else {
+        free(ptr);
+      }
+    }
+  }
+
+  if (block == NULL) {
+    if (ptr == NULL || nsize > osize) {
+      return NULL;
+    }
+    /* the bigger block is safe to hand back as the smaller class later */
+    block = ptr;
+  }
+
+  if (nsize > osize) {
+    pool->frame.allocations++;
+    pool->frame.allocated += nsize - osize;
+  }
+  pool->frame.in_use += nsize - osize;
+  if (pool->frame.in_use > pool->frame.peak) {
+    pool->frame.peak = pool->frame.in_use;
+  }
+ return block;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the pool of a state
+  @param    l   The lua state
+  @return   The pool else NULL
+
+\-----------------------------------------------------------------------------*/
+static Pool *get_pool(lua_State *l) {
+  void *ud;
+
+  if (l == NULL) {
+    return NULL;
+  }
+
+  if (lua_getallocf(l, &ud) != pool_alloc) {
+    return NULL;
+  }
+ return ud;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reports an unprotected error
+  @param    l   The lua state
+  @return   0
+
+  Same as the panic function luaL_newstate installs.
+
+\-----------------------------------------------------------------------------*/
+static int panic(lua_State *l) {
+  printf("PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(l, -1));
+ return 0;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a lua state on the pooled allocator
+  @return   The new state else NULL
+
+  Small blocks come from per size class free lists carved out of pages,
+  larger ones from realloc.
+
+\-----------------------------------------------------------------------------*/
+lua_State *splash_lua_newstate() {
+  Pool *pool = calloc(1, sizeof(Pool));
+
+  if (pool == NULL) {
+    return NULL;
+  }
+
+  lua_State *l = lua_newstate(pool_alloc, pool);
+  if (l == NULL) {
+    free(pool);
+#ifdef SPLASH_LUAJIT
+    /* LuaJIT without GC64 only runs on its own allocator */
+    return luaL_newstate();
+#else
+    return NULL;
+#endif
+  }
+
+  lua_atpanic(l, panic);
+ return l;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Closes a lua state
+  @param    l   The lua state
+  @return   Void
+
+  Closes the state and frees its pool if it was made with
+  splash_lua_newstate();
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_close(lua_State *l) {
+  Pool *pool = get_pool(l);
+
+  lua_close(l);
+  if (pool == NULL) {
+    return;
+  }
+
+  while (pool->pages != NULL) {
+    Pool_page *next = pool->pages->next;
+    free(pool->pages);
+    pool->pages = next;
+  }
+  free(pool);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the memory statistics
+  @param    l       The lua state
+  @param    memory  Filled with the statistics
+  @return   0 on success else -1
+
+  Fails for states not made with splash_lua_newstate();
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_get_memory(lua_State *l, Splash_lua_memory *memory) {
+  Pool *pool = get_pool(l);
+
+  if (pool == NULL) {
+    return -1;
+  }
+
+  *memory = pool->last;
+  memory->in_use = pool->frame.in_use;
+  memory->peak = pool->frame.peak;
+  memory->pooled = pool->frame.pooled;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the garbage collection budget
+  @param    l             The lua state
+  @param    milliseconds  Most time to collect each frame, 0 for the automatic collector
+  @return   0 on success else -1
+
+  With a budget the collection is done by splash_lua_end_frame(); in the
+  time left before the next tick. The automatic collector keeps running
+  with its pause raised to GC_FALLBACK_PAUSE, so when frames overrun,
+  replay leaves no time or a load runs between frames it steps with the
+  allocations once the heap passes that multiple of the last live size.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_set_gc_budget(lua_State *l, double milliseconds) {
+  Pool *pool = get_pool(l);
+
+  if (pool == NULL) {
+    return -1;
+  }
+
+  if (milliseconds > 0 && pool->gc_budget == 0) {
+    pool->gc_pause = lua_gc(l, LUA_GCSETPAUSE, GC_FALLBACK_PAUSE);
+  } else if (milliseconds <= 0 && pool->gc_budget > 0) {
+    lua_gc(l, LUA_GCSETPAUSE, pool->gc_pause);
+  }
+
+  pool->gc_budget = milliseconds > 0 ? milliseconds : 0;
+  lua_gc(l, LUA_GCRESTART, 0);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Ends a frame
+  @param    l         The lua state
+  @param    leftover  Milliseconds left before the next tick is due
+  @return   Void
+
+  Steps the collector within the leftover time, up to the budget, and
+  starts new frame statistics. Stops after a finished cycle so an idle
+  heap is not walked over and over.
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_end_frame(lua_State *l, double leftover) {
+  Pool *pool = get_pool(l);
+
+  if (pool == NULL) {
+    return;
+  }
+
+  if (pool->gc_budget > 0) {
+    double budget = leftover < pool->gc_budget ? leftover : pool->gc_budget;
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 end = start + (Uint64)(budget > 0 ? budget * SDL_GetPerformanceFrequency() / 1000.0 : 0);
+    Uint64 now;
+
+    do {
+      pool->frame.gc_steps++;
+      if (lua_gc(l, LUA_GCSTEP, 0)) {
+        break;
+      }
+      now = SDL_GetPerformanceCounter();
+    } while (now < end);
+
+    pool->frame.gc_time = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+  }
+
+  pool->last = pool->frame;
+  pool->frame.allocations = 0;
+  pool->frame.frees = 0;
+  pool->frame.allocated = 0;
+  pool->frame.gc_steps = 0;
+  pool->frame.gc_time = 0;
+}
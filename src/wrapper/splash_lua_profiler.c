@@ -0,0 +1,310 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_lua_profiler.c
+   @author  P. Batty
+   @brief   The lua profiler
+
+   This module implements a sampling profiler for the lua scripts, the
+   samples are folded into flamegraph stacks under the state callback
+   they were taken in.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_lua_profiler.h"
+#include "lua/lua.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define MAX_DEPTH 64                    /**< deepest stack recorded, outer frames are cut */
+#define MAX_STACK 4096                  /**< longest folded stack */
+
+typedef struct profiler_stack {
+  char *stack;                          /**< the folded stack, NULL when free */
+  uint32_t hash;                        /**< hash of the stack */
+  uint32_t count;                       /**< samples of the stack */
+} profiler_stack;
+
+static const char *phase_names[] = {"other", "init", "update", "event", "render", "cleanup"};
+
+static int8_t running;                  /**< are samples being taken */
+static int32_t sample_interval;         /**< instructions between samples */
+static Splash_profiler_phase phase;     /**< the phase samples are counted under */
+static uint32_t samples;                /**< samples since the last clear */
+static profiler_stack *stacks;          /**< open addressed folded stacks */
+static int32_t stack_count;             /**< number of stacks */
+static int32_t stack_capacity;          /**< size of the stacks, power of two */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes a folded stack
+  @param    stack   The stack
+  @param    length  Length of the stack
+  @return   Hash
+
+  FNV-1a hash of the stack
+
+\-----------------------------------------------------------------------------*/
+static uint32_t hash_stack(const char *stack, size_t length) {
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < length; i++) {
+    hash ^= (uint8_t)stack[i];
+    hash *= 16777619u;
+  }
+
+ return hash;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Grows the stack table
+  @return   0 on success else -1
+
+  Doubles the table and reinserts the stacks, keeps it at most half full.
+
+\-----------------------------------------------------------------------------*/
+static int8_t grow_stacks() {
+  int32_t capacity = stack_capacity ? stack_capacity * 2 : 256;
+  profiler_stack *grown = calloc(capacity, sizeof(profiler_stack));
+  if (grown == NULL) {
+    return -1;
+  }
+
+  int32_t i;
+  for (i = 0; i < stack_capacity; i++) {
+    if (stacks[i].stack != NULL) {
+      int32_t j = stacks[i].hash & (capacity - 1);
+      while (grown[j].stack != NULL) {
+        j = (j + 1) & (capacity - 1);
+      }
+      grown[j] = stacks[i];
+    }
+  }
+
+  free(stacks);
+  stacks = grown;
+  stack_capacity = capacity;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Counts a sample
+  @param    stack   The folded stack
+  @param    length  Length of the stack
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void count_stack(const char *stack, size_t length) {
+  if (stack_count * 2 >= stack_capacity && grow_stacks() == -1) {
+    return;
+  }
+
+  uint32_t hash = hash_stack(stack, length);
+  int32_t i = hash & (stack_capacity - 1);
+
+  while (stacks[i].stack != NULL) {
+    if (stacks[i].hash == hash && strcmp(stacks[i].stack, stack) == 0) {
+      stacks[i].count++;
+      return;
+    }
+    i = (i + 1) & (stack_capacity - 1);
+  }
+
+  char *copy = malloc(length + 1);
+  if (copy == NULL) {
+    return;
+  }
+  memcpy(copy, stack, length + 1);
+
+  stacks[i].stack = copy;
+  stacks[i].hash = hash;
+  stacks[i].count = 1;
+  stack_count++;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    The count hook
+  @param    l   The thread being sampled
+  @param    ar  The hook event
+  @return   Void
+
+  Walks the lua stack and folds it outermost frame first. Removes itself
+  once the profiler is stopped.
+
+\-----------------------------------------------------------------------------*/
+static void sample(lua_State *l, lua_Debug *ar) {
+  if (!running) {
+    lua_sethook(l, NULL, 0, 0);
+    return;
+  }
+
+  lua_Debug frames[MAX_DEPTH];
+  int depth = 0;
+  while (depth < MAX_DEPTH && lua_getstack(l, depth, &frames[depth])) {
+    lua_getinfo(l, "Sn", &frames[depth]);
+    depth++;
+  }
+
+  char stack[MAX_STACK];
+  size_t length = snprintf(stack, sizeof(stack), "%s", phase_names[phase]);
+
+  while (depth-- > 0 && length < sizeof(stack)) {
+    lua_Debug *frame = &frames[depth];
+    const char *name = frame->name ? frame->name : "?";
+
+    if (*frame->what == 'C') {
+      length += snprintf(stack + length, sizeof(stack) - length, ";[C] %s", name);
+    } else if (*frame->what == 'm') {
+      length += snprintf(stack + length, sizeof(stack) - length, ";main (%s)", frame->short_src);
+    } else {
+      length += snprintf(stack + length, sizeof(stack) - length, ";%s (%s:%d)", name, frame->short_src, frame->linedefined);
+    }
+  }
+
+  if (length >= sizeof(stack)) {
+    length = sizeof(stack) - 1;
+  }
+  samples++;
+  count_stack(stack, length);
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Starts profiling
+  @param    l         The lua state
+  @param    interval  Lua instructions between samples, 0 or less for the default
+  @return   0 on success else -1
+
+  Samples are kept until splash_lua_profiler_clear();
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_profiler_start(lua_State *l, int32_t interval) {
+  if (l == NULL) {
+    return -1;
+  }
+
+  sample_interval = interval > 0 ? interval : SPLASH_PROFILER_INTERVAL;
+  running = 1;
+  lua_sethook(l, sample, LUA_MASKCOUNT, sample_interval);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops profiling
+  @return   Void
+
+  Stops taking samples, threads drop their hook the next time it fires.
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_profiler_stop() {
+  running = 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if the profiler is running
+  @return   1 if running else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_profiler_running() {
+ return running;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Samples a thread
+  @param    l   The thread
+  @return   Void
+
+  Sets the hook on threads made before the profiler started.
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_profiler_attach(lua_State *l) {
+  if (running && lua_gethook(l) != sample) {
+    lua_sethook(l, sample, LUA_MASKCOUNT, sample_interval);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the phase
+  @param    next    The phase samples are counted under
+  @return   The previous phase
+
+\-----------------------------------------------------------------------------*/
+Splash_profiler_phase splash_lua_profiler_phase(Splash_profiler_phase next) {
+  Splash_profiler_phase previous = phase;
+  phase = next;
+ return previous;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of samples
+  @return   Samples taken since the last clear
+
+\-----------------------------------------------------------------------------*/
+uint32_t splash_lua_profiler_get_samples() {
+ return samples;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes the samples
+  @param    path    Path to the output file
+  @return   0 on success else -1
+
+  Writes one "phase;outer;...;inner count" line per stack.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_profiler_write(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    return -1;
+  }
+
+  int32_t i;
+  for (i = 0; i < stack_capacity; i++) {
+    if (stacks[i].stack != NULL) {
+      fprintf(file, "%s %u\n", stacks[i].stack, stacks[i].count);
+    }
+  }
+
+ return fclose(file) == 0 ? 0 : -1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Clears the samples
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_profiler_clear() {
+  int32_t i;
+  for (i = 0; i < stack_capacity; i++) {
+    free(stacks[i].stack);
+  }
+
+  free(stacks);
+  stacks = NULL;
+  stack_count = 0;
+  stack_capacity = 0;
+  samples = 0;
+}
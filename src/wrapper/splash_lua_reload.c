@@ -0,0 +1,304 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_lua_reload.c
+   @author  P. Batty
+   @brief   Lua hot reload
+
+   This module implements reloading changed lua scripts while the game
+   runs. Reloaded states keep their handle and current state, only their
+   callbacks are swapped.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_lua_reload.h"
+#include "Splash/Splash_lua_wrapper.h"
+#include "SDL2/SDL.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define MODULES_KEY "splash.reload.modules"   /**< registry table of the returned tables by path */
+
+typedef struct watched_script {
+  char *path;                           /**< the script */
+  time_t modified;                      /**< modification time when last run */
+  off_t size;                           /**< size when last run */
+} watched_script;
+
+static int8_t hot_reload;               /**< watch the scripts run by splash_lua_dofile */
+static int8_t reloading;                /**< is a script being reloaded */
+static watched_script *scripts;         /**< the watched scripts */
+static int32_t script_count;            /**< number of watched scripts */
+static int32_t script_capacity;         /**< size of the scripts */
+static Uint32 last_check;               /**< ticks of the last check */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Finds a watched script
+  @param    path    Path to the script
+  @return   The script else NULL
+
+\-----------------------------------------------------------------------------*/
+static watched_script *find_script(const char *path) {
+  int32_t i;
+  for (i = 0; i < script_count; i++) {
+    if (strcmp(scripts[i].path, path) == 0) {
+      return &scripts[i];
+    }
+  }
+ return NULL;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Records the file state of a script
+  @param    script  The script
+  @return   1 if the file changed since the last record else 0
+
+\-----------------------------------------------------------------------------*/
+static int8_t stamp_script(watched_script *script) {
+  struct stat info;
+
+  if (stat(script->path, &info) != 0) {
+    return 0;
+  }
+
+  int8_t changed = info.st_mtime != script->modified || info.st_size != script->size;
+  script->modified = info.st_mtime;
+  script->size = info.st_size;
+ return changed;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a script to the watch list
+  @param    path    Path to the script
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t add_script(const char *path) {
+  if (find_script(path) != NULL) {
+    return 0;
+  }
+
+  if (script_count == script_capacity) {
+    int32_t capacity = script_capacity ? script_capacity * 2 : 8;
+    watched_script *grown = realloc(scripts, capacity * sizeof(watched_script));
+    if (grown == NULL) {
+      return -1;
+    }
+    scripts = grown;
+    script_capacity = capacity;
+  }
+
+  watched_script *script = &scripts[script_count];
+  script->path = malloc(strlen(path) + 1);
+  if (script->path == NULL) {
+    return -1;
+  }
+  strcpy(script->path, path);
+  script->modified = 0;
+  script->size = 0;
+  stamp_script(script);
+  script_count++;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs a script and keeps its returned table
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  The first table a script returns is kept by path, later runs copy their
+  functions into it so code holding the table sees the new functions and
+  the data in it survives.
+
+\-----------------------------------------------------------------------------*/
+static int8_t run_script(lua_State *l, const char *path) {
+  if (splash_lua_load(l, path) != 0) {
+    printf("Lua error: %s\n", lua_tostring(l, -1));
+    lua_pop(l, 1);
+    return -1;
+  }
+  if (splash_lua_call(l, 0, 1) != 0) {
+    return -1;
+  }
+
+  if (!lua_istable(l, -1)) {
+    lua_pop(l, 1);
+    return 0;
+  }
+
+  lua_getfield(l, LUA_REGISTRYINDEX, MODULES_KEY);
+  if (lua_isnil(l, -1)) {
+    lua_pop(l, 1);
+    lua_newtable(l);
+    lua_pushvalue(l, -1);
+    lua_setfield(l, LUA_REGISTRYINDEX, MODULES_KEY);
+  }
+
+  lua_getfield(l, -1, path);
+  if (lua_istable(l, -1)) {
+    /* stack: new, modules, old */
+    lua_pushnil(l);
+    while (lua_next(l, -4)) {
+      lua_pushvalue(l, -2);
+      lua_rawget(l, -4);
+      int keep = !lua_isnil(l, -1) && !lua_isfunction(l, -2);
+      lua_pop(l, 1);
+      if (keep) {
+        lua_pop(l, 1);
+      } else {
+        lua_pushvalue(l, -2);
+        lua_insert(l, -2);
+        lua_rawset(l, -4);
+      }
+    }
+    lua_pop(l, 3);
+    return 0;
+  }
+
+  lua_pop(l, 1);
+  lua_pushvalue(l, -2);
+  lua_setfield(l, -2, path);
+  lua_pop(l, 2);
+ return 0;
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Turns hot reload on or off
+  @param    enabled   Watch the scripts run by splash_lua_dofile();
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_set_hot_reload(int8_t enabled) {
+  hot_reload = enabled != 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if hot reload is on
+  @return   1 if on else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_get_hot_reload() {
+ return hot_reload;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs and watches a script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Runs the script and reruns it when the file changes.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_watch(lua_State *l, const char *path) {
+  if (add_script(path) == -1) {
+    return -1;
+  }
+ return run_script(l, path);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reloads a watched script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Reruns the script with the state machine in reload mode.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_reload(lua_State *l, const char *path) {
+  watched_script *script = find_script(path);
+  if (script != NULL) {
+    stamp_script(script);
+  }
+
+  int8_t was_reloading = reloading;
+  reloading = 1;
+  int8_t result = run_script(l, path);
+  reloading = was_reloading;
+ return result;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Reloads the changed scripts
+  @param    l     The lua state
+  @return   Number of scripts reloaded
+
+  Checks the watched files at most every SPLASH_RELOAD_INTERVAL.
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_lua_reload_changed(lua_State *l) {
+  if (script_count == 0 || l == NULL) {
+    return 0;
+  }
+
+  Uint32 now = SDL_GetTicks();
+  if (now - last_check < SPLASH_RELOAD_INTERVAL) {
+    return 0;
+  }
+  last_check = now;
+
+  int32_t reloaded = 0;
+  int32_t i;
+  for (i = 0; i < script_count; i++) {
+    if (stamp_script(&scripts[i])) {
+      if (splash_lua_reload(l, scripts[i].path) == 0) {
+        reloaded++;
+      }
+    }
+  }
+ return reloaded;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a script is being reloaded
+  @return   1 while reloading else 0
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_reloading() {
+ return reloading;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Stops watching every script
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_unwatch_all() {
+  int32_t i;
+  for (i = 0; i < script_count; i++) {
+    free(scripts[i].path);
+  }
+
+  free(scripts);
+  scripts = NULL;
+  script_count = 0;
+  script_capacity = 0;
+}
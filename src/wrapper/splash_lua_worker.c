@@ -0,0 +1,652 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_lua_worker.c
+   @author  P. Batty
+   @brief   The lua workers
+
+   This module implements lua states running on their own threads. Jobs
+   and results are copied between the states as serialized messages so
+   the states share nothing.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "Splash/Splash_lua_worker.h"
+#include "Splash/Splash_lua_wrapper.h"
+#include "Splash/Splash_lua_memory.h"
+#include "Splash/Splash_pool.h"
+#include "SDL2/SDL.h"
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include "lua/lualib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define MAX_DEPTH 32                    /**< deepest table nesting, stops cycles */
+#define MAX_ERROR 64                    /**< longest serialization error */
+
+enum {
+  MESSAGE_NIL,
+  MESSAGE_FALSE,
+  MESSAGE_TRUE,
+  MESSAGE_NUMBER,
+  MESSAGE_STRING,
+  MESSAGE_TABLE,
+  MESSAGE_END
+};
+
+typedef struct worker_message {
+  struct worker_message *next;          /**< next message in the queue */
+  int count;                            /**< number of values */
+  size_t size;                          /**< bytes used */
+  size_t capacity;                      /**< bytes allocated */
+  char *data;                           /**< the serialized values */
+} worker_message;
+
+typedef struct worker_queue {
+  worker_message *head;                 /**< oldest message */
+  worker_message *tail;                 /**< newest message */
+} worker_queue;
+
+struct Splash_lua_worker {
+  SDL_Thread *thread;                   /**< the worker thread */
+  SDL_mutex *lock;                      /**< guards everything below */
+  SDL_cond *jobs_ready;                 /**< signalled on a new job or quit */
+  SDL_cond *results_ready;              /**< signalled on a new result or start */
+  worker_queue jobs;                    /**< posted jobs */
+  worker_queue results;                 /**< finished jobs */
+  int32_t pending;                      /**< jobs whose results were not taken */
+  int8_t started;                       /**< 1 once the script ran, -1 if it failed */
+  int8_t quit;                          /**< set to stop the thread */
+  char *path;                           /**< the worker script */
+};
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Appends bytes to a message
+  @param    message   The message
+  @param    data      The bytes
+  @param    size      Number of bytes
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t message_write(worker_message *message, const void *data, size_t size) {
+  if (message->size + size > message->capacity) {
+    size_t capacity = message->capacity ? message->capacity * 2 : 64;
+    while (capacity < message->size + size) {
+      capacity *= 2;
+    }
+    char *grown = realloc(message->data, capacity);
+    if (grown == NULL) {
+      return -1;
+    }
+    message->data = grown;
+    message->capacity = capacity;
+  }
+
+  memcpy(message->data + message->size, data, size);
+  message->size += size;
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Appends a type tag to a message
+  @param    message   The message
+  @param    type      The tag
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t message_write_type(worker_message *message, char type) {
+ return message_write(message, &type, 1);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Serializes a lua value
+  @param    message   The message to append to
+  @param    l         The lua state
+  @param    index     Stack index of the value
+  @param    depth     Tables entered so far
+  @param    error     Set to the error on failure, MAX_ERROR long
+  @return   0 on success else -1
+
+\-----------------------------------------------------------------------------*/
+static int8_t message_write_value(worker_message *message, lua_State *l, int index, int depth, char *error) {
+  size_t length;
+  const char *string;
+  lua_Number number;
+  int8_t failed;
+
+  if (index < 0) {
+    index = lua_gettop(l) + index + 1;
+  }
+
+  switch (lua_type(l, index)) {
+    case LUA_TNIL:
+      failed = message_write_type(message, MESSAGE_NIL);
+      break;
+
+    case LUA_TBOOLEAN:
+      failed = message_write_type(message, lua_toboolean(l, index) ? MESSAGE_TRUE : MESSAGE_FALSE);
+      break;
+
+    case LUA_TNUMBER:
+      number = lua_tonumber(l, index);
+      failed = message_write_type(message, MESSAGE_NUMBER) || message_write(message, &number, sizeof(number));
+      break;
+
+    case LUA_TSTRING:
+      string = lua_tolstring(l, index, &length);
+      failed = message_write_type(message, MESSAGE_STRING) || message_write(message, &length, sizeof(length)) ||
+               message_write(message, string, length);
+      break;
+
+    case LUA_TTABLE:
+      if (depth >= MAX_DEPTH) {
+        snprintf(error, MAX_ERROR, "tables nested too deep or cyclic");
+        return -1;
+      }
+      if (!lua_checkstack(l, 2) || message_write_type(message, MESSAGE_TABLE)) {
+        failed = 1;
+        break;
+      }
+      lua_pushnil(l);
+      while (lua_next(l, index)) {
+        if (message_write_value(message, l, -2, depth + 1, error) || message_write_value(message, l, -1, depth + 1, error)) {
+          lua_pop(l, 2);
+          return -1;
+        }
+        lua_pop(l, 1);
+      }
+      failed = message_write_type(message, MESSAGE_END);
+      break;
+
+    default:
+      snprintf(error, MAX_ERROR, "a %s can not be sent between lua states", lua_typename(l, lua_type(l, index)));
+      return -1;
+  }
+
+  if (failed) {
+    snprintf(error, MAX_ERROR, "out of memory");
+    return -1;
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes a serialized lua value
+  @param    l         The lua state
+  @param    read      Read position, advanced past the value
+  @return   Void
+
+  Messages are only written by message_write_value so they are trusted.
+
+\-----------------------------------------------------------------------------*/
+static void message_read_value(lua_State *l, const char **read) {
+  char type = *(*read)++;
+  size_t length;
+  lua_Number number;
+
+  switch (type) {
+    case MESSAGE_NIL:
+      lua_pushnil(l);
+      break;
+
+    case MESSAGE_FALSE:
+    case MESSAGE_TRUE:
+      lua_pushboolean(l, type == MESSAGE_TRUE);
+      break;
+
+    case MESSAGE_NUMBER:
+      memcpy(&number, *read, sizeof(number));
+      *read += sizeof(number);
+      lua_pushnumber(l, number);
+      break;
+
+    case MESSAGE_STRING:
+      memcpy(&length, *read, sizeof(length));
+      *read += sizeof(length);
+      lua_pushlstring(l, *read, length);
+      *read += length;
+      break;
+
+    case MESSAGE_TABLE:
+      /* nesting is capped at MAX_DEPTH so this only fails on a full stack */
+      lua_checkstack(l, 3);
+      lua_newtable(l);
+      while (**read != MESSAGE_END) {
+        message_read_value(l, read);
+        message_read_value(l, read);
+        lua_rawset(l, -3);
+      }
+      (*read)++;
+      break;
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Serializes the top values of a stack
+  @param    l       The lua state
+  @param    count   Number of values
+  @param    error   Set to the error on failure, MAX_ERROR long
+  @return   The message else NULL
+
+  The values are left on the stack.
+
+\-----------------------------------------------------------------------------*/
+static worker_message *message_create(lua_State *l, int count, char *error) {
+  worker_message *message = calloc(1, sizeof(worker_message));
+  if (message == NULL) {
+    snprintf(error, MAX_ERROR, "out of memory");
+    return NULL;
+  }
+
+  int base = lua_gettop(l) - count + 1;
+  int failed = 0;
+  int i;
+  for (i = 0; i < count && !failed; i++) {
+    failed = message_write_value(message, l, base + i, 0, error);
+  }
+
+  if (failed) {
+    free(message->data);
+    free(message);
+    return NULL;
+  }
+  message->count = count;
+ return message;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Pushes the values of a message and frees it
+  @param    l         The lua state
+  @param    message   The message
+  @return   Number of values pushed, -1 if they do not fit the stack
+
+\-----------------------------------------------------------------------------*/
+static int message_push(lua_State *l, worker_message *message) {
+  const char *read = message->data;
+  int count = message->count;
+  int i;
+
+  if (!lua_checkstack(l, count)) {
+    count = -1;
+  }
+  for (i = 0; i < count; i++) {
+    message_read_value(l, &read);
+  }
+
+  free(message->data);
+  free(message);
+ return count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Makes an error result
+  @param    error   The error message
+  @return   The message else NULL
+
+\-----------------------------------------------------------------------------*/
+static worker_message *message_error(const char *error) {
+  worker_message *message = calloc(1, sizeof(worker_message));
+  if (message == NULL) {
+    return NULL;
+  }
+
+  size_t length = strlen(error);
+  message->count = 2;
+  if (message_write_type(message, MESSAGE_FALSE) || message_write_type(message, MESSAGE_STRING) ||
+      message_write(message, &length, sizeof(length)) || message_write(message, error, length)) {
+    free(message->data);
+    free(message);
+    return NULL;
+  }
+ return message;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a message to a queue
+  @param    queue     The queue
+  @param    message   The message
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void queue_push(worker_queue *queue, worker_message *message) {
+  message->next = NULL;
+  if (queue->tail) {
+    queue->tail->next = message;
+  } else {
+    queue->head = message;
+  }
+  queue->tail = message;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes the oldest message of a queue
+  @param    queue     The queue
+  @return   The message else NULL
+
+\-----------------------------------------------------------------------------*/
+static worker_message *queue_pop(worker_queue *queue) {
+  worker_message *message = queue->head;
+  if (message) {
+    queue->head = message->next;
+    if (queue->head == NULL) {
+      queue->tail = NULL;
+    }
+  }
+ return message;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees every message of a queue
+  @param    queue     The queue
+  @return   Void
+
+\-----------------------------------------------------------------------------*/
+static void queue_clear(worker_queue *queue) {
+  worker_message *message;
+  while ((message = queue_pop(queue)) != NULL) {
+    free(message->data);
+    free(message);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs a job
+  @param    l         The worker state, the job function at 1
+  @param    job       The job arguments, freed
+  @return   The result message else NULL
+
+\-----------------------------------------------------------------------------*/
+static worker_message *run_job(lua_State *l, worker_message *job) {
+  char error[MAX_ERROR];
+  worker_message *result;
+
+  lua_settop(l, 1);
+  lua_pushcfunction(l, splash_lua_traceback);
+  lua_pushboolean(l, 1);
+  lua_pushvalue(l, 1);
+  int nargs = message_push(l, job);
+
+  if (nargs == -1) {
+    result = message_error("too many arguments");
+  } else if (lua_pcall(l, nargs, LUA_MULTRET, 2) != LUA_OK) {
+    result = message_error(lua_tostring(l, -1));
+  } else {
+    result = message_create(l, lua_gettop(l) - 2, error);
+    if (result == NULL) {
+      result = message_error(error);
+    }
+  }
+
+  lua_settop(l, 1);
+ return result;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    The worker thread
+  @param    data    The worker
+  @return   0
+
+  Runs the script for the job function then runs jobs until told to quit.
+
+\-----------------------------------------------------------------------------*/
+static int worker_thread(void *data) {
+  Splash_lua_worker *worker = data;
+  lua_State *l = splash_lua_newstate();
+  int8_t started = -1;
+
+  if (l != NULL) {
+    luaL_openlibs(l);
+    splash_lua_register_worker(l);
+    if (splash_lua_load(l, worker->path) != 0) {
+      printf("Lua error: %s\n", lua_tostring(l, -1));
+    } else if (splash_lua_call(l, 0, 1) == 0) {
+      if (lua_isfunction(l, -1)) {
+        started = 1;
+      } else {
+        printf("Lua error: worker script %s did not return a function\n", worker->path);
+      }
+    }
+  }
+
+  SDL_LockMutex(worker->lock);
+  worker->started = started;
+  SDL_CondSignal(worker->results_ready);
+
+  while (started == 1) {
+    while (worker->jobs.head == NULL && !worker->quit) {
+      SDL_CondWait(worker->jobs_ready, worker->lock);
+    }
+    if (worker->quit) {
+      break;
+    }
+
+    worker_message *job = queue_pop(&worker->jobs);
+    SDL_UnlockMutex(worker->lock);
+
+    worker_message *result = run_job(l, job);
+
+    SDL_LockMutex(worker->lock);
+    if (result == NULL) {
+      /* keep the results in order even out of memory */
+      result = calloc(1, sizeof(worker_message));
+    }
+    if (result != NULL) {
+      queue_push(&worker->results, result);
+    }
+    SDL_CondSignal(worker->results_ready);
+  }
+  SDL_UnlockMutex(worker->lock);
+
+  if (l != NULL) {
+    splash_lua_close(l);
+  }
+  splash_pool_flush_thread_cache();
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Frees a worker
+  @param    worker  The worker
+  @return   Void
+
+  The thread must have finished.
+
+\-----------------------------------------------------------------------------*/
+static void free_worker(Splash_lua_worker *worker) {
+  queue_clear(&worker->jobs);
+  queue_clear(&worker->results);
+  if (worker->results_ready) {
+    SDL_DestroyCond(worker->results_ready);
+  }
+  if (worker->jobs_ready) {
+    SDL_DestroyCond(worker->jobs_ready);
+  }
+  if (worker->lock) {
+    SDL_DestroyMutex(worker->lock);
+  }
+  free(worker->path);
+  free(worker);
+}
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------
+  @brief    Creates a worker
+  @param    path    Path to the worker script
+  @return   New Splash_lua_worker otherwise NULL.
+
+  Starts a thread with its own lua state and waits for the script to
+  return the job function.
+
+\-----------------------------------------------------------------------------*/
+Splash_lua_worker *splash_lua_worker_create(const char *path) {
+  Splash_lua_worker *worker = calloc(1, sizeof(Splash_lua_worker));
+  if (worker == NULL) {
+    return NULL;
+  }
+
+  worker->path = malloc(strlen(path) + 1);
+  worker->lock = SDL_CreateMutex();
+  worker->jobs_ready = SDL_CreateCond();
+  worker->results_ready = SDL_CreateCond();
+  if (!worker->path || !worker->lock || !worker->jobs_ready || !worker->results_ready) {
+    free_worker(worker);
+    return NULL;
+  }
+  strcpy(worker->path, path);
+
+  worker->thread = SDL_CreateThread(worker_thread, "splash worker", worker);
+  if (worker->thread == NULL) {
+    free_worker(worker);
+    return NULL;
+  }
+
+  SDL_LockMutex(worker->lock);
+  while (worker->started == 0) {
+    SDL_CondWait(worker->results_ready, worker->lock);
+  }
+  SDL_UnlockMutex(worker->lock);
+
+  if (worker->started == -1) {
+    SDL_WaitThread(worker->thread, NULL);
+    free_worker(worker);
+    return NULL;
+  }
+ return worker;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Posts a job
+  @param    worker  The worker
+  @param    l       The lua state holding the arguments
+  @param    nargs   Number of arguments on top of the stack
+  @return   0 on success else -1
+
+  Copies and pops the arguments, on failure the error message is left on
+  the stack.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_worker_post(Splash_lua_worker *worker, lua_State *l, int nargs) {
+  char error[MAX_ERROR];
+  worker_message *job = message_create(l, nargs, error);
+
+  lua_pop(l, nargs);
+  if (job == NULL) {
+    lua_pushstring(l, error);
+    return -1;
+  }
+
+  SDL_LockMutex(worker->lock);
+  queue_push(&worker->jobs, job);
+  worker->pending++;
+  SDL_CondSignal(worker->jobs_ready);
+  SDL_UnlockMutex(worker->lock);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Takes a result
+  @param    worker  The worker
+  @param    l       The lua state to push the result to
+  @param    wait    Block until a result is ready
+  @return   Number of values pushed, -1 if no result is ready
+
+  Pushes true and the values the job returned, or false and the error.
+  Never blocks when no jobs are pending.
+
+\-----------------------------------------------------------------------------*/
+int splash_lua_worker_result(Splash_lua_worker *worker, lua_State *l, int8_t wait) {
+  SDL_LockMutex(worker->lock);
+  while (worker->results.head == NULL && wait && worker->pending > 0) {
+    SDL_CondWait(worker->results_ready, worker->lock);
+  }
+
+  worker_message *result = queue_pop(&worker->results);
+  if (result != NULL) {
+    worker->pending--;
+  }
+  SDL_UnlockMutex(worker->lock);
+
+  if (result == NULL) {
+    return -1;
+  }
+
+  if (result->count == 0) {
+    free(result);
+    lua_pushboolean(l, 0);
+    lua_pushliteral(l, "out of memory");
+    return 2;
+  }
+
+  int count = message_push(l, result);
+  if (count == -1) {
+    lua_pushboolean(l, 0);
+    lua_pushliteral(l, "too many results");
+    return 2;
+  }
+ return count;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the number of pending jobs
+  @param    worker  The worker
+  @return   Jobs posted whose results have not been taken
+
+\-----------------------------------------------------------------------------*/
+int32_t splash_lua_worker_pending(Splash_lua_worker *worker) {
+  SDL_LockMutex(worker->lock);
+  int32_t pending = worker->pending;
+  SDL_UnlockMutex(worker->lock);
+ return pending;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Destroys a worker
+  @param    worker  The worker
+  @return   Void
+
+  Finishes the running job, drops the rest and joins the thread.
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_worker_destroy(Splash_lua_worker *worker) {
+  if (worker == NULL) {
+    return;
+  }
+
+  SDL_LockMutex(worker->lock);
+  worker->quit = 1;
+  SDL_CondSignal(worker->jobs_ready);
+  SDL_UnlockMutex(worker->lock);
+
+  SDL_WaitThread(worker->thread, NULL);
+  free_worker(worker);
+}
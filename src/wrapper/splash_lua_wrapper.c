@@ -14,8 +14,19 @@
  ---------------------------------------------------------------------------*/
 
 #include "Splash/Splash_lua_wrapper.h"
+#include "Splash/Splash_lua_reload.h"
 #include "lua_wrapper/lua_wrappers.h"
 #include "lua/lua.h"
+#include "lua/lauxlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#endif
 
 
 /*---------------------------------------------------------------------------
@@ -24,6 +35,150 @@
 
 lua_State *splash_lua_state; /**< Global lua state */
 
+#ifdef SPLASH_LUAJIT
+#define SPLASH_LUA_BACKEND "LuaJIT"
+#else
+#define SPLASH_LUA_BACKEND LUA_VERSION
+#endif
+
+static char *cache_directory = NULL;  /**< where compiled chunks are kept, NULL when off */
+static int8_t cache_strip = 0;        /**< strip debug info from cached chunks */
+
+/*!--------------------------------------------------------------------------
+  @brief    Reads a whole file
+  @param    path    The file to read
+  @param    size    Set to the number of bytes read
+  @return   The contents, NULL on failure
+
+  The caller frees the returned buffer.
+
+\-----------------------------------------------------------------------------*/
+static char *read_file(const char *path, size_t *size) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  char *buffer = NULL;
+  size_t length = 0;
+  size_t capacity = 0;
+  size_t read;
+  do {
+    if (capacity - length < 4096) {
+      capacity = capacity ? capacity * 2 : 8192;
+      char *grown = realloc(buffer, capacity);
+      if (grown == NULL) {
+        free(buffer);
+        fclose(file);
+        return NULL;
+      }
+      buffer = grown;
+    }
+    read = fread(buffer + length, 1, capacity - length, file);
+    length += read;
+  } while (read > 0);
+
+  int failed = ferror(file);
+  fclose(file);
+  if (failed) {
+    free(buffer);
+    return NULL;
+  }
+  *size = length;
+ return buffer;
+}
+
+/*!--------------------------------------------------------------------------
+  @brief    Hashes a script for the cache
+  @param    name    The chunk name
+  @param    source  The script source
+  @param    size    Size of the source
+  @return   64 bit FNV-1a of the backend, strip flag, chunk name and source
+
+  The backend and strip flag are part of the key so chunks from another
+  Lua build or strip setting are never picked up. The chunk name is part
+  of it as the dumped chunk keeps it for error messages, so the same
+  source at two paths gets two entries.
+
+\-----------------------------------------------------------------------------*/
+static uint64_t hash_source(const char *name, const char *source, size_t size) {
+  uint64_t hash = 14695981039346656037ULL;
+  const char *backend = SPLASH_LUA_BACKEND;
+  size_t i;
+
+  for (i = 0; backend[i] != '\0'; i++) {
+    hash = (hash ^ (unsigned char)backend[i]) * 1099511628211ULL;
+  }
+  hash = (hash ^ (unsigned char)(cache_strip + sizeof(void *))) * 1099511628211ULL;
+  for (i = 0; name[i] != '\0'; i++) {
+    hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL;
+  }
+  /* hash the terminator too so name and source stay apart */
+  hash *= 1099511628211ULL;
+  for (i = 0; i < size; i++) {
+    hash = (hash ^ (unsigned char)source[i]) * 1099511628211ULL;
+  }
+ return hash;
+}
+
+/*!--------------------------------------------------------------------------
+  @brief    lua_Writer into a file
+  @return   0 on success else 1
+
+\-----------------------------------------------------------------------------*/
+static int write_chunk(lua_State *l, const void *p, size_t size, void *file) {
+ return fwrite(p, 1, size, file) != size;
+}
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes the function on top of the stack to the cache
+  @param    l       The lua state
+  @param    path    The cache entry
+  @return   Void
+
+  Written to a temporary file and renamed so a half written chunk is never
+  loaded. An old entry is removed first as rename will not replace a file
+  on every platform. Failing to write just leaves the script uncached.
+
+\-----------------------------------------------------------------------------*/
+static void store_chunk(lua_State *l, const char *path) {
+  char temp[FILENAME_MAX];
+  snprintf(temp, sizeof(temp), "%s.tmp", path);
+
+  FILE *file = fopen(temp, "wb");
+  if (file == NULL) {
+    return;
+  }
+
+  int failed;
+#ifdef SPLASH_LUAJIT
+  if (cache_strip) {
+    /* only string.dump takes the strip flag on LuaJIT */
+    size_t size;
+    lua_getglobal(l, "string");
+    lua_getfield(l, -1, "dump");
+    lua_pushvalue(l, -3);
+    lua_pushboolean(l, 1);
+    failed = lua_pcall(l, 2, 1, 0) != LUA_OK;
+    if (!failed) {
+      const char *chunk = lua_tolstring(l, -1, &size);
+      failed = fwrite(chunk, 1, size, file) != size;
+    }
+    lua_pop(l, 2);
+  } else
+#endif
+  failed = lua_dump(l, write_chunk, file) != 0;
+
+  failed |= fclose(file) != 0;
+  if (!failed) {
+    remove(path);
+    failed = rename(temp, path) != 0;
+  }
+  if (failed) {
+    remove(temp);
+  }
+}
+
 /*---------------------------------------------------------------------------
                             Function codes
  ---------------------------------------------------------------------------*/
@@ -41,4 +196,207 @@ void splash_lua_register_all(lua_State *l) {
   l_splash_state_register(l);
   l_splash_renderer_register(l);
   l_splash_camera_register(l);
-}
\ No newline at end of file
+  l_splash_texture_register(l);
+  l_splash_timer_register(l);
+  l_splash_task_register(l);
+  l_splash_event_register(l);
+  l_splash_profiler_register(l);
+  l_splash_worker_register(l);
+  l_splash_reload_register(l);
+  l_splash_batch_register(l);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Registrars the worker safe functions with lua
+  @param    l   The state to register to
+  @return   Void
+
+  Registrars the bindings that keep no global state, used for the states
+  of the lua workers.
+
+\-----------------------------------------------------------------------------*/
+void splash_lua_register_worker(lua_State *l) {
+  l_splash_camera_register(l);
+  l_splash_batch_register(l);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Adds a traceback to an error
+  @param    l   The lua state
+  @return   1, the error message with a traceback
+
+  Message handler for lua_pcall that appends a stack traceback to the error
+
+\-----------------------------------------------------------------------------*/
+int splash_lua_traceback(lua_State *l) {
+  const char *message = lua_tostring(l, 1);
+
+  if (message == NULL) {
+    if (luaL_callmeta(l, 1, "__tostring") && lua_type(l, -1) == LUA_TSTRING) {
+      return 1;
+    }
+    message = lua_pushfstring(l, "(error object is a %s value)", luaL_typename(l, 1));
+  }
+
+  luaL_traceback(l, l, message, 1);
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Calls a lua function
+  @param    l         The lua state
+  @param    nargs     Number of arguments pushed after the function
+  @param    nresults  Number of results to keep
+  @return   0 on success else -1
+
+  Calls the function with splash_lua_traceback as the message handler,
+  errors are printed with their traceback and popped.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_call(lua_State *l, int nargs, int nresults) {
+  int handler = lua_gettop(l) - nargs;
+
+  lua_pushcfunction(l, splash_lua_traceback);
+  lua_insert(l, handler);
+
+  int status = lua_pcall(l, nargs, nresults, handler);
+  lua_remove(l, handler);
+
+  if (status != LUA_OK) {
+    printf("Lua error: %s\n", lua_tostring(l, -1));
+    lua_pop(l, 1);
+    return -1;
+  }
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Sets the script cache
+  @param    directory   Directory to keep compiled chunks in, NULL to disable
+  @param    strip       Strip debug info from the cached chunks
+  @return   0 on success else -1
+
+  Scripts loaded with splash_lua_load are compiled once and kept in
+  directory as bytecode keyed by a hash of their source.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_set_cache(const char *directory, int8_t strip) {
+  free(cache_directory);
+  cache_directory = NULL;
+  cache_strip = strip;
+
+  if (directory == NULL) {
+    return 0;
+  }
+
+  if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+    printf("Could not create script cache %s: %s\n", directory, strerror(errno));
+    return -1;
+  }
+
+  cache_directory = malloc(strlen(directory) + 1);
+  if (cache_directory == NULL) {
+    return -1;
+  }
+  strcpy(cache_directory, directory);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Loads a lua script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Pushes the script as a function like luaL_loadfile, or the error
+  message on failure. A cached chunk is loaded without parsing, on a miss
+  the source is compiled and dumped to the cache.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_load(lua_State *l, const char *path) {
+  if (cache_directory == NULL) {
+    return luaL_loadfile(l, path) == LUA_OK ? 0 : -1;
+  }
+
+  size_t size;
+  char *source = read_file(path, &size);
+  if (source == NULL) {
+    lua_pushfstring(l, "cannot read %s", path);
+    return -1;
+  }
+
+  const char *name = lua_pushfstring(l, "@%s", path);
+  int status;
+
+  /* already bytecode, nothing to cache */
+  if (size > 0 && source[0] == LUA_SIGNATURE[0]) {
+    status = luaL_loadbuffer(l, source, size, name);
+    free(source);
+    lua_remove(l, -2);
+    return status == LUA_OK ? 0 : -1;
+  }
+
+  char cached[FILENAME_MAX];
+  snprintf(cached, sizeof(cached), "%s/%016llx.luac", cache_directory, (unsigned long long)hash_source(name, source, size));
+
+  size_t chunk_size;
+  char *chunk = read_file(cached, &chunk_size);
+  if (chunk != NULL) {
+    status = luaL_loadbufferx(l, chunk, chunk_size, name, "b");
+    free(chunk);
+    if (status == LUA_OK) {
+      free(source);
+      lua_remove(l, -2);
+      return 0;
+    }
+    /* unreadable entry, compile it again */
+    lua_pop(l, 1);
+  }
+
+  /* comment out a #! line like luaL_loadfile, keeping the line numbers */
+  if (size > 1 && source[0] == '#' && source[1] != '\n') {
+    source[0] = '-';
+    source[1] = '-';
+  } else if (size > 0 && source[0] == '#') {
+    source[0] = ' ';
+  }
+
+  status = luaL_loadbufferx(l, source, size, name, "t");
+  free(source);
+  lua_remove(l, -2);
+  if (status != LUA_OK) {
+    return -1;
+  }
+
+  store_chunk(l, cached);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Runs a lua script
+  @param    l     The lua state
+  @param    path  Path to the script
+  @return   0 on success else -1
+
+  Loads the script with splash_lua_load and calls it with
+  splash_lua_call, errors are printed and popped. With hot reload on the
+  script is watched, see splash_lua_watch.
+
+\-----------------------------------------------------------------------------*/
+int8_t splash_lua_dofile(lua_State *l, const char *path) {
+  if (splash_lua_get_hot_reload()) {
+    return splash_lua_watch(l, path);
+  }
+  if (splash_lua_load(l, path) != 0) {
+    printf("Lua error: %s\n", lua_tostring(l, -1));
+    lua_pop(l, 1);
+    return -1;
+  }
+ return splash_lua_call(l, 0, 0);
+}
@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashArrayTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void array_test_push() {
+	Splash_array *array = splash_array_create();
+	int i;
+
+	assert(array != NULL && "Failed to create array");
+	assert(splash_array_get(array, 0) == (void *)-1 && "Got from an empty array");
+	assert(splash_array_pop(array) == (void *)-1 && "Popped from an empty array");
+
+	for (i = 0; i < 1000; i++) {
+		assert(splash_array_push(array, (void *)(intptr_t)i) == 0 && "Failed to push");
+	}
+	assert(splash_array_get_size(array) == 1000 && "Wrong size");
+	assert(splash_array_get(array, 999) == (void *)999 && "Failed to get");
+	assert(splash_array_get(array, 1000) == (void *)-1 && "Got past the end");
+	assert(splash_array_get(array, -1) == (void *)-1 && "Got before the start");
+	assert(splash_array_get_position(array, (void *)500) == 500 && "Failed to find");
+	assert(splash_array_get_position(array, (void *)5000) == -1 && "Found missing data");
+
+	splash_array_set(array, 3, (void *)42);
+	assert(splash_array_get(array, 3) == (void *)42 && "Failed to set");
+
+	assert(splash_array_pop(array) == (void *)999 && "Failed to pop");
+	assert(splash_array_get_size(array) == 999 && "Pop did not shrink");
+	splash_array_destroy(array);
+}
+
+
+static void array_test_remove() {
+	Splash_array *array = splash_array_create();
+	void *items[5] = {(void *)1, (void *)2, (void *)3, (void *)4, (void *)5};
+
+	assert(splash_array_append(array, items, 5) == 0 && "Failed to append");
+	splash_array_remove_position(array, 1);
+	assert(splash_array_get_size(array) == 4 && "Remove did not shrink");
+	assert(splash_array_get(array, 1) == (void *)3 && splash_array_get(array, 3) == (void *)5 && "Order not kept");
+
+	splash_array_swap_remove(array, 0);
+	assert(splash_array_get(array, 0) == (void *)5 && "Last not moved into the gap");
+	assert(splash_array_get_size(array) == 3 && "Swap remove did not shrink");
+
+	splash_array_swap_remove(array, 2);
+	assert(splash_array_get_size(array) == 2 && "Failed to swap remove the last");
+	splash_array_remove_position(array, 7);
+	assert(splash_array_get_size(array) == 2 && "Removed past the end");
+
+	splash_array_remove_all(array);
+	assert(splash_array_get_size(array) == 0 && "Failed to remove all");
+	splash_array_destroy(array);
+}
+
+
+static void array_test_reserve() {
+	Splash_array *array = splash_array_create();
+	int i;
+
+	assert(splash_array_reserve(array, 300) == 0 && "Failed to reserve");
+	void **data = array->data;
+	assert(array->capacity >= 300 && "Reserved too little");
+	for (i = 0; i < 300; i++) {
+		splash_array_push(array, (void *)(intptr_t)i);
+	}
+	assert(array->data == data && "Grew after reserving");
+
+
+	void *more[300];
+	for (i = 0; i < 300; i++) {
+		more[i] = (void *)(intptr_t)(i + 300);
+	}
+	assert(splash_array_append(array, more, 300) == 0 && "Failed to append past the capacity");
+	assert(splash_array_get(array, 599) == (void *)599 && splash_array_get(array, 299) == (void *)299 && "Append lost data");
+	splash_array_destroy(array);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	array_test_push();
+	array_test_remove();
+	array_test_reserve();
+ return 0;
+}
@@ -0,0 +1,111 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashBatchTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+
+#define COUNT 1001
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void test_buffer() {
+	Splash_buffer *buffer = splash_buffer_create(COUNT);
+	assert(buffer != NULL && "Failed to create buffer!");
+	assert(buffer->length == COUNT && "Wrong buffer length!");
+
+	int i;
+	for (i = 0; i < COUNT; i++) {
+		assert(buffer->data[i] == 0 && "Buffer not cleared!");
+	}
+	splash_buffer_destroy(buffer);
+
+	buffer = splash_buffer_create(0);
+	assert(buffer != NULL && buffer->length == 0 && "Failed to create empty buffer!");
+	splash_buffer_destroy(buffer);
+
+	assert(splash_buffer_create(-1) == NULL && "Created negative buffer!");
+	splash_buffer_destroy(NULL);
+}
+
+
+static void test_integrate() {
+	Splash_buffer *positions = splash_buffer_create(COUNT);
+	Splash_buffer *velocities = splash_buffer_create(COUNT);
+
+	int i;
+	for (i = 0; i < COUNT; i++) {
+		positions->data[i] = i;
+		velocities->data[i] = i % 4;
+	}
+
+	splash_batch_integrate(positions->data, velocities->data, COUNT, 0.5f);
+	for (i = 0; i < COUNT; i++) {
+		assert(positions->data[i] == i + (i % 4) * 0.5f && "Wrong integrated position!");
+	}
+
+	splash_batch_integrate(positions->data, velocities->data, 0, 1);
+	assert(positions->data[1] == 1.5f && "Integrated past the count!");
+
+	splash_buffer_destroy(positions);
+	splash_buffer_destroy(velocities);
+}
+
+
+static void test_positions() {
+	Splash_buffer *positions = splash_buffer_create(COUNT * 2);
+	int32_t visible[COUNT];
+
+	int i;
+	for (i = 0; i < COUNT; i++) {
+		positions->data[i * 2] = i;
+		positions->data[i * 2 + 1] = -i;
+	}
+
+	splash_batch_translate(positions->data, COUNT, 10, 20);
+	for (i = 0; i < COUNT; i++) {
+		assert(positions->data[i * 2] == i + 10 && "Wrong translated x!");
+		assert(positions->data[i * 2 + 1] == 20 - i && "Wrong translated y!");
+	}
+
+	assert(splash_batch_cull(positions->data, COUNT, 100, -1000, 199, 1000, NULL) == 100 && "Wrong culled count!");
+	assert(splash_batch_cull(positions->data, COUNT, 100, -1000, 199, 1000, visible) == 100 && "Wrong culled count!");
+	for (i = 0; i < 100; i++) {
+		assert(visible[i] == i + 90 && "Wrong visible index!");
+	}
+	assert(splash_batch_cull(positions->data, COUNT, 0, 0, 1, 1, visible) == 0 && "Culled outside positions!");
+
+	splash_batch_clamp(positions->data, COUNT, 0, -100, 500, 0);
+	for (i = 0; i < COUNT; i++) {
+		float x = i + 10 > 500 ? 500 : i + 10;
+		float y = 20 - i > 0 ? 0 : (20 - i < -100 ? -100 : 20 - i);
+		assert(positions->data[i * 2] == x && "Wrong clamped x!");
+		assert(positions->data[i * 2 + 1] == y && "Wrong clamped y!");
+	}
+
+	splash_buffer_destroy(positions);
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_buffer();
+		test_integrate();
+		test_positions();
+		assert(splash_lua_dofile(splash_lua_state, "../scripts/test/batch_test.lua") == 0 && "Batch script failed!");
+
+	splash_quit();
+  return 0;
+}
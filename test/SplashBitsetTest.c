@@ -0,0 +1,117 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashBitsetTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void bitset_test_bits() {
+	Splash_bitset *bitset = splash_bitset_create(100);
+	int32_t i;
+
+	assert(bitset != NULL && "Failed to create bitset");
+	assert(splash_bitset_get_size(bitset) == 100 && "Wrong size");
+	assert(splash_bitset_count(bitset) == 0 && "New bitset not clear");
+
+	for (i = 0; i < 100; i += 3) {
+		assert(splash_bitset_set(bitset, i) == 0 && "Failed to set");
+	}
+	assert(splash_bitset_count(bitset) == 34 && "Wrong count");
+	assert(splash_bitset_test(bitset, 99) == 1 && splash_bitset_test(bitset, 98) == 0 && "Wrong bit");
+	assert(splash_bitset_test(bitset, 1000) == 0 && splash_bitset_test(bitset, -1) == 0 && "Bit outside is set");
+
+	splash_bitset_clear(bitset, 99);
+	assert(splash_bitset_test(bitset, 99) == 0 && "Failed to clear");
+
+	assert(splash_bitset_set(bitset, 5000) == 0 && "Failed to grow");
+	assert(splash_bitset_get_size(bitset) == 5001 && "Wrong size after growing");
+	assert(splash_bitset_count(bitset) == 34 && "Growing lost bits");
+
+	splash_bitset_resize(bitset, 10);
+	assert(splash_bitset_count(bitset) == 4 && "Shrinking kept bits");
+	splash_bitset_resize(bitset, 200);
+	assert(splash_bitset_test(bitset, 99) == 0 && splash_bitset_count(bitset) == 4 && "Cut off bits came back");
+
+	splash_bitset_clear_all(bitset);
+	assert(splash_bitset_count(bitset) == 0 && "Failed to clear all");
+	splash_bitset_destroy(bitset);
+}
+
+
+static void bitset_test_operations() {
+	Splash_bitset *a = splash_bitset_create(0);
+	Splash_bitset *b = splash_bitset_create(0);
+	int32_t i;
+
+	for (i = 0; i < 1000; i += 2) {
+		splash_bitset_set(a, i);
+	}
+	for (i = 0; i < 3000; i += 3) {
+		splash_bitset_set(b, i);
+	}
+
+	assert(splash_bitset_or(a, b) == 0 && "Failed to or");
+	assert(splash_bitset_get_size(a) == splash_bitset_get_size(b) && "Or did not grow");
+	assert(splash_bitset_count(a) == 500 + 1000 - 167 && "Wrong count after or");
+
+	splash_bitset_and(a, b);
+	assert(splash_bitset_count(a) == 1000 && "Wrong count after and");
+	for (i = 0; i < 3000; i++) {
+		assert(splash_bitset_test(a, i) == (i % 3 == 0) && "Wrong bit after and");
+	}
+
+	splash_bitset_clear_all(b);
+	for (i = 0; i < 3000; i += 6) {
+		splash_bitset_set(b, i);
+	}
+	splash_bitset_andnot(a, b);
+	assert(splash_bitset_count(a) == 500 && "Wrong count after andnot");
+	assert(splash_bitset_test(a, 3) == 1 && splash_bitset_test(a, 6) == 0 && "Wrong bit after andnot");
+	splash_bitset_destroy(a);
+	splash_bitset_destroy(b);
+}
+
+
+static void bitset_test_next() {
+	Splash_bitset *bitset = splash_bitset_create(1000);
+	int32_t bits[5] = {0, 63, 64, 500, 999};
+	int32_t found = 0;
+	int32_t i;
+
+	assert(splash_bitset_next(bitset, 0) == -1 && "Found a bit in a clear bitset");
+	for (i = 0; i < 5; i++) {
+		splash_bitset_set(bitset, bits[i]);
+	}
+
+	for (i = splash_bitset_next(bitset, 0); i != -1; i = splash_bitset_next(bitset, i + 1)) {
+		assert(i == bits[found] && "Found the wrong bit");
+		found++;
+	}
+	assert(found == 5 && "Missed a bit");
+	assert(splash_bitset_next(bitset, 501) == 999 && "Failed to skip clear words");
+	assert(splash_bitset_next(bitset, 1000) == -1 && "Found a bit past the end");
+	splash_bitset_destroy(bitset);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	bitset_test_bits();
+	bitset_test_operations();
+	bitset_test_next();
+ return 0;
+}
@@ -0,0 +1,143 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashContainerTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <string.h>
+
+typedef struct Particle {
+	float x;
+	float y;
+	int32_t life;
+} Particle;
+
+static uint64_t hash_string(const char *key) {
+	return splash_hashmap_hash_string(key);
+}
+
+static int8_t equal_string(const char *a, const char *b) {
+	return strcmp(a, b) == 0;
+}
+
+SPLASH_ARRAY(Particles, Particle)
+SPLASH_DEQUE(Int_deque, int32_t)
+SPLASH_MAP(Particle_map, uint64_t, Particle, splash_container_hash_int, splash_container_equal_int)
+SPLASH_MAP(Name_map, const char *, double, hash_string, equal_string)
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void array_test() {
+	Particles particles;
+	Particle particle = {1.5f, 2.5f, 10};
+	Particle popped;
+	int i;
+
+	Particles_init(&particles);
+	assert(Particles_pop(&particles, &popped) == -1 && "Popped from an empty array");
+	for (i = 0; i < 1000; i++) {
+		particle.life = i;
+		assert(Particles_push(&particles, particle) == 0 && "Failed to push");
+	}
+	assert(particles.size == 1000 && "Wrong size");
+	assert(Particles_at(&particles, 999)->life == 999 && Particles_at(&particles, 0)->x == 1.5f && "Value not stored inline");
+	assert(Particles_at(&particles, 1000) == NULL && "Got past the end");
+
+	Particles_swap_remove(&particles, 0);
+	assert(Particles_at(&particles, 0)->life == 999 && "Last not moved into the gap");
+	assert(Particles_pop(&particles, &popped) == 0 && popped.life == 998 && "Failed to pop");
+
+	Particle *slot = Particles_push_slot(&particles);
+	slot->life = -1;
+	assert(Particles_at(&particles, particles.size - 1)->life == -1 && "Failed to fill a slot");
+
+	Particles_clear(&particles);
+	assert(particles.size == 0 && "Failed to clear");
+	Particles_free(&particles);
+}
+
+
+static void deque_test() {
+	Int_deque deque;
+	int32_t value;
+	int i;
+
+	Int_deque_init(&deque);
+	for (i = 0; i < 10; i++) {
+		Int_deque_push_back(&deque, i);
+		Int_deque_push_front(&deque, -i - 1);
+	}
+	assert(deque.size == 20 && "Wrong size");
+	assert(*Int_deque_at(&deque, 0) == -10 && *Int_deque_at(&deque, 19) == 9 && "Wrong order after wrapping");
+
+	/* walk the ring round several times while it grows */
+	for (i = 0; i < 100; i++) {
+		assert(Int_deque_pop_front(&deque, &value) == 0 && "Failed to pop front");
+		Int_deque_push_back(&deque, value);
+		Int_deque_push_back(&deque, 1000 + i);
+	}
+	assert(deque.size == 120 && "Wrong size after growing");
+	assert(Int_deque_pop_back(&deque, &value) == 0 && value == 1099 && "Failed to pop back");
+
+	Int_deque_clear(&deque);
+	assert(Int_deque_pop_front(&deque, &value) == -1 && "Popped from an empty deque");
+	Int_deque_free(&deque);
+}
+
+
+static void map_test() {
+	Particle_map map;
+	Particle particle = {0, 0, 0};
+	int i;
+
+	Particle_map_init(&map);
+	assert(Particle_map_get(&map, 5) == NULL && "Got from an empty map");
+	for (i = 0; i < 5000; i++) {
+		particle.life = i;
+		assert(Particle_map_put(&map, (uint64_t)i * 7, particle) == 0 && "Failed to put");
+	}
+	assert(map.size == 5000 && "Wrong size");
+	for (i = 0; i < 5000; i += 2) {
+		assert(Particle_map_remove(&map, (uint64_t)i * 7) == 1 && "Failed to remove");
+	}
+	assert(Particle_map_remove(&map, 1) == 0 && "Removed a missing key");
+	for (i = 0; i < 5000; i++) {
+		Particle *found = Particle_map_get(&map, (uint64_t)i * 7);
+		assert((i % 2 ? found != NULL && found->life == i : found == NULL) && "Wrong entry after removing");
+	}
+
+	particle.life = -5;
+	Particle_map_put(&map, 7, particle);
+	assert(Particle_map_get(&map, 7)->life == -5 && map.size == 2500 && "Failed to replace");
+	Particle_map_clear(&map);
+	assert(Particle_map_get(&map, 7) == NULL && "Failed to clear");
+	Particle_map_free(&map);
+
+	Name_map names;
+	char key[16];
+	Name_map_init(&names);
+	Name_map_put(&names, "gravity", 9.8);
+	strcpy(key, "gravity");
+	assert(Name_map_get(&names, key) != NULL && *Name_map_get(&names, key) == 9.8 && "Failed to get by content");
+	Name_map_free(&names);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	array_test();
+	deque_test();
+	map_test();
+ return 0;
+}
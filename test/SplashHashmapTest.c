@@ -15,6 +15,7 @@
 #include <string.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stdio.h>
     
 static char *string = "This is another super long string much like the one in my window test to see wheather the linked list can accuraly store and very long string properly but hey at least it sais somthing \
 						diffrent right? !£$%^&*()_+¬`{}@~:<>?/.,#';][/*-+|¦ see thats me encoding a secret message in side the string to make this more intresting for myself (half life 3 confmed?) ahhhhhhh how \
@@ -104,6 +105,167 @@ static void hashmap_test_size() {
 }
 
 
+static void hashmap_test_many() {
+	Splash_hashmap *hashmap = splash_hashmap_create();
+	static char keys[5000][16];
+	char key[16];
+	int i;
+
+	for (i = 0; i < 5000; i++) {
+		sprintf(keys[i], "key%d", i);
+		splash_hashmap_add(hashmap, keys[i], keys[i]);
+	}
+	assert(splash_hashmap_get_size(hashmap) == 5000 && "Failed to grow");
+
+	for (i = 0; i < 5000; i++) {
+		sprintf(key, "key%d", i);
+		assert(splash_hashmap_get(hashmap, key) == keys[i] && "Failed to get copied key");
+	}
+
+	for (i = 0; i < 5000; i += 2) {
+		splash_hashmap_remove(hashmap, keys[i]);
+	}
+	assert(splash_hashmap_get_size(hashmap) == 2500 && "Failed to remove half");
+
+	for (i = 0; i < 5000; i++) {
+		void *expected = i % 2 ? keys[i] : (void *)-1;
+		assert(splash_hashmap_get(hashmap, keys[i]) == expected && "Lost key after remove");
+	}
+
+	splash_hashmap_remove(hashmap, "missing");
+	assert(splash_hashmap_get_size(hashmap) == 2500 && "Removed missing key");
+	splash_hashmap_destory(hashmap);
+}
+
+
+static uint64_t hash_first(const void *key) {
+	return *(const char *)key;
+}
+
+
+static void hashmap_test_keys() {
+	Splash_hashmap *hashmap = splash_hashmap_create_int();
+	int i;
+
+	for (i = -1000; i < 1000; i++) {
+		splash_hashmap_add(hashmap, SPLASH_HASHMAP_INT(i), SPLASH_HASHMAP_INT(i * 2));
+	}
+	assert(splash_hashmap_get_size(hashmap) == 2000 && "Failed to add int keys");
+	assert(splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(0)) == SPLASH_HASHMAP_INT(0) && "Failed to get zero key");
+	assert(splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(-7)) == SPLASH_HASHMAP_INT(-14) && "Failed to get int key");
+	assert(splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(1000)) == (void *)-1 && "Got missing int key");
+	splash_hashmap_destory(hashmap);
+
+	char first[] = "key";
+	char second[] = "key";
+	hashmap = splash_hashmap_create_pointer();
+	splash_hashmap_add(hashmap, first, "first");
+	splash_hashmap_add(hashmap, second, "second");
+	assert(splash_hashmap_get_size(hashmap) == 2 && "Pointer keys compared by contents");
+	assert(strcmp(splash_hashmap_get_string(hashmap, first), "first") == 0 && "Failed to get pointer key");
+	splash_hashmap_destory(hashmap);
+
+	hashmap = splash_hashmap_create();
+	splash_hashmap_add(hashmap, first, "first");
+	splash_hashmap_add(hashmap, second, "second");
+	assert(splash_hashmap_get_size(hashmap) == 1 && "String keys compared by address");
+	assert(strcmp(splash_hashmap_get_string(hashmap, first), "second") == 0 && "Failed to replace string key");
+	splash_hashmap_destory(hashmap);
+
+	/* every key collides */
+	hashmap = splash_hashmap_create_with(hash_first, splash_hashmap_equal_string);
+	splash_hashmap_add(hashmap, "a1", "1");
+	splash_hashmap_add(hashmap, "a2", "2");
+	splash_hashmap_add(hashmap, "a3", "3");
+	splash_hashmap_remove(hashmap, "a2");
+	assert(splash_hashmap_get_int(hashmap, "a1") == 1 && "Failed to get colliding key");
+	assert(splash_hashmap_get_int(hashmap, "a3") == 3 && "Failed to get moved key");
+	assert(splash_hashmap_get(hashmap, "a2") == (void *)-1 && "Failed to remove colliding key");
+	splash_hashmap_destory(hashmap);
+
+	assert(splash_hashmap_create_with(NULL, NULL) == NULL && "Created hashmap without hash");
+	assert(splash_hashmap_hash_string("abcdefghij") != splash_hashmap_hash_string("abcdefghik") && "Tail not hashed");
+}
+
+
+static void hashmap_test_incremental() {
+	Splash_hashmap *hashmap = splash_hashmap_create_int();
+	int migrating = 0;
+	int i;
+
+	splash_hashmap_set_incremental(hashmap, 4);
+	for (i = 0; i < 20000; i++) {
+		splash_hashmap_add(hashmap, SPLASH_HASHMAP_INT(i), SPLASH_HASHMAP_INT(i + 1));
+		migrating |= hashmap->old_control != NULL;
+		assert(splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(i)) == SPLASH_HASHMAP_INT(i + 1) && "Lost key while migrating");
+		if (i % 3 == 0) {
+			splash_hashmap_remove(hashmap, SPLASH_HASHMAP_INT(i / 2));
+		}
+	}
+	assert(migrating && "Grew all at once");
+
+	for (i = 0; i < 20000; i++) {
+		int removed = ((i * 2) % 3 == 0 && i * 2 < 20000) || ((i * 2 + 1) % 3 == 0 && i * 2 + 1 < 20000);
+		void *expected = removed ? (void *)-1 : SPLASH_HASHMAP_INT(i + 1);
+		assert(splash_hashmap_get(hashmap, SPLASH_HASHMAP_INT(i)) == expected && "Wrong value after migrating");
+	}
+
+	splash_hashmap_set_incremental(hashmap, 0);
+	assert(hashmap->old_control == NULL && "Migration not finished");
+	splash_hashmap_destory(hashmap);
+
+	hashmap = splash_hashmap_create();
+	assert(splash_hashmap_reserve(hashmap, 10000) == 0 && "Failed to reserve");
+	assert(splash_hashmap_get_capacity(hashmap) >= 10000 && "Reserved too little");
+	int32_t size = hashmap->size;
+	static char keys[10000][16];
+	for (i = 0; i < 10000; i++) {
+		sprintf(keys[i], "key%d", i);
+		splash_hashmap_add(hashmap, keys[i], keys[i]);
+	}
+	assert(hashmap->size == size && "Grew after reserving");
+	splash_hashmap_destory(hashmap);
+}
+
+
+
+static void hashmap_test_typed() {
+	Splash_hashmap *hashmap = splash_hashmap_create();
+	splash_hashmap_set_int(hashmap, "int", 5000000000LL);
+	splash_hashmap_set_double(hashmap, "double", 3.125);
+	splash_hashmap_set_string(hashmap, "string", "42");
+	splash_hashmap_add(hashmap, "pointer", "7");
+
+	assert(splash_hashmap_get_int64(hashmap, "int") == 5000000000LL && "Failed to get int64");
+	assert(splash_hashmap_get_double(hashmap, "double") == 3.125 && "Failed to get typed double");
+	assert(splash_hashmap_get_float(hashmap, "double") == 3.125f && "Failed to convert double");
+	assert(splash_hashmap_get_int(hashmap, "double") == 3 && "Failed to convert double to int");
+	assert(splash_hashmap_get_double(hashmap, "int") == 5000000000.0 && "Failed to convert int");
+	assert(splash_hashmap_get_int(hashmap, "string") == 42 && "Failed to parse string");
+	assert(splash_hashmap_get_int64(hashmap, "pointer") == 7 && "Failed to parse pointer");
+	assert(splash_hashmap_get(hashmap, "int") == (void *)-1 && "Got a pointer from an int");
+	assert(strcmp(splash_hashmap_get_string(hashmap, "string"), "42") == 0 && "Failed to get typed string");
+
+	assert(splash_hashmap_get_type(hashmap, "int") == SPLASH_HASHMAP_INT64 && "Wrong int type");
+	assert(splash_hashmap_get_type(hashmap, "double") == SPLASH_HASHMAP_DOUBLE && "Wrong double type");
+	assert(splash_hashmap_get_type(hashmap, "string") == SPLASH_HASHMAP_STRING && "Wrong string type");
+	assert(splash_hashmap_get_type(hashmap, "pointer") == SPLASH_HASHMAP_POINTER && "Wrong pointer type");
+	assert(splash_hashmap_get_type(hashmap, "missing") == SPLASH_HASHMAP_NONE && "Found missing key");
+	assert(splash_hashmap_get_int64(hashmap, "missing") == -1 && "Got missing int64");
+
+	splash_hashmap_set_double(hashmap, "int", 0.5);
+	assert(splash_hashmap_get_type(hashmap, "int") == SPLASH_HASHMAP_DOUBLE && "Type not replaced");
+	assert(splash_hashmap_get_double(hashmap, "int") == 0.5 && "Value not replaced");
+	splash_hashmap_add(hashmap, "int", "9");
+	assert(splash_hashmap_get_type(hashmap, "int") == SPLASH_HASHMAP_POINTER && "Type not replaced by add");
+	assert(splash_hashmap_get_int(hashmap, "int") == 9 && "Pointer not replaced");
+
+	splash_hashmap_remove(hashmap, "double");
+	assert(splash_hashmap_get_type(hashmap, "double") == SPLASH_HASHMAP_NONE && "Failed to remove typed value");
+	splash_hashmap_destory(hashmap);
+}
+
+
 
 int main(int argc, char *argv[]) {
 	hashmap_create();
@@ -112,6 +274,10 @@ int main(int argc, char *argv[]) {
 		hashmap_test_numbers();
 		hashmap_test_objects();
 		hashmap_test_size();
+		hashmap_test_many();
+		hashmap_test_keys();
+		hashmap_test_incremental();
+		hashmap_test_typed();
 
  return 0;
 }
\ No newline at end of file
@@ -162,6 +162,54 @@ static void size_test() {
 }
 
 
+static void pool_test() {
+	Splash_pool *pool = splash_pool_create(sizeof(struct _splash_list_node_), 16);
+	Splash_list *pooled = splash_list_create_pool(pool);
+	int i;
+
+	assert(pooled != NULL && "Failed to create list with pool");
+	for (i = 1; i <= 40; i++) {
+		splash_list_add(pooled, (void *)(intptr_t)i);
+	}
+	assert(splash_pool_get_used(pool) == 41 && "Nodes not taken from the pool");
+	assert(splash_list_get_int(pooled, 39) == 40 && "Failed to get pooled int");
+
+	splash_list_remove_position(pooled, 0);
+	splash_list_remove(pooled, (void *)(intptr_t)40);
+	assert(splash_pool_get_used(pool) == 39 && "Nodes not given back to the pool");
+
+	splash_list_remove_all(pooled);
+	splash_list_destroy(pooled);
+	assert(splash_pool_get_used(pool) == 0 && "Nodes left in the pool");
+	splash_pool_destroy(pool);
+
+	assert(splash_list_get_shared_pool() == list->pool && "List not using the shared pool");
+}
+
+
+static void tail_test() {
+	Splash_list *tailed = splash_list_create();
+
+	splash_list_add(tailed, (void *)1);
+	splash_list_add(tailed, (void *)2);
+	splash_list_remove_position(tailed, 1);
+	splash_list_add(tailed, (void *)3);
+	assert(splash_list_get(tailed, 1) == (void *)3 && "Tail not moved back on remove");
+
+	splash_list_remove(tailed, (void *)3);
+	splash_list_add(tailed, (void *)4);
+	assert(splash_list_get(tailed, 1) == (void *)4 && "Tail not moved back on remove");
+
+	splash_list_remove_all(tailed);
+	assert(splash_list_get_size(tailed) == 0 && "Failed to remove all");
+	splash_list_add(tailed, (void *)5);
+	assert(splash_list_get(tailed, 0) == (void *)5 && splash_list_get_size(tailed) == 1 && "Tail not reset on remove all");
+
+	splash_list_remove_all(tailed);
+	splash_list_destroy(tailed);
+}
+
+
 int main(int argc, char *argv[]) {
 	list_create_test();
 
@@ -178,6 +226,8 @@ int main(int argc, char *argv[]) {
 		list_remove_obj_test();
 
 		size_test();
+		pool_test();
+		tail_test();
 
 	splash_list_destroy(list);
  return 0;
@@ -0,0 +1,100 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaMemoryTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+
+static const char *garbage =
+	"local t = {}\n"
+	"for i = 1, 10000 do t[i] = {i, tostring(i)} end\n"
+	"t = nil\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void test_memory() {
+	Splash_lua_memory memory;
+	lua_State *l = splash_lua_newstate();
+	assert(l != NULL && "Failed to create lua state!");
+	luaL_openlibs(l);
+
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.in_use > 0 && memory.pooled > 0 && "Lua did not allocate from the pool!");
+
+	splash_lua_end_frame(l, 0);
+	assert(luaL_dostring(l, garbage) == 0 && "Failed to run script!");
+	splash_lua_end_frame(l, 0);
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.allocations >= 20000 && memory.allocated > 0 && "Frame allocations not counted!");
+	assert(memory.peak >= memory.in_use && "Peak below memory in use!");
+
+	splash_lua_end_frame(l, 0);
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.allocations == 0 && "Frame statistics not reset!");
+
+	splash_lua_close(l);
+}
+
+static void test_gc_budget() {
+	Splash_lua_memory memory;
+	lua_State *l = splash_lua_newstate();
+	luaL_openlibs(l);
+
+	assert(splash_lua_set_gc_budget(l, 2) == 0 && "Failed to set the budget!");
+	assert(luaL_dostring(l, garbage) == 0 && "Failed to run script!");
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	size_t before = memory.in_use;
+
+	/* no leftover still steps once a frame */
+	splash_lua_end_frame(l, 0);
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.gc_steps == 1 && "Collector did not step!");
+
+	int i;
+	for (i = 0; i < 10000; i++) {
+		splash_lua_end_frame(l, 1);
+	}
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.in_use < before && "Garbage was not collected!");
+
+	/* a long load without frames still collects */
+	assert(luaL_dostring(l, garbage) == 0 && "Failed to run script!");
+	splash_lua_end_frame(l, 0);
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	before = memory.in_use;
+	size_t run = memory.allocated;
+	for (i = 0; i < 50; i++) {
+		assert(luaL_dostring(l, garbage) == 0 && "Failed to run script!");
+	}
+	assert(splash_lua_get_memory(l, &memory) == 0 && "Failed to get memory statistics!");
+	assert(memory.in_use < before + 10 * run && "Heap grew without the collector!");
+
+	assert(splash_lua_set_gc_budget(l, 0) == 0 && "Failed to restart the collector!");
+	splash_lua_close(l);
+
+	/* states on the default allocator have no pool */
+	l = luaL_newstate();
+	assert(splash_lua_get_memory(l, &memory) == -1 && "Got statistics without a pool!");
+	assert(splash_lua_set_gc_budget(l, 2) == -1 && "Set a budget without a pool!");
+	splash_lua_close(l);
+}
+
+
+int main(int argc, char *argv[]) {
+
+	test_memory();
+	test_gc_budget();
+
+	return 0;
+}
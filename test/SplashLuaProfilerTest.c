@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaProfilerTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char *output_path = "profiler_test.folded";
+
+static const char *script =
+	"function busy()\n"
+	"  local sum = 0\n"
+	"  for i = 1, 100000 do sum = sum + i % 7 end\n"
+	"  return sum\n"
+	"end\n"
+	"busy()\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void test_sampling() {
+	assert(splash_lua_profiler_start(splash_lua_state, 100) == 0 && "Failed to start profiler!");
+	assert(splash_lua_profiler_running() && "Profiler not running!");
+
+	Splash_profiler_phase phase = splash_lua_profiler_phase(SPLASH_PROFILER_UPDATE);
+	assert(phase == SPLASH_PROFILER_OTHER && "Started outside the other phase!");
+	assert(luaL_dostring(splash_lua_state, script) == 0 && "Failed to run script!");
+	splash_lua_profiler_phase(phase);
+
+	splash_lua_profiler_stop();
+	assert(!splash_lua_profiler_running() && "Profiler still running!");
+
+	uint32_t samples = splash_lua_profiler_get_samples();
+	assert(samples > 0 && "No samples taken!");
+	assert(luaL_dostring(splash_lua_state, script) == 0 && "Failed to run script!");
+	assert(splash_lua_profiler_get_samples() == samples && "Sampled after stopping!");
+
+	assert(splash_lua_profiler_write(output_path) == 0 && "Failed to write samples!");
+	FILE *file = fopen(output_path, "r");
+	assert(file != NULL && "Failed to open samples!");
+
+	char line[4096];
+	uint32_t counted = 0;
+	int8_t found = 0;
+	while (fgets(line, sizeof(line), file)) {
+		char *count = strrchr(line, ' ');
+		assert(count != NULL && "Line without a count!");
+		counted += strtoul(count + 1, NULL, 10);
+		if (strncmp(line, "update;", 7) == 0 && strstr(line, "busy") != NULL) {
+			found = 1;
+		}
+	}
+	fclose(file);
+	remove(output_path);
+
+	assert(counted == samples && "Written counts differ from the samples!");
+	assert(found && "Busy function not sampled under update!");
+
+	splash_lua_profiler_clear();
+	assert(splash_lua_profiler_get_samples() == 0 && "Samples not cleared!");
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_sampling();
+		assert(splash_lua_dofile(splash_lua_state, "../scripts/test/profiler_test.lua") == 0 && "Profiler script failed!");
+
+	splash_quit();
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaReloadTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char *script_path = "reload_test_script.lua";
+
+static const char *script =
+	"local M = {count = 0, version = %d}\n"
+	"function M.get() return %d end\n"
+	"local function noop() end\n"
+	"local function update() reload_version = %d end\n"
+	"splash_state.add(splash_state.create('reload_test', noop, update, noop, noop, noop))\n"
+	"if not splash_reload.isReloading() then reload_module = M end\n"
+	"return M\n";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void write_script(int version) {
+	FILE *file = fopen(script_path, "w");
+	assert(file != NULL && "Failed to write script!");
+	if (version < 0) {
+		fprintf(file, "return {\n");
+	} else {
+		fprintf(file, script, version, version, version);
+	}
+	fclose(file);
+}
+
+
+static int get_number(const char *code) {
+	assert(luaL_dostring(splash_lua_state, code) == 0 && "Failed to run code!");
+	int value = lua_tointeger(splash_lua_state, -1);
+	lua_pop(splash_lua_state, 1);
+	return value;
+}
+
+
+static void call_update(Splash_state *state) {
+	lua_rawgeti(splash_lua_state, LUA_REGISTRYINDEX, state->l_update);
+	lua_pushnumber(splash_lua_state, 1);
+	assert(lua_pcall(splash_lua_state, 1, 0, 0) == 0 && "Failed to call update!");
+}
+
+
+static void test_reload() {
+	write_script(1);
+	assert(splash_lua_watch(splash_lua_state, script_path) == 0 && "Failed to watch script!");
+	assert(!splash_lua_reloading() && "Reloading after watch!");
+
+	Splash_state_handle handle = splash_state_get_handle("reload_test");
+	Splash_state *state = splash_state_get_state("reload_test");
+	assert(handle != SPLASH_STATE_INVALID_HANDLE && "State not added!");
+	call_update(state);
+	assert(get_number("return reload_version") == 1 && "Wrong update called!");
+	assert(get_number("return reload_module.get()") == 1 && "Wrong function!");
+
+	assert(luaL_dostring(splash_lua_state, "reload_module.count = 5") == 0 && "Failed to set count!");
+
+	write_script(2);
+	assert(splash_lua_reload(splash_lua_state, script_path) == 0 && "Failed to reload script!");
+	assert(!splash_lua_reloading() && "Still reloading!");
+
+	assert(splash_state_get_handle("reload_test") == handle && "State handle changed!");
+	assert(splash_state_get_state("reload_test") == state && "State replaced!");
+	call_update(state);
+	assert(get_number("return reload_version") == 2 && "Update not rebound!");
+	assert(get_number("return reload_module.get()") == 2 && "Function not rebound!");
+	assert(get_number("return reload_module.count") == 5 && "Data not kept!");
+	assert(get_number("return reload_module.version") == 1 && "Data replaced!");
+
+	write_script(-1);
+	assert(splash_lua_reload(splash_lua_state, script_path) == -1 && "Broken script reloaded!");
+	call_update(state);
+	assert(get_number("return reload_version") == 2 && "Old update lost!");
+	assert(get_number("return reload_module.get()") == 2 && "Old function lost!");
+
+	splash_lua_unwatch_all();
+	remove(script_path);
+}
+
+
+static void test_dofile() {
+	write_script(1);
+	splash_lua_set_hot_reload(1);
+	assert(splash_lua_get_hot_reload() && "Hot reload not on!");
+	assert(splash_lua_dofile(splash_lua_state, script_path) == 0 && "Failed to run script!");
+	splash_lua_set_hot_reload(0);
+
+	assert(splash_lua_reload_changed(splash_lua_state) == 0 && "Unchanged script reloaded!");
+
+	splash_lua_unwatch_all();
+	remove(script_path);
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_reload();
+		test_dofile();
+		assert(splash_lua_dofile(splash_lua_state, "../scripts/test/reload_test.lua") == 0 && "Reload script failed!");
+
+	splash_quit();
+  return 0;
+}
@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashLuaWorkerTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <string.h>
+
+#define WORKERS 4
+#define JOBS 64
+
+static char *job_path = "../scripts/test/worker_job.lua";
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void test_worker() {
+	lua_State *l = splash_lua_state;
+	Splash_lua_worker *worker = splash_lua_worker_create(job_path);
+	assert(worker != NULL && "Failed to create worker!");
+
+	lua_pushstring(l, "echo");
+	lua_pushstring(l, "hello");
+	assert(splash_lua_worker_post(worker, l, 2) == 0 && "Failed to post job!");
+	assert(lua_gettop(l) == 0 && "Job arguments not popped!");
+	assert(splash_lua_worker_pending(worker) == 1 && "Job not pending!");
+
+	assert(splash_lua_worker_result(worker, l, 1) == 2 && "Wrong result count!");
+	assert(lua_toboolean(l, -2) && strcmp(lua_tostring(l, -1), "hello") == 0 && "Wrong result!");
+	lua_pop(l, 2);
+	assert(splash_lua_worker_pending(worker) == 0 && "Job still pending!");
+	assert(splash_lua_worker_result(worker, l, 1) == -1 && "Waited with nothing pending!");
+
+	lua_pushstring(l, "echo");
+	lua_pushcfunction(l, splash_lua_traceback);
+	assert(splash_lua_worker_post(worker, l, 2) == -1 && "Posted a function!");
+	assert(lua_gettop(l) == 1 && lua_isstring(l, -1) && "No error message!");
+	lua_pop(l, 1);
+
+	splash_lua_worker_destroy(worker);
+	assert(splash_lua_worker_create("../scripts/test/missing.lua") == NULL && "Created worker without a script!");
+}
+
+static void test_parallel() {
+	lua_State *l = splash_lua_state;
+	Splash_lua_worker *workers[WORKERS];
+	int i;
+
+	for (i = 0; i < WORKERS; i++) {
+		workers[i] = splash_lua_worker_create(job_path);
+		assert(workers[i] != NULL && "Failed to create worker!");
+	}
+
+	for (i = 0; i < JOBS; i++) {
+		lua_pushstring(l, "sum");
+		lua_pushinteger(l, i);
+		assert(splash_lua_worker_post(workers[i % WORKERS], l, 2) == 0 && "Failed to post job!");
+	}
+
+	/* results come back in post order per worker */
+	for (i = 0; i < JOBS; i++) {
+		assert(splash_lua_worker_result(workers[i % WORKERS], l, 1) == 2 && "Wrong result count!");
+		assert(lua_toboolean(l, -2) && lua_tointeger(l, -1) == i * (i + 1) / 2 && "Wrong sum!");
+		lua_pop(l, 2);
+	}
+
+	for (i = 0; i < WORKERS; i++) {
+		splash_lua_worker_destroy(workers[i]);
+	}
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_worker();
+		test_parallel();
+		assert(splash_lua_dofile(splash_lua_state, "../scripts/test/worker_test.lua") == 0 && "Worker script failed!");
+
+	splash_quit();
+  return 0;
+}
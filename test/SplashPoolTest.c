@@ -0,0 +1,192 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashPoolTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define THREAD_BLOCKS 10000
+
+static SDL_atomic_t step;
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void pool_test_reuse() {
+	Splash_pool *pool = splash_pool_create(24, 4);
+	assert(pool != NULL && "Failed to create pool");
+	assert(splash_pool_create(0, 4) == NULL && "Created pool of empty blocks");
+
+	char *a = splash_pool_alloc(pool);
+	char *b = splash_pool_alloc(pool);
+	assert(a != NULL && b != NULL && a != b && "Failed to alloc");
+	assert(((uintptr_t)a & 7) == 0 && "Block not aligned");
+	memset(a, 1, 24);
+	memset(b, 2, 24);
+	assert(splash_pool_get_used(pool) == 2 && "Wrong used count");
+	assert(splash_pool_get_capacity(pool) == 4 && "Wrong capacity");
+
+	splash_pool_free(pool, a);
+	assert(splash_pool_alloc(pool) == a && "Freed block not reused");
+
+	int i;
+	for (i = 0; i < 10; i++) {
+		assert(splash_pool_alloc(pool) != NULL && "Failed to add a page");
+	}
+	assert(splash_pool_get_used(pool) == 12 && "Wrong used count");
+	assert(splash_pool_get_capacity(pool) == 12 && "Wrong capacity");
+
+	splash_pool_free_all(pool);
+	assert(splash_pool_get_used(pool) == 0 && "Blocks left after free all");
+	for (i = 0; i < 12; i++) {
+		splash_pool_alloc(pool);
+	}
+	assert(splash_pool_get_capacity(pool) == 12 && "Pages not reused after free all");
+	splash_pool_destroy(pool);
+}
+
+
+static void pool_test_cache() {
+	Splash_pool *pool = splash_pool_create_shared(16, 0);
+	void *blocks[SPLASH_POOL_CACHE * 3];
+	int i;
+
+	splash_pool_set_thread_cache(pool, 1);
+	for (i = 0; i < SPLASH_POOL_CACHE * 3; i++) {
+		blocks[i] = splash_pool_alloc(pool);
+		assert(blocks[i] != NULL && "Failed to alloc from cache");
+	}
+	for (i = 0; i < SPLASH_POOL_CACHE * 3; i++) {
+		splash_pool_free(pool, blocks[i]);
+	}
+	assert(splash_pool_get_used(pool) <= SPLASH_POOL_CACHE && "Cache kept too many blocks");
+
+	splash_pool_flush_thread_cache();
+	assert(splash_pool_get_used(pool) == 0 && "Cache not flushed");
+	splash_pool_destroy(pool);
+}
+
+
+static int pool_thread(void *data) {
+	Splash_pool *pool = data;
+	void *blocks[64];
+	int i;
+
+	for (i = 0; i < THREAD_BLOCKS; i++) {
+		int slot = i % 64;
+		if (i >= 64) {
+			assert(*(int *)blocks[slot] == i - 64 && "Block shared between threads");
+			splash_pool_free(pool, blocks[slot]);
+		}
+		blocks[slot] = splash_pool_alloc(pool);
+		*(int *)blocks[slot] = i;
+	}
+	for (i = 0; i < 64; i++) {
+		splash_pool_free(pool, blocks[i]);
+	}
+	splash_pool_flush_thread_cache();
+ return 0;
+}
+
+
+static void pool_test_threads() {
+	Splash_pool *pool = splash_pool_create_shared(16, 0);
+	SDL_Thread *threads[4];
+	int i;
+
+	splash_pool_set_thread_cache(pool, 1);
+	for (i = 0; i < 4; i++) {
+		threads[i] = SDL_CreateThread(pool_thread, "pool", pool);
+	}
+	for (i = 0; i < 4; i++) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+	assert(splash_pool_get_used(pool) == 0 && "Blocks lost between threads");
+	splash_pool_destroy(pool);
+}
+
+
+static void wait_step(int value) {
+	while (SDL_AtomicGet(&step) != value) {
+		SDL_Delay(1);
+	}
+}
+
+
+static int pool_stale_thread(void *data) {
+	Splash_pool *pool = data;
+	void *blocks[SPLASH_POOL_CACHE];
+	int i;
+
+	/* fill the cache then wait for the other thread to empty the pool */
+	splash_pool_free(pool, splash_pool_alloc(pool));
+	SDL_AtomicSet(&step, 1);
+	wait_step(2);
+
+	for (i = 0; i < SPLASH_POOL_CACHE; i++) {
+		blocks[i] = splash_pool_alloc(pool);
+		*(int *)blocks[i] = 1;
+	}
+	for (i = 0; i < SPLASH_POOL_CACHE; i++) {
+		splash_pool_free(pool, blocks[i]);
+	}
+
+	/* keep the cache while the other thread destroys the pool */
+	SDL_AtomicSet(&step, 3);
+	wait_step(4);
+	splash_pool_flush_thread_cache();
+ return 0;
+}
+
+
+static void pool_test_stale_cache() {
+	Splash_pool *pool = splash_pool_create_shared(16, 0);
+	void *blocks[SPLASH_POOL_CACHE];
+	int i;
+
+	SDL_AtomicSet(&step, 0);
+	splash_pool_set_thread_cache(pool, 1);
+	SDL_Thread *thread = SDL_CreateThread(pool_stale_thread, "pool", pool);
+	wait_step(1);
+
+	splash_pool_free_all(pool);
+	for (i = 0; i < SPLASH_POOL_CACHE; i++) {
+		blocks[i] = splash_pool_alloc(pool);
+		*(int *)blocks[i] = 2;
+	}
+	SDL_AtomicSet(&step, 2);
+	wait_step(3);
+
+	for (i = 0; i < SPLASH_POOL_CACHE; i++) {
+		assert(*(int *)blocks[i] == 2 && "Stale cache handed out a block twice");
+		splash_pool_free(pool, blocks[i]);
+	}
+	splash_pool_flush_thread_cache();
+	assert(splash_pool_get_used(pool) <= SPLASH_POOL_CACHE && "Blocks lost after free all");
+
+	splash_pool_destroy(pool);
+	SDL_AtomicSet(&step, 4);
+	SDL_WaitThread(thread, NULL);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	pool_test_reuse();
+	pool_test_cache();
+	pool_test_threads();
+	pool_test_stale_cache();
+ return 0;
+}
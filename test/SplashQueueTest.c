@@ -0,0 +1,234 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashQueueTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+#define STRESS_ITEMS 200000
+#define STRESS_THREADS 4
+
+typedef struct stress_thread {
+	Splash_ring *ring;
+	Splash_queue *queue;
+	int32_t first;
+	int32_t count;
+	int64_t sum;
+	int8_t batch;
+} stress_thread;
+
+
+static void queue_test_ring() {
+	Splash_ring *ring = splash_ring_create(5);
+	void *items[8];
+	void *item;
+	int i;
+
+	assert(ring != NULL && "Failed to create ring");
+	assert(splash_ring_create(0) == NULL && "Created an empty ring");
+	assert(splash_ring_get_capacity(ring) == 8 && "Capacity not rounded to a power of two");
+	assert(splash_ring_pop(ring, &item) == -1 && "Popped from an empty ring");
+
+	for (i = 0; i < 8; i++) {
+		assert(splash_ring_push(ring, (void *)(intptr_t)i) == 0 && "Failed to push");
+	}
+	assert(splash_ring_push(ring, (void *)8) == -1 && "Pushed to a full ring");
+	assert(splash_ring_get_size(ring) == 8 && "Wrong size");
+
+	for (i = 0; i < 3; i++) {
+		assert(splash_ring_pop(ring, &item) == 0 && item == (void *)(intptr_t)i && "Popped out of order");
+	}
+
+	for (i = 0; i < 8; i++) {
+		items[i] = (void *)(intptr_t)(i + 8);
+	}
+	assert(splash_ring_push_batch(ring, items, 8) == 3 && "Batch pushed more than fit");
+	assert(splash_ring_pop_batch(ring, items, 8) == 8 && "Failed to batch pop");
+	for (i = 0; i < 8; i++) {
+		assert(items[i] == (void *)(intptr_t)(i + 3) && "Batch popped out of order");
+	}
+	assert(splash_ring_pop_batch(ring, items, 8) == 0 && "Batch popped from an empty ring");
+	assert(splash_ring_pop_wait(ring, &item, 10) == -1 && "Wait did not time out");
+	splash_ring_destroy(ring);
+}
+
+
+static void queue_test_queue() {
+	Splash_queue *queue = splash_queue_create(16);
+	void *items[32];
+	void *item;
+	int i;
+
+	assert(queue != NULL && "Failed to create queue");
+	assert(splash_queue_pop(queue, &item) == -1 && "Popped from an empty queue");
+
+	for (i = 0; i < 32; i++) {
+		items[i] = (void *)(intptr_t)i;
+	}
+	assert(splash_queue_push_batch(queue, items, 32) == 16 && "Batch pushed more than fit");
+	assert(splash_queue_push(queue, (void *)1) == -1 && "Pushed to a full queue");
+	assert(splash_queue_push_wait(queue, (void *)1, 10) == -1 && "Wait did not time out");
+	assert(splash_queue_get_size(queue) == 16 && "Wrong size");
+
+	assert(splash_queue_pop(queue, &item) == 0 && item == (void *)0 && "Failed to pop");
+	assert(splash_queue_pop_batch(queue, items, 10) == 10 && "Failed to batch pop");
+	assert(items[0] == (void *)1 && items[9] == (void *)10 && "Batch popped out of order");
+
+	for (i = 0; i < 100; i++) {
+		assert(splash_queue_push(queue, (void *)(intptr_t)i) == 0 && "Failed to push after wrapping");
+		assert(splash_queue_pop(queue, &item) == 0 && "Failed to pop after wrapping");
+	}
+	assert(splash_queue_get_size(queue) == 5 && "Wrong size after wrapping");
+	splash_queue_destroy(queue);
+}
+
+
+static int ring_producer(void *data) {
+	stress_thread *thread = data;
+	void *items[16];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		if (thread->batch) {
+			int32_t count = thread->count - i < 16 ? thread->count - i : 16;
+			for (j = 0; j < count; j++) {
+				items[j] = (void *)(intptr_t)(i + j + 1);
+			}
+			int32_t pushed = splash_ring_push_batch(thread->ring, items, count);
+			if (pushed == 0) {
+				pushed = splash_ring_push_wait(thread->ring, items[0], SPLASH_QUEUE_WAIT_FOREVER) == 0;
+			}
+			i += pushed;
+		} else {
+			splash_ring_push_wait(thread->ring, (void *)(intptr_t)(i + 1), SPLASH_QUEUE_WAIT_FOREVER);
+			i++;
+		}
+	}
+	return 0;
+}
+
+
+static void queue_test_ring_stress(int8_t batch) {
+	stress_thread producer = {splash_ring_create(64), NULL, 0, STRESS_ITEMS, 0, batch};
+	SDL_Thread *thread = SDL_CreateThread(ring_producer, "producer", &producer);
+	void *item;
+	int32_t i;
+
+	for (i = 1; i <= STRESS_ITEMS; i++) {
+		assert(splash_ring_pop_wait(producer.ring, &item, SPLASH_QUEUE_WAIT_FOREVER) == 0 && "Wait failed");
+		assert(item == (void *)(intptr_t)i && "Ring lost the order");
+	}
+	SDL_WaitThread(thread, NULL);
+	assert(splash_ring_get_size(producer.ring) == 0 && "Ring not empty");
+	splash_ring_destroy(producer.ring);
+}
+
+
+static int queue_producer(void *data) {
+	stress_thread *thread = data;
+	void *items[8];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		if (thread->batch) {
+			int32_t count = thread->count - i < 8 ? thread->count - i : 8;
+			for (j = 0; j < count; j++) {
+				items[j] = (void *)(intptr_t)(thread->first + i + j);
+			}
+			int32_t pushed = splash_queue_push_batch(thread->queue, items, count);
+			if (pushed == 0) {
+				pushed = splash_queue_push_wait(thread->queue, items[0], SPLASH_QUEUE_WAIT_FOREVER) == 0;
+			}
+			i += pushed;
+		} else {
+			splash_queue_push_wait(thread->queue, (void *)(intptr_t)(thread->first + i), SPLASH_QUEUE_WAIT_FOREVER);
+			i++;
+		}
+	}
+	return 0;
+}
+
+
+static int queue_consumer(void *data) {
+	stress_thread *thread = data;
+	void *items[8];
+	int32_t i = 0;
+	int32_t j;
+
+	while (i < thread->count) {
+		if (thread->batch) {
+			int32_t count = splash_queue_pop_batch(thread->queue, items, thread->count - i < 8 ? thread->count - i : 8);
+			if (count == 0) {
+				count = splash_queue_pop_wait(thread->queue, items, SPLASH_QUEUE_WAIT_FOREVER) == 0;
+			}
+			for (j = 0; j < count; j++) {
+				thread->sum += (intptr_t)items[j];
+			}
+			i += count;
+		} else {
+			splash_queue_pop_wait(thread->queue, items, SPLASH_QUEUE_WAIT_FOREVER);
+			thread->sum += (intptr_t)items[0];
+			i++;
+		}
+	}
+	return 0;
+}
+
+
+static void queue_test_queue_stress(int8_t batch) {
+	Splash_queue *queue = splash_queue_create(128);
+	stress_thread producers[STRESS_THREADS];
+	stress_thread consumers[STRESS_THREADS];
+	SDL_Thread *threads[STRESS_THREADS * 2];
+	int32_t per_thread = STRESS_ITEMS / STRESS_THREADS;
+	int64_t total = (int64_t)per_thread * STRESS_THREADS;
+	int64_t sum = 0;
+	int i;
+
+	for (i = 0; i < STRESS_THREADS; i++) {
+		stress_thread producer = {NULL, queue, i * per_thread + 1, per_thread, 0, batch};
+		stress_thread consumer = {NULL, queue, 0, per_thread, 0, batch};
+		producers[i] = producer;
+		consumers[i] = consumer;
+		threads[i] = SDL_CreateThread(queue_producer, "producer", &producers[i]);
+		threads[i + STRESS_THREADS] = SDL_CreateThread(queue_consumer, "consumer", &consumers[i]);
+	}
+
+	for (i = 0; i < STRESS_THREADS * 2; i++) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+	for (i = 0; i < STRESS_THREADS; i++) {
+		sum += consumers[i].sum;
+	}
+	assert(sum == total * (total + 1) / 2 && "Queue lost or repeated items");
+	assert(splash_queue_get_size(queue) == 0 && "Queue not empty");
+	splash_queue_destroy(queue);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	queue_test_ring();
+	queue_test_queue();
+	queue_test_ring_stress(0);
+	queue_test_ring_stress(1);
+	queue_test_queue_stress(0);
+	queue_test_queue_stress(1);
+ return 0;
+}
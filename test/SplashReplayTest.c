@@ -0,0 +1,152 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashReplayTest.c
+   @author  P. Batty
+   @brief   Unit test
+	
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"                          
+#include <assert.h>
+#include <string.h>
+
+static char *log_path = "replay_test.log";
+
+static int updates;
+static int events;
+static float delta_sum;
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void count_init(char *new_state, void *data) {}
+static void count_update(float delta) {
+	updates++;
+	delta_sum += delta;
+	if (updates == 5) {
+		splash_state_stop();
+	}
+}
+static void count_events(SDL_Event e) {events++;}
+static void count_render() {}
+static void count_cleanup(char *new_state) {}
+
+
+static void test_log() {
+	Splash_replay *replay = splash_replay_record(log_path, 30);
+	assert(replay != NULL && "Failed to create log");
+
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_KEYDOWN;
+	event.key.keysym.sym = 'a';
+
+	splash_replay_write_update(replay, 1.25);
+	splash_replay_write_event(replay, &event);
+	splash_replay_write_frame(replay, 17);
+	splash_replay_write_frame(replay, 300);
+	splash_replay_close(replay);
+
+	replay = splash_replay_open(log_path);
+	assert(replay != NULL && "Failed to open log");
+	assert(replay->ticks == 30 && "Failed to read ticks");
+
+	Splash_replay_record record;
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_UPDATE && "Failed to read update");
+	assert(record.delta == 1.25 && "Failed to read delta");
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_EVENT && "Failed to read event");
+	assert(record.event.type == SDL_KEYDOWN && record.event.key.keysym.sym == 'a' && "Failed to read event");
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_FRAME && record.elapsed == 17 && "Failed to read frame");
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_FRAME && record.elapsed == 300 && "Failed to read frame");
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_END && "Failed to read end");
+	assert(replay->frames == 2 && "Failed to count frames");
+	splash_replay_close(replay);
+
+	assert(splash_replay_open("missing_replay_test.log") == NULL && "Opened missing log");
+}
+
+
+static void test_log_drop() {
+	Splash_replay *replay = splash_replay_record(log_path, 30);
+	char file[] = "dropped.png";
+
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_DROPFILE;
+	event.drop.file = file;
+	splash_replay_write_event(replay, &event);
+
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_USEREVENT;
+	event.user.code = 7;
+	event.user.data1 = file;
+	splash_replay_write_event(replay, &event);
+
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_SYSWMEVENT;
+	splash_replay_write_event(replay, &event);
+	assert(replay->skipped == 1 && "Failed to skip window manager event");
+	splash_replay_close(replay);
+
+	replay = splash_replay_open(log_path);
+	Splash_replay_record record;
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_EVENT && "Failed to read drop event");
+	assert(record.event.type == SDL_DROPFILE && "Failed to read drop event");
+	assert(record.event.drop.file != file && strcmp(record.event.drop.file, "dropped.png") == 0 && "Failed to read drop path");
+	SDL_free(record.event.drop.file);
+
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_EVENT && "Failed to read user event");
+	assert(record.event.user.code == 7 && record.event.user.data1 == NULL && "Stored user data pointer");
+	assert(splash_replay_read(replay, &record) == SPLASH_REPLAY_END && "Stored window manager event");
+	splash_replay_close(replay);
+}
+
+
+static void test_record_replay() {
+	Splash_state *state = splash_state_create("Count", count_init, count_update, count_events, count_render, count_cleanup);
+	splash_state_add(state);
+
+	assert(splash_state_record(log_path) == 0 && "Failed to start recording");
+	splash_state_start("Count", NULL);
+
+	int recorded_updates = updates;
+	int recorded_events = events;
+	float recorded_delta = delta_sum;
+
+	updates = 0;
+	events = 0;
+	delta_sum = 0;
+	assert(splash_state_replay(log_path, "Count", NULL, 0) == 0 && "Failed to replay");
+	assert(updates == recorded_updates && "Replay updates differ");
+	assert(events == recorded_events && "Replay events differ");
+	assert(delta_sum == recorded_delta && "Replay deltas differ");
+
+	updates = 0;
+	int steps = 0;
+	assert(splash_state_replay_begin(log_path, "Count", NULL) == 0 && "Failed to begin replay");
+	while (splash_state_replay_step()) {
+		steps++;
+	}
+	splash_state_replay_end();
+	assert(updates == recorded_updates && "Stepped replay updates differ");
+	assert(steps > 0 && "Failed to step replay");
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_log();
+		test_log_drop();
+		test_record_replay();
+
+	splash_quit();
+	remove(log_path);
+  return 0;
+}
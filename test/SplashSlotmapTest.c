@@ -0,0 +1,145 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashSlotmapTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void slotmap_test_insert() {
+	Splash_slotmap *slotmap = splash_slotmap_create(sizeof(int32_t));
+	Splash_handle handles[1000];
+	int32_t i;
+
+	assert(slotmap != NULL && "Failed to create slot map");
+	assert(splash_slotmap_create(0) == NULL && "Created a slot map of empty elements");
+	assert(splash_slotmap_get(slotmap, SPLASH_HANDLE_NULL) == NULL && "Got the null handle");
+
+	for (i = 0; i < 1000; i++) {
+		handles[i] = splash_slotmap_insert(slotmap, &i);
+		assert(handles[i] != SPLASH_HANDLE_NULL && "Failed to insert");
+	}
+	assert(splash_slotmap_get_size(slotmap) == 1000 && "Wrong size");
+
+	for (i = 0; i < 1000; i++) {
+		assert(*(int32_t *)splash_slotmap_get(slotmap, handles[i]) == i && "Failed to get");
+	}
+
+	int32_t *zero = splash_slotmap_get(slotmap, splash_slotmap_insert(slotmap, NULL));
+	assert(zero != NULL && *zero == 0 && "Inserted element not zeroed");
+	splash_slotmap_destroy(slotmap);
+}
+
+
+static void slotmap_test_remove() {
+	Splash_slotmap *slotmap = splash_slotmap_create(sizeof(int32_t));
+	Splash_handle handles[100];
+	int32_t i;
+
+	for (i = 0; i < 100; i++) {
+		handles[i] = splash_slotmap_insert(slotmap, &i);
+	}
+
+	for (i = 0; i < 100; i += 2) {
+		assert(splash_slotmap_remove(slotmap, handles[i]) == 1 && "Failed to remove");
+	}
+	assert(splash_slotmap_get_size(slotmap) == 50 && "Remove did not shrink");
+	assert(splash_slotmap_remove(slotmap, handles[0]) == 0 && "Removed twice");
+
+	for (i = 0; i < 100; i++) {
+		int32_t *value = splash_slotmap_get(slotmap, handles[i]);
+		if (i % 2 == 0) {
+			assert(value == NULL && "Got a removed element");
+		} else {
+			assert(value != NULL && *value == i && "Remove moved the wrong element");
+		}
+	}
+
+	int32_t value = 42;
+	Splash_handle reused = splash_slotmap_insert(slotmap, &value);
+	assert(SPLASH_HANDLE_INDEX(reused) == SPLASH_HANDLE_INDEX(handles[98]) && "Free slot not reused");
+	assert(reused != handles[98] && "Generation not bumped");
+	assert(splash_slotmap_get(slotmap, handles[98]) == NULL && "Stale handle reached the new element");
+	assert(*(int32_t *)splash_slotmap_get(slotmap, reused) == 42 && "Failed to get the new element");
+	splash_slotmap_destroy(slotmap);
+}
+
+
+static void slotmap_test_iterate() {
+	Splash_slotmap *slotmap = splash_slotmap_create(sizeof(int32_t));
+	Splash_handle handles[10];
+	int32_t i;
+	int32_t sum = 0;
+
+	for (i = 0; i < 10; i++) {
+		handles[i] = splash_slotmap_insert(slotmap, &i);
+	}
+	splash_slotmap_remove(slotmap, handles[3]);
+	splash_slotmap_remove(slotmap, handles[0]);
+
+	int32_t *data = splash_slotmap_get_data(slotmap);
+	for (i = 0; i < splash_slotmap_get_size(slotmap); i++) {
+		sum += data[i];
+		assert(splash_slotmap_get(slotmap, splash_slotmap_get_handle(slotmap, i)) == &data[i] && "Handle does not match the element");
+	}
+	assert(sum == 45 - 3 && "Elements not packed");
+	assert(splash_slotmap_get_handle(slotmap, 8) == SPLASH_HANDLE_NULL && "Got a handle past the end");
+	splash_slotmap_destroy(slotmap);
+}
+
+
+static void slotmap_test_handle() {
+	int32_t a = 0;
+	int32_t b = 0;
+	int32_t count = splash_handle_get_count();
+
+	Splash_handle handle = splash_handle_create(&a);
+	assert(handle != SPLASH_HANDLE_NULL && "Failed to create handle");
+	assert(splash_handle_create(&a) == handle && "Object given a second handle");
+	assert(splash_handle_get(handle) == &a && "Failed to get the object");
+	assert(splash_handle_find(&a) == handle && "Failed to find the handle");
+	assert(splash_handle_find(&b) == SPLASH_HANDLE_NULL && "Found a handle for a object without one");
+	assert(splash_handle_get_count() == count + 1 && "Wrong count");
+
+	splash_handle_destroy(handle);
+	assert(splash_handle_get(handle) == NULL && "Got a destroyed object");
+	assert(splash_handle_find(&a) == SPLASH_HANDLE_NULL && "Found a destroyed handle");
+
+	Splash_handle other = splash_handle_create(&b);
+	assert(other != handle && splash_handle_get(handle) == NULL && "Stale handle reached a new object");
+	splash_handle_destroy(other);
+	assert(splash_handle_get_count() == count && "Handles not dropped");
+
+	handle = splash_handle_create(&a);
+	splash_handle_quit();
+	assert(splash_handle_get_count() == 0 && splash_handle_get(handle) == NULL && "Handles kept after quit");
+	other = splash_handle_create(&b);
+	assert(splash_handle_get(other) == &b && "Failed to make handles after quit");
+	assert(other != handle && splash_handle_get(handle) == NULL && "Handle from before quit reached a new object");
+	splash_handle_destroy(handle);
+	assert(splash_handle_get(other) == &b && "Handle from before quit destroyed a new object");
+	splash_handle_destroy(other);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	slotmap_test_insert();
+	slotmap_test_remove();
+	slotmap_test_iterate();
+	slotmap_test_handle();
+ return 0;
+}
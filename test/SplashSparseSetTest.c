@@ -0,0 +1,80 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashSparseSetTest.c
+   @author  P. Batty
+   @brief   Unit test
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"
+#include <assert.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void sparse_set_test_insert() {
+	Splash_sparse_set *set = splash_sparse_set_create();
+	uint32_t i;
+
+	assert(set != NULL && "Failed to create sparse set");
+	assert(splash_sparse_set_contains(set, 0) == 0 && "Empty set contains an id");
+
+	for (i = 0; i < 50000; i += 5) {
+		assert(splash_sparse_set_insert(set, i) == 1 && "Failed to insert");
+	}
+	assert(splash_sparse_set_insert(set, 10) == 0 && "Inserted twice");
+	assert(splash_sparse_set_get_size(set) == 10000 && "Wrong size");
+
+	for (i = 0; i < 50000; i++) {
+		assert(splash_sparse_set_contains(set, i) == (i % 5 == 0) && "Wrong membership");
+	}
+	assert(splash_sparse_set_contains(set, 1000000) == 0 && "Contains an id past the end");
+	assert(splash_sparse_set_get_position(set, 25) == 5 && "Wrong position");
+	assert(splash_sparse_set_get_position(set, 26) == -1 && "Found a missing id");
+	splash_sparse_set_destroy(set);
+}
+
+
+static void sparse_set_test_remove() {
+	Splash_sparse_set *set = splash_sparse_set_create();
+	uint32_t i;
+	uint64_t sum = 0;
+
+	for (i = 0; i < 100; i++) {
+		splash_sparse_set_insert(set, i);
+	}
+	for (i = 0; i < 100; i += 2) {
+		assert(splash_sparse_set_remove(set, i) == 1 && "Failed to remove");
+	}
+	assert(splash_sparse_set_remove(set, 0) == 0 && "Removed twice");
+	assert(splash_sparse_set_get_size(set) == 50 && "Remove did not shrink");
+
+	uint32_t *data = splash_sparse_set_get_data(set);
+	for (i = 0; i < (uint32_t)splash_sparse_set_get_size(set); i++) {
+		assert(data[i] % 2 == 1 && "Removed id still packed");
+		assert(splash_sparse_set_get_position(set, data[i]) == (int32_t)i && "Position does not match");
+		sum += data[i];
+	}
+	assert(sum == 2500 && "Members lost");
+
+	assert(splash_sparse_set_insert(set, 4) == 1 && splash_sparse_set_contains(set, 4) && "Failed to insert a removed id");
+	splash_sparse_set_remove_all(set);
+	assert(splash_sparse_set_get_size(set) == 0 && "Failed to remove all");
+	assert(splash_sparse_set_contains(set, 1) == 0 && "Contains after removing all");
+	splash_sparse_set_destroy(set);
+}
+
+
+
+int main(int argc, char *argv[]) {
+	sparse_set_test_insert();
+	sparse_set_test_remove();
+ return 0;
+}
@@ -13,20 +13,33 @@
 
 #include "splash/Splash.h"                          
 #include <assert.h>
+#include <string.h>
 
+static char the_name[] = "The";             /**< not the same pointer as the literal */
+static Splash_state_handle code_handle;
+
+static const char *throwing_state =
+	"throwing_updates = 0\n"
+	"local function update(delta)\n"
+	"	throwing_updates = throwing_updates + 1\n"
+	"	if throwing_updates == 1 then error(\"thrown\") end\n"
+	"	splash_state.stop()\n"
+	"end\n"
+	"local function none() end\n"
+	"splash_state.add(splash_state.create(\"Throwing State\", none, update, none, none, none))\n";
 
 /*---------------------------------------------------------------------------
                             Function codes
  ---------------------------------------------------------------------------*/
 
 static void test_init(char *new_state, void *data) {}
-static void test_update(float delta) {splash_state_switch("The", NULL);}
+static void test_update(float delta) {splash_state_switch(the_name, NULL);}
 static void test_events(SDL_Event e) {}
 static void test_render() {}
 static void test_cleanup(char *new_state) {}
 
 static void the_init(char *new_state, void *data) {}
-static void the_update(float delta) {splash_state_switch("Code", NULL);}
+static void the_update(float delta) {splash_state_switch_handle(code_handle, NULL);}
 static void the_events(SDL_Event e) {}
 static void the_render() {}
 static void the_cleanup(char *new_state) {}
@@ -46,16 +59,51 @@ static void test_state_creation() {
 	state = splash_state_create("The", the_init, the_update, the_events, the_render, the_cleanup);
 	splash_state_add(state);
 	state = splash_state_create("Code", code_init, code_update, code_events, code_render, code_cleanup);
-	splash_state_add(state);
+	code_handle = splash_state_add(state);
+	assert(code_handle != SPLASH_STATE_INVALID_HANDLE && "Failed to add state!");
 
 	splash_state_remove("Code");
-	splash_state_add(state);
+	assert(splash_state_get_state_handle(code_handle) == NULL && "Failed to remove state!");
+	assert(splash_state_add(state) == code_handle && "Failed to keep state handle!");
+
+	char code_name[] = "Code";
+	assert(splash_state_get_handle(code_name) == code_handle && "Failed to look up state by name!");
+	assert(splash_state_get_state(code_name) == state && "Failed to get state by name!");
+	assert(splash_state_get_handle("None") == SPLASH_STATE_INVALID_HANDLE && "Found missing state!");
 }
 
 static void test_state_machine() {
 	splash_state_start("Test", NULL);
 }
 
+static void test_script_cache() {
+	assert(splash_lua_set_cache("lua_cache", 0) == 0 && "Failed to set the script cache!");
+
+	/* first load fills the cache, the second loads the chunk */
+	assert(splash_lua_load(splash_lua_state, "../scripts/test/state_test.lua") == 0 && "Failed to compile script!");
+	assert(lua_isfunction(splash_lua_state, -1) && "Script did not load as a function!");
+	lua_pop(splash_lua_state, 1);
+	assert(splash_lua_load(splash_lua_state, "../scripts/test/state_test.lua") == 0 && "Failed to load cached script!");
+	assert(lua_isfunction(splash_lua_state, -1) && "Cached script did not load as a function!");
+	lua_pop(splash_lua_state, 1);
+
+	assert(splash_lua_load(splash_lua_state, "../scripts/test/missing.lua") == -1 && "Loaded a missing script!");
+	lua_pop(splash_lua_state, 1);
+}
+
+static void test_callback_error() {
+	assert(luaL_dostring(splash_lua_state, throwing_state) == 0 && "Failed to run script!");
+	int top = lua_gettop(splash_lua_state);
+
+	/* the error is printed and popped, the next update stops the machine */
+	splash_state_start("Throwing State", NULL);
+	assert(lua_gettop(splash_lua_state) == top && "Error left values on the stack!");
+
+	lua_getglobal(splash_lua_state, "throwing_updates");
+	assert(lua_tointeger(splash_lua_state, -1) == 2 && "Machine stopped on the error!");
+	lua_pop(splash_lua_state, 1);
+}
+
 int main(int argc, char *argv[]) {
 	splash_init();
 
@@ -64,9 +112,26 @@ int main(int argc, char *argv[]) {
 	
 	splash_quit();
 	splash_init();
-		if(luaL_dofile(splash_lua_state, "../scripts/test/state_test.lua")){
-			printf("Could not load file: %s\n", lua_tostring(splash_lua_state, -1));
+		SDL_Event event;
+		memset(&event, 0, sizeof(SDL_Event));
+		event.type = SDL_KEYDOWN;
+		event.key.keysym.sym = SDLK_a;
+		SDL_PushEvent(&event);
+
+		/* the pool reuses the first event after eight more */
+		int i;
+		for (i = 0; i < 9; i++) {
+			memset(&event, 0, sizeof(SDL_Event));
+			event.type = SDL_MOUSEMOTION;
+			event.motion.x = 10;
+			event.motion.y = 20;
+			SDL_PushEvent(&event);
 		}
+
+		test_script_cache();
+		assert(splash_lua_dofile(splash_lua_state, "../scripts/test/state_test.lua") == 0 && "Failed to run cached script!");
+		splash_lua_set_cache(NULL, 0);
+		test_callback_error();
 	splash_quit();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashTaskTest.c
+   @author  P. Batty
+   @brief   Unit test
+	
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"                          
+#include <assert.h>
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[]) {
+	int failed = 0;
+
+	splash_init();
+		if(luaL_dofile(splash_lua_state, "../scripts/test/task_test.lua")){
+			printf("Could not load file: %s\n", lua_tostring(splash_lua_state, -1));
+			failed = 1;
+		}
+	splash_quit();
+  return failed;
+}
@@ -0,0 +1,199 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    SplashTimerTest.c
+   @author  P. Batty
+   @brief   Unit test
+	
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include "splash/Splash.h"                          
+#include <assert.h>
+#include <stdlib.h>
+
+#define RANDOM_TIMERS 100000
+
+static int fired;
+static uint32_t fired_at;
+static int late;
+
+static Splash_timer_handle timer_a;
+static Splash_timer_handle timer_b;
+static int a_updates;
+static int b_updates;
+static int a_ticks;
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+static void count_timer(Splash_timer_handle handle, void *data) {
+	fired++;
+	fired_at = splash_timer_get_time();
+}
+
+static void check_timer(Splash_timer_handle handle, void *data) {
+	fired++;
+	if (splash_timer_get_time() != (uint32_t)(uintptr_t)data) {
+		late++;
+	}
+}
+
+static void cancel_timer(Splash_timer_handle handle, void *data) {
+	fired++;
+	splash_timer_cancel(handle);
+}
+
+static void a_tick(Splash_timer_handle handle, void *data) {a_ticks++;}
+
+static void a_init(char *new_state, void *data) {
+	timer_a = splash_timer_every(10, a_tick, NULL);
+}
+static void a_update(float delta) {
+	a_updates++;
+	if (a_updates == 3) {
+		splash_state_switch("B", NULL);
+	}
+}
+static void b_init(char *new_state, void *data) {}
+static void b_update(float delta) {
+	assert(!splash_timer_active(timer_a) && "State timer outlived the state");
+	b_updates++;
+	if (b_updates == 1) {
+		timer_b = splash_timer_after(100000, count_timer, NULL);
+	}
+	if (b_updates == 3) {
+		splash_state_stop();
+	}
+}
+static void state_event(SDL_Event e) {}
+static void state_render() {}
+static void state_cleanup(char *new_state) {}
+
+
+static void test_after() {
+	uint32_t start = splash_timer_get_time();
+
+	fired = 0;
+	Splash_timer_handle handle = splash_timer_after(10, count_timer, NULL);
+	assert(handle != SPLASH_TIMER_INVALID_HANDLE && "Failed to create timer");
+	assert(splash_timer_active(handle) && "Timer not active");
+
+	splash_timer_advance(start + 9);
+	assert(fired == 0 && "Timer fired early");
+	splash_timer_advance(start + 10);
+	assert(fired == 1 && fired_at == start + 10 && "Timer fired at the wrong time");
+	assert(!splash_timer_active(handle) && "Timer active after firing");
+	assert(splash_timer_get_count() == 0 && "Timer not freed");
+
+	Splash_timer_handle reused = splash_timer_after(10, count_timer, NULL);
+	assert(reused != handle && "Stale handle reused");
+	assert(splash_timer_cancel(handle) == 0 && "Cancelled a stale handle");
+	assert(splash_timer_cancel(reused) == 1 && "Failed to cancel timer");
+	splash_timer_advance(start + 100);
+	assert(fired == 1 && "Cancelled timer fired");
+}
+
+
+static void test_every() {
+	uint32_t start = splash_timer_get_time();
+
+	fired = 0;
+	Splash_timer_handle handle = splash_timer_every(5, count_timer, NULL);
+	splash_timer_advance(start + 20);
+	assert(fired == 4 && fired_at == start + 20 && "Repeating timer miscounted");
+
+	splash_timer_cancel(handle);
+	splash_timer_advance(start + 40);
+	assert(fired == 4 && "Cancelled repeating timer fired");
+
+	fired = 0;
+	handle = splash_timer_every(5, cancel_timer, NULL);
+	splash_timer_advance(start + 60);
+	assert(fired == 1 && !splash_timer_active(handle) && "Timer failed to cancel itself");
+}
+
+
+static void test_cascade() {
+	uint32_t start = splash_timer_get_time();
+	uint32_t delays[] = {255, 256, 257, 16383, 16384, 1048577, 3000000};
+	int count = sizeof(delays) / sizeof(delays[0]);
+	int i;
+
+	fired = 0;
+	late = 0;
+	for (i = 0; i < count; i++) {
+		splash_timer_after(delays[i], check_timer, (void *)(uintptr_t)(start + delays[i]));
+	}
+	for (i = 0; i < count; i++) {
+		splash_timer_advance(start + delays[i] - 1);
+		assert(fired == i && "Long timer fired early");
+		splash_timer_advance(start + delays[i]);
+		assert(fired == i + 1 && "Long timer fired late");
+	}
+	assert(late == 0 && "Long timer fired at the wrong time");
+}
+
+
+static void test_random() {
+	uint32_t start = splash_timer_get_time();
+	uint32_t end = start;
+	int i;
+
+	srand(42);
+	fired = 0;
+	late = 0;
+	for (i = 0; i < RANDOM_TIMERS; i++) {
+		uint32_t delay = ((uint32_t)rand() * 31 + rand()) % (1 << 20);
+		if (start + delay > end) {
+			end = start + delay;
+		}
+		splash_timer_after(delay, check_timer, (void *)(uintptr_t)(start + (delay ? delay : 1)));
+	}
+	assert(splash_timer_get_count() == RANDOM_TIMERS && "Failed to create timers");
+
+	uint32_t now;
+	for (now = start; now <= end; now += 16) {
+		splash_timer_advance(now);
+	}
+	splash_timer_advance(end);
+	assert(fired == RANDOM_TIMERS && "Timers did not all fire");
+	assert(late == 0 && "Timers fired at the wrong time");
+	assert(splash_timer_get_count() == 0 && "Timers not freed");
+}
+
+
+static void test_state_scope() {
+	splash_state_add(splash_state_create("A", a_init, a_update, state_event, state_render, state_cleanup));
+	splash_state_add(splash_state_create("B", b_init, b_update, state_event, state_render, state_cleanup));
+
+	uint32_t start = splash_timer_get_time();
+	splash_state_start("A", NULL);
+
+	assert(a_updates == 3 && b_updates == 3 && "State machine miscounted");
+	assert(a_ticks > 0 && "State timer never fired");
+	assert(timer_b != SPLASH_TIMER_INVALID_HANDLE && "Failed to create state timer");
+	assert(!splash_timer_active(timer_b) && "State timer outlived the machine");
+	assert(splash_timer_get_count() == 0 && "State timers not cleared");
+	uint32_t elapsed = splash_state_get_clock() - start;
+	uint32_t expected = 6 * 1000 / splash_state_get_ticks();
+	assert(elapsed + 1 >= expected && elapsed <= expected && "Clock does not follow the updates");
+}
+
+
+int main(int argc, char *argv[]) {
+	splash_init();
+
+		test_after();
+		test_every();
+		test_cascade();
+		test_random();
+		test_state_scope();
+
+	splash_quit();
+  return 0;
+}
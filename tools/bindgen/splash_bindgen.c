@@ -0,0 +1,923 @@
+/*-------------------------------------------------------------------------*/
+/**
+   @file    splash_bindgen.c
+   @author  P. Batty
+   @brief   The lua binding generator
+
+   This tool generates the lua bindings of a module from the DLL_EXPORT
+   declarations in its public header.
+
+   usage: splash_bindgen [--ffi] <output> <header.h>...
+
+   Each header Splash_x.h becomes the lua module splash_x, splash_x_do_it
+   is bound as splash_x.doIt and l_splash_x_register is emitted to
+   register it. Every argument is checked once with a luaL_check call or
+   the object check, points and vectors are returned as multiple values
+   rather than tables. When the module has its own Splash_x object type,
+   the functions taking it first become the methods of the splash.x
+   metatable and its destroy function becomes the __gc.
+
+   Declarations with types that can not be passed to lua are skipped with
+   a warning, they need a hand written binding.
+
+   With --ffi a LuaJIT module is written instead. It declares the same
+   functions with ffi.cdef and wraps them with the same names and
+   arguments, so splash_ffi.camera.translate can stand in for
+   splash_camera.translate without going through the C API stack.
+   Objects are still created and destroyed by the C bindings, the
+   wrappers read the pointer out of the userdata after checking its
+   metatable. Objects with a handle are looked up through
+   splash_handle_get like l_splash_object_check, so one destroyed by C
+   raises an error instead of being used.
+
+*/
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+                                Includes
+ ---------------------------------------------------------------------------*/
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*---------------------------------------------------------------------------
+                            Private functions
+ ---------------------------------------------------------------------------*/
+
+#define MAX_NAME      128   /**< longest type or identifier */
+#define MAX_PARAMS    16    /**< most parameters of a function */
+#define MAX_FUNCTIONS 128   /**< most functions of a module */
+
+#define KIND_UNSUPPORTED  0 /**< can not be passed to lua */
+#define KIND_VOID         1 /**< no value */
+#define KIND_INTEGER      2 /**< lua integer */
+#define KIND_FLAG         3 /**< lua boolean */
+#define KIND_NUMBER       4 /**< lua number */
+#define KIND_STRING       5 /**< lua string */
+#define KIND_OBJECT       6 /**< Splash object userdata */
+#define KIND_POINT        7 /**< SDL_Point as x, y */
+#define KIND_VECTOR       8 /**< Splash_vector as 2 to 4 numbers */
+
+
+/*!--------------------------------------------------------------------------
+  @brief    bind_type
+
+  A parsed C type.
+\----------------------------------------------------------------------------*/
+typedef struct bind_type {
+  char c_type[MAX_NAME];    /**< the normalised C type */
+  char object[MAX_NAME];    /**< the object struct name, for objects */
+  int kind;                 /**< how it is passed to lua */
+  int size;                 /**< number of lua values */
+} bind_type;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    bind_param
+
+  A parsed function parameter.
+\----------------------------------------------------------------------------*/
+typedef struct bind_param {
+  bind_type type;           /**< the parameter type */
+  char name[MAX_NAME];      /**< the parameter name */
+} bind_param;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    bind_function
+
+  A parsed DLL_EXPORT declaration.
+\----------------------------------------------------------------------------*/
+typedef struct bind_function {
+  char name[MAX_NAME];              /**< the C function name */
+  char lua_name[MAX_NAME];          /**< the lua function name */
+  bind_type ret;                    /**< the return type */
+  bind_param params[MAX_PARAMS];    /**< the parameters */
+  int param_count;                  /**< number of parameters */
+  int is_method;                    /**< takes the module object first */
+  int is_destroy;                   /**< destroys the module object */
+} bind_function;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    bind_module
+
+  The functions of one header.
+\----------------------------------------------------------------------------*/
+typedef struct bind_module {
+  char name[MAX_NAME];                      /**< the module name, splash_x */
+  char object[MAX_NAME];                    /**< the module object, Splash_x */
+  char meta[MAX_NAME];                      /**< the metatable name, splash.x */
+  char header[MAX_NAME];                    /**< the header file name */
+  bind_function functions[MAX_FUNCTIONS];   /**< the bound functions */
+  int function_count;                       /**< number of bound functions */
+  int has_object;                           /**< functions take the module object */
+  int destroy;                              /**< index of destroy else -1 */
+} bind_module;
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Trims a string
+  @param    text    The string to trim in place
+  @return   The trimmed string
+
+  Removes white space from both ends
+
+\-----------------------------------------------------------------------------*/
+static char *trim(char *text) {
+  while (isspace((unsigned char)*text)) {
+    text++;
+  }
+
+  char *end = text + strlen(text);
+  while (end > text && isspace((unsigned char)end[-1])) {
+    *--end = '\0';
+  }
+ return text;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Copies a string
+  @param    to      The destination, MAX_NAME long
+  @param    from    The source
+  @param    length  The number of characters to copy
+  @return   Void
+
+  Copies and terminates, truncating to MAX_NAME
+
+\-----------------------------------------------------------------------------*/
+static void copy_name(char *to, const char *from, size_t length) {
+  if (length >= MAX_NAME) {
+    length = MAX_NAME - 1;
+  }
+  memcpy(to, from, length);
+  to[length] = '\0';
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Normalises a C type
+  @param    to      The normalised type, MAX_NAME long
+  @param    from    The type as written
+  @return   Void
+
+  Collapses white space so 'const  char*' becomes 'const char *'
+
+\-----------------------------------------------------------------------------*/
+static void normalise(char *to, const char *from) {
+  size_t length = 0;
+  int space = 0;
+
+  for (; *from && length < MAX_NAME - 3; from++) {
+    if (isspace((unsigned char)*from)) {
+      space = 1;
+      continue;
+    }
+    if (*from == '*') {
+      space = 1;
+    }
+    if (space && length) {
+      to[length++] = ' ';
+    }
+    space = (*from == '*');
+    to[length++] = *from;
+  }
+  to[length] = '\0';
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Classifies a C type
+  @param    type    The type to fill
+  @param    c_type  The type as written
+  @return   Void
+
+  Works out how a C type is passed to and from lua
+
+\-----------------------------------------------------------------------------*/
+static void classify(bind_type *type, const char *c_type) {
+  static const char *integers[] = {
+    "int", "int16_t", "int32_t", "uint8_t", "uint16_t", "uint32_t",
+    "Uint8", "Uint16", "Uint32", "Sint16", "Sint32", NULL
+  };
+  int i;
+  size_t length;
+
+  normalise(type->c_type, c_type);
+  type->object[0] = '\0';
+  type->kind = KIND_UNSUPPORTED;
+  type->size = 1;
+  length = strlen(type->c_type);
+
+  if (strcmp(type->c_type, "void") == 0) {
+    type->kind = KIND_VOID;
+    type->size = 0;
+    return;
+  }
+  if (strcmp(type->c_type, "int8_t") == 0) {
+    type->kind = KIND_FLAG;
+    return;
+  }
+  if (strcmp(type->c_type, "float") == 0 || strcmp(type->c_type, "double") == 0) {
+    type->kind = KIND_NUMBER;
+    return;
+  }
+  if (strcmp(type->c_type, "char *") == 0 || strcmp(type->c_type, "const char *") == 0) {
+    type->kind = KIND_STRING;
+    return;
+  }
+  if (strcmp(type->c_type, "SDL_Point") == 0) {
+    type->kind = KIND_POINT;
+    type->size = 2;
+    return;
+  }
+  if (strncmp(type->c_type, "Splash_vector", 13) == 0 && length == 14 && type->c_type[13] >= '2' && type->c_type[13] <= '4') {
+    type->kind = KIND_VECTOR;
+    type->size = type->c_type[13] - '0';
+    return;
+  }
+  if (length > 7 && strcmp(type->c_type + length - 7, "_handle") == 0 && strncmp(type->c_type, "Splash_", 7) == 0) {
+    type->kind = KIND_INTEGER;
+    return;
+  }
+  for (i = 0; integers[i]; i++) {
+    if (strcmp(type->c_type, integers[i]) == 0) {
+      type->kind = KIND_INTEGER;
+      return;
+    }
+  }
+  if (strncmp(type->c_type, "Splash_", 7) == 0 && length > 2 && strcmp(type->c_type + length - 2, " *") == 0 && strchr(type->c_type, ' ') == type->c_type + length - 2) {
+    type->kind = KIND_OBJECT;
+    copy_name(type->object, type->c_type, length - 2);
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the metatable name of an object
+  @param    to      The metatable name, MAX_NAME long
+  @param    object  The object struct name
+  @return   Void
+
+  Splash_window becomes splash.window
+
+\-----------------------------------------------------------------------------*/
+static void meta_name(char *to, const char *object) {
+  size_t i;
+
+  copy_name(to, object, strlen(object));
+  to[0] = tolower((unsigned char)to[0]);
+  for (i = 0; to[i]; i++) {
+    if (to[i] == '_') {
+      to[i] = '.';
+      break;
+    }
+  }
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Gets the lua name of a function
+  @param    to      The lua name, MAX_NAME long
+  @param    from    The function name without the module prefix
+  @return   Void
+
+  set_title becomes setTitle
+
+\-----------------------------------------------------------------------------*/
+static void camel_case(char *to, const char *from) {
+  size_t length = 0;
+  int upper = 0;
+
+  for (; *from && length < MAX_NAME - 1; from++) {
+    if (*from == '_') {
+      upper = 1;
+      continue;
+    }
+    to[length++] = upper ? toupper((unsigned char)*from) : *from;
+    upper = 0;
+  }
+  to[length] = '\0';
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Parses a parameter
+  @param    param   The parameter to fill
+  @param    text    The parameter as written
+  @return   0 on success else -1
+
+  Splits the parameter in to its type and name
+
+\-----------------------------------------------------------------------------*/
+static int parse_param(bind_param *param, char *text) {
+  char *end;
+  char *name;
+  char type[MAX_NAME];
+
+  text = trim(text);
+  if (strchr(text, '(') || strchr(text, '[')) {
+    return -1;
+  }
+
+  end = text + strlen(text);
+  name = end;
+  while (name > text && (isalnum((unsigned char)name[-1]) || name[-1] == '_')) {
+    name--;
+  }
+  if (name == text || name == end) {
+    return -1;
+  }
+
+  copy_name(param->name, name, end - name);
+  copy_name(type, text, name - text);
+  classify(&param->type, type);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Parses a declaration
+  @param    module      The module the function belongs to
+  @param    function    The function to fill
+  @param    text        The declaration after DLL_EXPORT up to the ;
+  @return   1 if the function can be bound else 0
+
+  Parses 'ret SPLASHCALL name(params)', the pointer of the return type can
+  be written on either side of SPLASHCALL.
+
+\-----------------------------------------------------------------------------*/
+static int parse_function(bind_module *module, bind_function *function, char *text) {
+  char ret[MAX_NAME];
+  char *call = strstr(text, "SPLASHCALL");
+  char *open;
+  char *close;
+  char *name;
+  char *param;
+  int depth;
+  int i;
+
+  memset(function, 0, sizeof(bind_function));
+  if (call == NULL || (open = strchr(call, '(')) == NULL || (close = strrchr(open, ')')) == NULL) {
+    return 0;
+  }
+
+  name = call + strlen("SPLASHCALL");
+  copy_name(ret, text, call - text);
+  while (isspace((unsigned char)*name) || *name == '*') {
+    if (*name == '*') {
+      strncat(ret, " *", MAX_NAME - strlen(ret) - 1);
+    }
+    name++;
+  }
+  *open = '\0';
+  copy_name(function->name, name, strlen(trim(name)));
+  classify(&function->ret, ret);
+
+  *close = '\0';
+  param = open + 1;
+  if (*trim(param) != '\0' && strcmp(trim(param), "void") != 0) {
+    for (depth = 0, text = param; ; text++) {
+      if (*text == '(') {
+        depth++;
+      } else if (*text == ')') {
+        depth--;
+      } else if ((*text == ',' && depth == 0) || *text == '\0') {
+        int last = (*text == '\0');
+
+        *text = '\0';
+        if (function->param_count == MAX_PARAMS || parse_param(&function->params[function->param_count], param) == -1) {
+          fprintf(stderr, "splash_bindgen: skipping %s, can not parse its parameters\n", function->name);
+          return 0;
+        }
+        function->param_count++;
+        param = text + 1;
+        if (last) {
+          break;
+        }
+      }
+    }
+  }
+
+  size_t prefix = strlen(module->name);
+  if (strncmp(function->name, module->name, prefix) != 0 || function->name[prefix] != '_') {
+    fprintf(stderr, "splash_bindgen: skipping %s, it is not in %s\n", function->name, module->name);
+    return 0;
+  }
+  camel_case(function->lua_name, function->name + prefix + 1);
+
+  if (function->ret.kind == KIND_UNSUPPORTED) {
+    fprintf(stderr, "splash_bindgen: skipping %s, can not return %s\n", function->name, function->ret.c_type);
+    return 0;
+  }
+  for (i = 0; i < function->param_count; i++) {
+    if (function->params[i].type.kind == KIND_UNSUPPORTED || function->params[i].type.kind == KIND_VOID) {
+      fprintf(stderr, "splash_bindgen: skipping %s, can not pass %s\n", function->name, function->params[i].type.c_type);
+      return 0;
+    }
+  }
+
+  if (function->param_count && strcmp(function->params[0].type.object, module->object) == 0) {
+    function->is_method = 1;
+    module->has_object = 1;
+    size_t length = strlen(function->name);
+    function->is_destroy = function->param_count == 1 && function->ret.kind == KIND_VOID && length > 8 && strcmp(function->name + length - 8, "_destroy") == 0;
+  }
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Parses a header
+  @param    module    The module to fill
+  @param    path      Path to the header
+  @return   0 on success else -1
+
+  Reads every 'extern DLL_EXPORT' declaration in the header
+
+\-----------------------------------------------------------------------------*/
+static int parse_header(bind_module *module, const char *path) {
+  FILE *file = fopen(path, "rb");
+  const char *base;
+  char *text;
+  char *at;
+  long size;
+  size_t i;
+
+  if (file == NULL) {
+    fprintf(stderr, "splash_bindgen: could not open %s\n", path);
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  text = malloc(size + 1);
+  if (text == NULL || fread(text, 1, size, file) != (size_t)size) {
+    fprintf(stderr, "splash_bindgen: could not read %s\n", path);
+    fclose(file);
+    free(text);
+    return -1;
+  }
+  text[size] = '\0';
+  fclose(file);
+
+  base = strrchr(path, '/');
+  if (strrchr(path, '\\') > base) {
+    base = strrchr(path, '\\');
+  }
+  base = base ? base + 1 : path;
+  copy_name(module->header, base, strlen(base));
+  copy_name(module->object, base, strcspn(base, "."));
+  copy_name(module->name, base, strcspn(base, "."));
+  for (i = 0; module->name[i]; i++) {
+    module->name[i] = tolower((unsigned char)module->name[i]);
+  }
+  meta_name(module->meta, module->object);
+  module->function_count = 0;
+  module->has_object = 0;
+  module->destroy = -1;
+
+  for (at = strstr(text, "extern DLL_EXPORT"); at; at = strstr(at, "extern DLL_EXPORT")) {
+    char *end = strchr(at, ';');
+    if (end == NULL) {
+      break;
+    }
+    *end = '\0';
+
+    if (module->function_count == MAX_FUNCTIONS) {
+      fprintf(stderr, "splash_bindgen: too many functions in %s\n", path);
+      free(text);
+      return -1;
+    }
+
+    bind_function *function = &module->functions[module->function_count];
+    if (parse_function(module, function, at + strlen("extern DLL_EXPORT"))) {
+      if (function->is_destroy && module->destroy == -1) {
+        module->destroy = module->function_count;
+      }
+      module->function_count++;
+    }
+    at = end + 1;
+  }
+
+  free(text);
+ return 0;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes a binding
+  @param    out         The output file
+  @param    module      The module of the function
+  @param    function    The function to bind
+  @return   Void
+
+  Writes the lua C function that calls the function
+
+\-----------------------------------------------------------------------------*/
+static void write_function(FILE *out, bind_module *module, bind_function *function) {
+  static const char axes[] = "xyzw";
+  int arg = 1;
+  int i;
+  int j;
+
+  fprintf(out, "static int l_%s(lua_State *l) {\n", function->name);
+
+  for (i = 0; i < function->param_count; i++) {
+    bind_param *param = &function->params[i];
+    bind_type *type = &param->type;
+
+    switch (type->kind) {
+      case KIND_INTEGER:
+        fprintf(out, "  %s %s = (%s)luaL_checkinteger(l, %d);\n", type->c_type, param->name, type->c_type, arg);
+        break;
+      case KIND_FLAG:
+        fprintf(out, "  %s %s = (%s)lua_toboolean(l, %d);\n", type->c_type, param->name, type->c_type, arg);
+        break;
+      case KIND_NUMBER:
+        fprintf(out, "  %s %s = (%s)luaL_checknumber(l, %d);\n", type->c_type, param->name, type->c_type, arg);
+        break;
+      case KIND_STRING:
+        fprintf(out, "  %s%s = %sluaL_checkstring(l, %d);\n", type->c_type, param->name,
+          strncmp(type->c_type, "const ", 6) == 0 ? "" : "(char *)", arg);
+        break;
+      case KIND_OBJECT: {
+        char meta[MAX_NAME];
+        meta_name(meta, type->object);
+        fprintf(out, "  %s%s = l_splash_object_%s(l, %d, \"%s\", \"%s\");\n", type->c_type, param->name,
+          function->is_destroy ? "release" : "check", arg, meta, param->name);
+        break;
+      }
+      case KIND_POINT:
+        fprintf(out, "  SDL_Point %s;\n", param->name);
+        for (j = 0; j < 2; j++) {
+          fprintf(out, "  %s.%c = (int)luaL_checkinteger(l, %d);\n", param->name, axes[j], arg + j);
+        }
+        break;
+      case KIND_VECTOR:
+        fprintf(out, "  %s %s;\n", type->c_type, param->name);
+        for (j = 0; j < type->size; j++) {
+          fprintf(out, "  %s.%c = luaL_checknumber(l, %d);\n", param->name, axes[j], arg + j);
+        }
+        break;
+    }
+    arg += type->size;
+  }
+
+  fprintf(out, function->param_count ? "\n  " : "  ");
+  if (function->ret.kind != KIND_VOID) {
+    const char *ret = function->ret.c_type;
+    fprintf(out, "%s%sresult = ", ret, ret[strlen(ret) - 1] == '*' ? "" : " ");
+  }
+  fprintf(out, "%s(", function->name);
+  for (i = 0; i < function->param_count; i++) {
+    fprintf(out, "%s%s", i ? ", " : "", function->params[i].name);
+  }
+  fprintf(out, ");\n");
+
+  switch (function->ret.kind) {
+    case KIND_INTEGER:
+      fprintf(out, "  lua_pushinteger(l, result);\n");
+      break;
+    case KIND_FLAG:
+      fprintf(out, "  lua_pushboolean(l, result);\n");
+      break;
+    case KIND_NUMBER:
+      fprintf(out, "  lua_pushnumber(l, result);\n");
+      break;
+    case KIND_STRING:
+      fprintf(out, "  lua_pushstring(l, result);\n");
+      break;
+    case KIND_OBJECT: {
+      char meta[MAX_NAME];
+      meta_name(meta, function->ret.object);
+      fprintf(out, "  l_splash_object_push(l, \"%s\", result, %d);\n", meta,
+        strcmp(function->ret.object, module->object) == 0 && strstr(function->name, "create") != NULL);
+      break;
+    }
+    case KIND_POINT:
+    case KIND_VECTOR:
+      for (j = 0; j < function->ret.size; j++) {
+        fprintf(out, "  lua_push%s(l, result.%c);\n", function->ret.kind == KIND_POINT ? "integer" : "number", axes[j]);
+      }
+      break;
+  }
+  fprintf(out, " return %d;\n}\n\n\n", function->ret.size);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes a module
+  @param    out       The output file
+  @param    module    The module to write
+  @return   Void
+
+  Writes the bindings, the __gc and the register function of a module
+
+\-----------------------------------------------------------------------------*/
+static void write_module(FILE *out, bind_module *module) {
+  int i;
+
+  fprintf(out, "/*---------------------------------------------------------------------------\n");
+  fprintf(out, "                                %s\n", module->header);
+  fprintf(out, " ---------------------------------------------------------------------------*/\n\n");
+
+  for (i = 0; i < module->function_count; i++) {
+    write_function(out, module, &module->functions[i]);
+  }
+
+  if (module->has_object) {
+    fprintf(out, "static int l_%s_gc(lua_State *l) {\n", module->name);
+    fprintf(out, "  %s *object = l_splash_object_collect(l);\n\n", module->object);
+    if (module->destroy != -1) {
+      fprintf(out, "  if (object) {\n    %s(object);\n  }\n", module->functions[module->destroy].name);
+    }
+    fprintf(out, " return 0;\n}\n\n\n");
+  }
+
+  fprintf(out, "void l_%s_register(lua_State *l) {\n", module->name);
+  fprintf(out, "  const struct luaL_Reg module[] = {\n");
+  for (i = 0; i < module->function_count; i++) {
+    fprintf(out, "    {\"%s\", l_%s},\n", module->functions[i].lua_name, module->functions[i].name);
+  }
+  fprintf(out, "    {NULL, NULL}\n  };\n");
+
+  if (module->has_object) {
+    fprintf(out, "  const struct luaL_Reg methods[] = {\n");
+    for (i = 0; i < module->function_count; i++) {
+      if (module->functions[i].is_method) {
+        fprintf(out, "    {\"%s\", l_%s},\n", module->functions[i].lua_name, module->functions[i].name);
+      }
+    }
+    fprintf(out, "    {NULL, NULL}\n  };\n");
+    fprintf(out, "  l_splash_object_register(l, \"%s\", methods, l_%s_gc);\n\n", module->meta, module->name);
+  }
+
+  fprintf(out, "  luaL_newlib(l, module);\n");
+  fprintf(out, "  lua_setglobal(l, \"%s\");\n}\n\n\n", module->name);
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Checks if a function can be called through the ffi
+  @param    function    The function
+  @return   1 if it can else 0
+
+  Objects are only handed out by the C bindings so creating and
+  destroying them stays there, struct arguments are not wrapped.
+
+\-----------------------------------------------------------------------------*/
+static int ffi_bindable(bind_function *function) {
+  int i;
+
+  if (function->ret.kind == KIND_OBJECT || function->is_destroy) {
+    return 0;
+  }
+  for (i = 0; i < function->param_count; i++) {
+    if (function->params[i].type.kind == KIND_POINT || function->params[i].type.kind == KIND_VECTOR) {
+      return 0;
+    }
+  }
+ return 1;
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an ffi declaration
+  @param    out         The output file
+  @param    function    The function to declare
+  @return   Void
+
+  Writes the C declaration, strings are passed as const char * so lua
+  strings convert without a copy
+
+\-----------------------------------------------------------------------------*/
+static void write_ffi_declaration(FILE *out, bind_function *function) {
+  const char *ret = function->ret.c_type;
+  int i;
+
+  fprintf(out, "%s%s%s(", ret, ret[strlen(ret) - 1] == '*' ? "" : " ", function->name);
+  for (i = 0; i < function->param_count; i++) {
+    bind_param *param = &function->params[i];
+    const char *type = param->type.c_type;
+
+    if (strcmp(type, "char *") == 0) {
+      type = "const char *";
+    }
+    fprintf(out, "%s%s%s%s", i ? ", " : "", type, type[strlen(type) - 1] == '*' ? "" : " ", param->name);
+  }
+  fprintf(out, "%s);\n", function->param_count ? "" : "void");
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an ffi wrapper
+  @param    out         The output file
+  @param    function    The function to wrap
+  @return   Void
+
+  Writes the lua function that converts the arguments and calls the
+  function through ffi.C
+
+\-----------------------------------------------------------------------------*/
+static void write_ffi_function(FILE *out, bind_function *function) {
+  static const char axes[] = "xyzw";
+  int i;
+  int j;
+
+  fprintf(out, "\n  function m.%s(", function->lua_name);
+  for (i = 0; i < function->param_count; i++) {
+    fprintf(out, "%s%s", i ? ", " : "", function->params[i].name);
+  }
+  fprintf(out, ")\n    ");
+
+  switch (function->ret.kind) {
+    case KIND_VOID:
+      break;
+    case KIND_INTEGER:
+    case KIND_NUMBER:
+      fprintf(out, "return ");
+      break;
+    default:
+      fprintf(out, "local result = ");
+      break;
+  }
+
+  fprintf(out, "_C.%s(", function->name);
+  for (i = 0; i < function->param_count; i++) {
+    bind_param *param = &function->params[i];
+    char meta[MAX_NAME];
+
+    fprintf(out, "%s", i ? ", " : "");
+    switch (param->type.kind) {
+      case KIND_OBJECT:
+        meta_name(meta, param->type.object);
+        fprintf(out, "_object(%s, \"%s\", \"%s\")", param->name, meta, param->name);
+        break;
+      case KIND_FLAG:
+        fprintf(out, "%s and 1 or 0", param->name);
+        break;
+      default:
+        fprintf(out, "%s", param->name);
+        break;
+    }
+  }
+  fprintf(out, ")\n");
+
+  switch (function->ret.kind) {
+    case KIND_FLAG:
+      fprintf(out, "    return result ~= 0\n");
+      break;
+    case KIND_STRING:
+      fprintf(out, "    return result ~= nil and _ffi.string(result) or nil\n");
+      break;
+    case KIND_POINT:
+    case KIND_VECTOR:
+      fprintf(out, "    return ");
+      for (j = 0; j < function->ret.size; j++) {
+        fprintf(out, "%sresult.%c", j ? ", " : "", axes[j]);
+      }
+      fprintf(out, "\n");
+      break;
+  }
+  fprintf(out, "  end\n");
+}
+
+
+/*!--------------------------------------------------------------------------
+  @brief    Writes an ffi module
+  @param    out       The output file
+  @param    module    The module to write
+  @return   Void
+
+  Writes the declarations and wrappers of a module, splash_x becomes the
+  table x of the ffi module
+
+\-----------------------------------------------------------------------------*/
+static void write_ffi_module(FILE *out, bind_module *module) {
+  static char declared[MAX_FUNCTIONS][MAX_NAME];
+  static int declared_count;
+  int i;
+  int j;
+  int k;
+
+  fprintf(out, "-- %s\n_ffi.cdef[[\n", module->header);
+  for (i = 0; i < module->function_count; i++) {
+    bind_function *function = &module->functions[i];
+    if (!ffi_bindable(function)) {
+      continue;
+    }
+
+    for (j = 0; j < function->param_count; j++) {
+      const char *object = function->params[j].type.object;
+      if (function->params[j].type.kind != KIND_OBJECT) {
+        continue;
+      }
+      for (k = 0; k < declared_count && strcmp(declared[k], object) != 0; k++) {
+      }
+      if (k == declared_count && declared_count < MAX_FUNCTIONS) {
+        copy_name(declared[declared_count++], object, strlen(object));
+        fprintf(out, "typedef struct %s %s;\n", object, object);
+      }
+    }
+  }
+  for (i = 0; i < module->function_count; i++) {
+    if (ffi_bindable(&module->functions[i])) {
+      write_ffi_declaration(out, &module->functions[i]);
+    }
+  }
+  fprintf(out, "]]\n\ndo\n  local m = {}\n  M.%s = m\n", module->name + strlen("splash_"));
+
+  for (i = 0; i < module->function_count; i++) {
+    if (ffi_bindable(&module->functions[i])) {
+      write_ffi_function(out, &module->functions[i]);
+    }
+  }
+  fprintf(out, "end\n\n");
+}
+
+
+/*---------------------------------------------------------------------------
+                            Function codes
+ ---------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[]) {
+  static bind_module module;
+  FILE *out;
+  int ffi = argc > 1 && strcmp(argv[1], "--ffi") == 0;
+  int i;
+
+  if (argc < 3 + ffi) {
+    fprintf(stderr, "usage: splash_bindgen [--ffi] <output> <header.h>...\n");
+    return 1;
+  }
+
+  out = fopen(argv[1 + ffi], "wb");
+  if (out == NULL) {
+    fprintf(stderr, "splash_bindgen: could not create %s\n", argv[1 + ffi]);
+    return 1;
+  }
+
+  if (ffi) {
+    fprintf(out, "-- Generated by splash_bindgen from the public headers, do not edit.\n");
+    fprintf(out, "local _ffi = require(\"ffi\")\n");
+    fprintf(out, "local _C = _ffi.C\n");
+    fprintf(out, "local _cast = _ffi.cast\n");
+    fprintf(out, "local _getmetatable = getmetatable\n");
+    fprintf(out, "local M = {}\n\n");
+    fprintf(out, "_ffi.cdef[[\n");
+    fprintf(out, "typedef struct SDL_Point { int x, y; } SDL_Point;\n");
+    fprintf(out, "typedef struct Splash_vector2 { double x, y; } Splash_vector2;\n");
+    fprintf(out, "typedef struct Splash_vector3 { double x, y, z; } Splash_vector3;\n");
+    fprintf(out, "typedef struct Splash_vector4 { double x, y, z, w; } Splash_vector4;\n");
+    fprintf(out, "typedef struct l_splash_object { void *ptr; uint64_t handle; int8_t owned; } l_splash_object;\n");
+    fprintf(out, "void *splash_handle_get(uint64_t handle);\n");
+    fprintf(out, "]]\n\n");
+    fprintf(out, "local function _object(object, type, name)\n");
+    fprintf(out, "  if _getmetatable(object) ~= type then\n");
+    fprintf(out, "    error(\"Invalid argument '\" .. name .. \"' should be a user data of type \" .. type, 3)\n");
+    fprintf(out, "  end\n");
+    fprintf(out, "  local userdata = _cast(\"l_splash_object *\", object)\n");
+    fprintf(out, "  local pointer = userdata.ptr\n");
+    fprintf(out, "  if pointer ~= nil and userdata.handle ~= 0 then\n");
+    fprintf(out, "    pointer = _C.splash_handle_get(userdata.handle)\n");
+    fprintf(out, "    userdata.ptr = pointer\n");
+    fprintf(out, "  end\n");
+    fprintf(out, "  if pointer == nil then\n");
+    fprintf(out, "    error(\"Invalid argument '\" .. name .. \"' has been destroyed\", 3)\n");
+    fprintf(out, "  end\n");
+    fprintf(out, "  return pointer\n");
+    fprintf(out, "end\n\n");
+  } else {
+    fprintf(out, "/* Generated by splash_bindgen from the public headers, do not edit. */\n\n");
+    fprintf(out, "#include \"splash/Splash.h\"\n");
+    fprintf(out, "#include \"lua/lua.h\"\n");
+    fprintf(out, "#include \"lua/lauxlib.h\"\n");
+    fprintf(out, "#include \"lua_wrapper/l_splash_object.h\"\n");
+    fprintf(out, "#include \"lua_wrapper/lua_wrappers.h\"\n\n\n");
+  }
+
+  for (i = 2 + ffi; i < argc; i++) {
+    if (parse_header(&module, argv[i]) == -1) {
+      fclose(out);
+      remove(argv[1 + ffi]);
+      return 1;
+    }
+    if (ffi) {
+      write_ffi_module(out, &module);
+    } else {
+      write_module(out, &module);
+    }
+  }
+
+  if (ffi) {
+    fprintf(out, "return M\n");
+  }
+  fclose(out);
+  return 0;
+}